@@ -0,0 +1,156 @@
+// ------------------------------ includes ------------------------------
+
+#include <string.h>
+#include "ai.h"
+
+/**
+ * @file ai.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief this is the implementation file for the computer player.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * this is the implementation file for the hunt and target probability density player.
+ * Input  : a game
+ * Process: implementation for the functions in ai.h
+ * Output : none
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * how much more a placement counts for every hit (of a ship that is not sunk yet) it goes through.
+ * it is larger than the number of placements that can cover a cell, so any placement through a
+ * hit beats all the placements that don't go through one.
+ */
+const int TARGET_WEIGHT = 1 << 12;
+
+/**
+ * @brief the board as bit masks of its lines. bit i of line j is the cell number i in the line.
+ * @free the cells a ship can stand on (not a miss and not a hit of a sunk ship)
+ * @openHits the hits of ships that are not sunk yet
+ */
+typedef struct LineMasks
+{
+    uint32_t free[BITBOARD_MAX_SIDE];
+    uint32_t openHits[BITBOARD_MAX_SIDE];
+} LineMasks;
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function builds the line masks of the board, both by rows and by columns.
+ * @param game : the game
+ * @param rows : will be set to the masks of the rows
+ * @param columns : will be set to the masks of the columns
+ */
+void buildLineMasks(const Game *game, LineMasks *rows, LineMasks *columns)
+{
+    const GameBoard *gameBoard = &game->gameBoard;
+    int size = gameBoard->size;
+    int row, col;
+    memset(rows, 0, sizeof(LineMasks));
+    memset(columns, 0, sizeof(LineMasks));
+    const Cell *cell = gameBoard->board;
+    for (row = 0 ; row < size ; ++row)
+    {
+        for (col = 0 ; col < size ; ++col, ++cell)
+        {
+            int status = CELL_STATUS(*cell);
+            int isFree = (status == STATUS_UNREACHED);
+            int isOpenHit = 0;
+            if (status == STATUS_HIT)
+            { // a hit is resolved once its ship was sunk
+                isOpenHit = (game->ships.isSunk[CELL_SHIP(*cell)] == FALSE);
+                isFree = isOpenHit;
+            }
+            rows->free[row] |= (uint32_t) isFree << col;
+            rows->openHits[row] |= (uint32_t) isOpenHit << col;
+            columns->free[col] |= (uint32_t) isFree << row;
+            columns->openHits[col] |= (uint32_t) isOpenHit << row;
+        }
+    }
+}
+
+/**
+ * this function adds the placements of a ship along the lines to the density. all the lines are
+ * handled together for every start position, so the loops over the lines are plain array loops.
+ * @param lines : the masks of the lines
+ * @param size : the size of the board
+ * @param length : the length of the ship
+ * @param density : the density to add to, indexed by [position in the line][line]
+ */
+void addPlacements(const LineMasks *lines, const int size, const int length,
+                   int density[BITBOARD_MAX_SIDE][BITBOARD_MAX_SIDE])
+{
+    uint32_t shipMask = ((uint32_t) 1 << length) - 1;
+    int weights[BITBOARD_MAX_SIDE];
+    int start, line, i;
+    for (start = 0 ; start + length <= size ; ++start)
+    {
+        for (line = 0 ; line < size ; ++line)
+        { // the weight of the placement that starts here, 0 if it doesn't fit
+            int fits = (((lines->free[line] >> start) & shipMask) == shipMask);
+            int hits = __builtin_popcount((lines->openHits[line] >> start) & shipMask);
+            weights[line] = fits * (1 + TARGET_WEIGHT * hits);
+        }
+        for (i = start ; i < start + length ; ++i)
+        {
+            for (line = 0 ; line < size ; ++line)
+            {
+                density[i][line] += weights[line];
+            }
+        }
+    }
+}
+
+/**
+ * this function chooses the next shot for a game.
+ * @param game : the game (only what a player can know is used- the shots, their results and
+ * which ships were sunk)
+ * @param row : will be set to the row of the shot
+ * @param column : will be set to the column of the shot
+ * @return TRUE if a shot was chosen, FALSE if there is no cell left to shoot at
+ */
+int chooseShot(const Game *game, int *row, int *column)
+{
+    LineMasks rows, columns;
+    // byRows[col][row] counts the ships along the rows, byColumns[row][col] along the columns
+    int byRows[BITBOARD_MAX_SIDE][BITBOARD_MAX_SIDE];
+    int byColumns[BITBOARD_MAX_SIDE][BITBOARD_MAX_SIDE];
+    int size = game->gameBoard.size;
+    int i, r, c;
+    buildLineMasks(game, &rows, &columns);
+    memset(byRows, 0, sizeof(byRows));
+    memset(byColumns, 0, sizeof(byColumns));
+    for (i = 0 ; i < game->ships.numOfShips ; ++i)
+    {
+        if (game->ships.isSunk[i] == FALSE)
+        { // only the floating ships
+            addPlacements(&rows, size, game->ships.length[i], byRows);
+            addPlacements(&columns, size, game->ships.length[i], byColumns);
+        }
+    }
+    int best = -1;
+    for (r = 0 ; r < size ; ++r)
+    {
+        for (c = 0 ; c < size ; ++c)
+        {
+            int score = byRows[c][r] + byColumns[r][c];
+            if (CELL_STATUS(CELL_AT(&game->gameBoard, r, c)) == STATUS_UNREACHED && score > best)
+            {
+                best = score;
+                *row = r;
+                *column = c;
+            }
+        }
+    }
+    return (best >= 0) ? TRUE : FALSE;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file ai.h
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the computer player. it chooses the next shot with a probability density of the ships
+ * that are still floating.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * for every cell that was not shot yet, the ai counts how many placements of every floating ship
+ * cover it and fit what is known- no placement goes through a miss or a hit of a ship that was
+ * already sunk. a placement that goes through hits that are not resolved yet counts much more, so
+ * while there are such hits the ai targets the ship around them, and otherwise it hunts with the
+ * plain density. the shot is the cell with the largest count.
+ * the count is done on bit masks of the lines of the board, one line at a time for all the lines
+ * together (rows for the ships along the rows, columns for the ships along the columns), so the
+ * inner loops run over arrays and the compiler vectorizes them.
+ */
+
+#ifndef EX2_AI_H
+#define EX2_AI_H
+
+#include "battleships.h"
+
+// ------------------------------ function declarations -----------------------------
+
+/**
+ * this function chooses the next shot for a game.
+ * @param game : the game (only what a player can know is used- the shots, their results and
+ * which ships were sunk)
+ * @param row : will be set to the row of the shot
+ * @param column : will be set to the column of the shot
+ * @return TRUE if a shot was chosen, FALSE if there is no cell left to shoot at
+ */
+int chooseShot(const Game *game, int *row, int *column);
+
+#endif //EX2_AI_H
@@ -1,9 +1,12 @@
 // ------------------------------ includes ------------------------------
 
-#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include "battleships.h"
+#include "stats.h"
+#include "placer.h"
+#include "pool.h"
 
 /**
  * @file battleShips.c
@@ -18,8 +21,10 @@
  * none
  *
  * @section DESCRIPTION
- * this is the implementation file for the battleShips game.
- * strategy for the game and logic idea
+ * this is the implementation file for the battleShips game engine.
+ * all the state of a game lives in its Game struct and the engine never reads or writes to the
+ * screen, so any number of games can run side by side (a game must only be used by one thread
+ * at a time).
  * Input  : none
  * Process: implementation for some of the functions in the header file
  * Output : none
@@ -29,102 +34,57 @@
 // -------------------------- const definitions -------------------------
 
 
-
-/**
- * @var string massage
- * @brief informative massage for the case that the input coordinates was already chosen.
- */
-const char *REPEATED_MOVE_MSG = "you already placed that move.\n";
-
-/**
- * @var string massage
- * @brief informative massage for the case that the user didn't hit any ship.
- */
-const char *MISS_MSG = "Miss.\n";
-
-/**
- * @var string massage
- * @brief informative massage for the case that the user hit a ship
- */
-const char *HIT_MSG = "Hit!\n";
-
-/**
- * @var string massage
- * @brief informative massage for the case that the user sunk a ship
- */
-const char *SUNK_MSG = "Hit and Sunk.\n";
-
-
 /**
- * @var string massage
- * @brief informative massage to ask the user for a board size
+ * the directions a ship can be placed in, by its orientation. a ship that goes left or up from
+ * a cell is the same as the ship that goes right or down from its other end, so two are enough.
  */
-const char *ENTER_SIZE_MSG = "enter board size: ";
-
-
-/**
- * an array of directions for the game. right left up and down
- */
-Direction directions[4] = {
-        {0,  1}, // right
-        {0,  -1}, // left
-        {1,  0}, // up
-        {-1, 0} // down
+const Direction directions[NUM_OF_ORIENTATIONS] = {
+        {0, 1}, // along the row
+        {1, 0} // along the column
 };
 
 /**
- * @brief an array of the game ships:
+ * @brief the standard fleet. a game gets it unless it was given another fleet:
  * aircraft carrier in length 5
  * patrol in length 4
  * Missile ship in length 3
  * submarine in length 3
  * destroyer in length 2
  */
-Ship gameShips[5] = {
-        {5, 0},
-        {4, 0},
-        {3, 0},
-        {3, 0},
-        {2, 0},
+const Fleet standardFleet = {
+        NUM_OF_SHIPS,
+        {
+                {5},
+                {4},
+                {3},
+                {3},
+                {2}
+        }
 };
 
 /**
  * the upper and lower bounds for the game board.
  */
 const int MIN_SIZE = 5;
-const int MAX_SIZE = 26;
+const int MAX_SIZE = BITBOARD_MAX_SIDE;
 
 /**
- * the lowest index possible for the game board. maximal is simply the board size - 1.
- * maximal cant be constant cause its unknown at compile time
+ * the number of times we try to place the whole fleet from scratch before we give up. a ship can
+ * only be blocked by the ships placed before it, so a failed attempt doesn't mean that the fleet
+ * can never fit the board.
  */
-const int MIN_INDEX = 0;
+const int FLEET_PLACEMENT_ATTEMPTS = 100;
 
 /**
- * @brief constants for the Cell status. possible stages are- miss, hit, unreached.
+ * the lowest index possible for the game board. maximal is simply the board size - 1.
+ * maximal cant be constant cause its unknown at compile time
  */
-
-const char HIT = 'x';
-const char MISS = 'o';
-const char INIT_CELL = '_';
+const int MIN_INDEX = 0;
 
 
 
 // ------------------------------ functions -----------------------------
 
-/**
- * @brief this function cleans the input field after we got the user input
- */
-void flush(void)
-{
-    char junk;
-    do
-    {
-        junk = (char) getchar();
-    } while (junk != '\n');
-}
-
-
 /**
  * this function checks the validity of the input size of the table. if its not valid it will
  * return FALSE (1), else TRUE (0).
@@ -140,6 +100,31 @@ int isValidSize(const int sizeOfBoard)
     return TRUE;
 }
 
+/**
+ * this function checks the validity of a fleet for a board: 1 to MAX_FLEET_SHIPS ships, each one
+ * with a length from 1 to the size of the board (and up to MAX_SHIP_LENGTH).
+ * @param fleet : the fleet
+ * @param sizeOfBoard : the size of the board
+ * @return TRUE if the fleet is valid, FALSE otherwise
+ */
+int isValidFleet(const Fleet *fleet, const int sizeOfBoard)
+{
+    int i;
+    if (fleet->numOfShips < 1 || fleet->numOfShips > MAX_FLEET_SHIPS)
+    {
+        return FALSE;
+    }
+    for (i = 0 ; i < fleet->numOfShips ; ++i)
+    {
+        int length = fleet->ships[i].length;
+        if (length < 1 || length > sizeOfBoard || length > MAX_SHIP_LENGTH)
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
 /**
  * this function checks if a given coordinate is legal according to the size of the board.
  * @param row : the row index
@@ -157,52 +142,218 @@ int isIndexInBoard(const int row, const int col, const int sizeOfBoard)
 }
 
 /**
- * this function receives a coordinate and checks its matched Cell in the board is free to set a
- * ship in.
-  * @param row : the row index
- * @param col : the column index
+ * FIND_PLACEMENT_KERNEL defines a function that finds all the legal placements of a ship on the
+ * board (inside the board and with no collision with the ships already placed) and picks one of
+ * them uniformly with the rng of the game:
+ * int name(int *row, int *column, int *orientation, int sizeOfShip, Game *game)
+ * it sets the first cell and the orientation (index to directions) of the placement, and returns
+ * TRUE if a placement was found, FALSE if the ship has no legal placement on the board.
+ * the legal placements are found from the runs of free cells along every row and column, so it
+ * takes a single pass on the board and never retries.
+ * SIZE is the expression of the size of the board. a kernel with a constant SIZE has all its loop
+ * bounds and index steps known at compile time, so the compiler unrolls and simplifies them.
+ */
+#define FIND_PLACEMENT_KERNEL(name, SIZE) \
+int name(int *row, int *column, int *orientation, const int sizeOfShip, Game *game) \
+{ \
+    /* every placement is kept as (cell number * NUM_OF_ORIENTATIONS + orientation) */ \
+    int placements[NUM_OF_ORIENTATIONS * BITBOARD_MAX_SIDE * BITBOARD_MAX_SIDE]; \
+    int freeRun[BITBOARD_MAX_SIDE + 1]; \
+    int numOfPlacements = 0; \
+    const int size = (SIZE); \
+    const BitBoard *occupied = &game->gameBoard.occupied; \
+    int direction, line, i; \
+    for (direction = 0 ; direction < NUM_OF_ORIENTATIONS ; ++direction) \
+    { \
+        int cellStep = (direction == 0) ? 1 : size; /* along the row or along the column */ \
+        int lineStep = (direction == 0) ? size : 1; /* the distance between following lines */ \
+        for (line = 0 ; line < size ; ++line) \
+        { /* count the free cells from every cell to the end of the line, backwards */ \
+            freeRun[size] = 0; \
+            for (i = size - 1 ; i >= 0 ; --i) \
+            { \
+                int index = line * lineStep + i * cellStep; \
+                freeRun[i] = bitBoardTest(occupied, index) ? 0 : freeRun[i + 1] + 1; \
+                if (freeRun[i] >= sizeOfShip) \
+                { \
+                    placements[numOfPlacements++] = index * NUM_OF_ORIENTATIONS + direction; \
+                } \
+            } \
+        } \
+    } \
+    STAT_ADD(COUNTER_CANDIDATES, numOfPlacements); \
+    if (numOfPlacements == 0) \
+    { /* the ship can't fit anywhere */ \
+        return FALSE; \
+    } \
+    int chosen = placements[rngBounded(&game->rng, (uint32_t) numOfPlacements)]; \
+    *row = (chosen / NUM_OF_ORIENTATIONS) / size; \
+    *column = (chosen / NUM_OF_ORIENTATIONS) % size; \
+    *orientation = chosen % NUM_OF_ORIENTATIONS; \
+    return TRUE; \
+}
+
+/**
+ * PLACE_FLEET_KERNEL defines a function that places all the ships of the registry of the game in
+ * rand locations with the placement kernel FIND:
+ * int name(Game *game)
+ * every ship is placed in one pass, and if a ship has no room left the whole fleet is placed
+ * again, up to FLEET_PLACEMENT_ATTEMPTS times. it returns TRUE if the fleet was placed and
+ * NO_PLACEMENT if it couldn't fit the board.
+ * NUM_SHIPS is the expression of the number of ships, a constant for a fixed fleet.
+ */
+#define PLACE_FLEET_KERNEL(name, FIND, NUM_SHIPS) \
+int name(Game *game) \
+{ \
+    int attempt, i, row, col, orientation; \
+    for (attempt = 0 ; attempt < FLEET_PLACEMENT_ATTEMPTS ; ++attempt) \
+    { \
+        STAT_ADD(COUNTER_FLEET_ATTEMPTS, 1); \
+        initBoard(&game->gameBoard); \
+        for (i = 0 ; i < (NUM_SHIPS) ; ++i) \
+        { \
+            if (FIND(&row, &col, &orientation, game->ships.length[i], game) == FALSE) \
+            { \
+                STAT_ADD(COUNTER_DEAD_ENDS, 1); \
+                break; \
+            } \
+            placeShipAt(i, row, col, orientation, game); \
+        } \
+        if (i == (NUM_SHIPS)) \
+        { /* all the ships are on the board */ \
+            return TRUE; \
+        } \
+    } \
+    return NO_PLACEMENT; \
+}
+
+/**
+ * this function checks for collisions with other ships in the board. if is returns TRUE it means
+ * the location and direction are valid and free from any collision. otherwise it will return FALSE
+ * @param row : the start index for the row coordinate for the ship to stand
+ * @param col : the start index for the column coordinate for the ship to stand
+ * @param direction : the chosen direction of the ship we want to check
+ * @param sizeOfShip : the size of the ship we want to locate on the board
  * @param gameBoard : the board of the game
- * @return TRUE for the case that the coordinate is free. otherwise FALSE.
+ * @return TRUE for the case that there are no collisions and FALSE otherwise.
  */
-int isCellFree(const int row, const int column, GameBoard *gameBoard)
+int checkCollision(const int row, const int col, const Direction direction, const int sizeOfShip,
+                   const GameBoard *gameBoard)
 {
-    if (gameBoard->board[row][column].content == NULL)
+    BitBoard shipMask;
+    int step = direction.addToRow * gameBoard->size + direction.addToColumn;
+    bitBoardSegment(&shipMask, row * gameBoard->size + col, step, sizeOfShip);
+    if (bitBoardOverlap(&shipMask, &gameBoard->occupied) != 0)
     {
-        return TRUE;
+        return FALSE;
     }
-    return FALSE;
+    return TRUE;
 }
 
 /**
- * this function checks if the Cell in the given coordinate is valid in the way that the ship we
- * want to init in it can start from this coordinate and be placed in any of the directions
- * possible in the game. if its not possible to place it in any of the directions we return FALSE.
- * otherwise it means the coordinate is a possible start point for that ship (just in terms of
- * board limits)
- * @param row : the row index
- * @param col : the column index
- * @param sizeOfShip : the size of the ship we want to place
- * @param gameBoard : the game board
- * @return TRUE for the case that the coordinate is valid. otherwise FALSE.
+ * this function places a single ship on the board, in a free location.
+ * @param shipIndex : the index of the ship we want to place in the registry of the game
+ * @param row : the row of the first cell of the ship
+ * @param col : the column of the first cell of the ship
+ * @param orientation : the orientation of the ship (index to directions)
+ * @param game : the game
+ */
+void placeShipAt(const int shipIndex, int row, int col, const int orientation, Game *game)
+{
+    GameBoard *gameBoard = &game->gameBoard;
+    int length = game->ships.length[shipIndex];
+    Direction direction = directions[orientation];
+    assert(checkCollision(row, col, direction, length, gameBoard) == TRUE);
+    registerShip(&game->ships, shipIndex, row, col, orientation);
+
+    BitBoard shipMask;
+    int step = direction.addToRow * gameBoard->size + direction.addToColumn;
+    bitBoardSegment(&shipMask, row * gameBoard->size + col, step, length);
+    bitBoardOr(&gameBoard->occupied, &shipMask);
+    int i;
+    for (i = 0 ; i < length ; ++i)
+    { // now place the ship. the cell keeps the index plus one so zero stays "empty"
+        CELL_AT(gameBoard, row, col) = (Cell) (STATUS_UNREACHED | (shipIndex + 1));
+        row += direction.addToRow;
+        col += direction.addToColumn;
+    }
+}
+
+/**
+ * this function init the game board for default values (every cell is unreached and empty, which
+ * is the zero byte) with no ships on it.
+ * @param gameBoard : the board of the game
  */
-int isCellValid(const int row, const int col, const int sizeOfShip, GameBoard *gameBoard)
+void initBoard(GameBoard *gameBoard)
 {
-    int i, rowFinish, colFinish;
-    for (i = 0 ; i < sizeof(directions) / sizeof(Direction) ; ++i)
-    { // go throw all the directions and check each one
-        rowFinish = row + directions[i].addToRow * (sizeOfShip - 1);
-        colFinish = col + directions[i].addToColumn * (sizeOfShip - 1);
-        if (isIndexInBoard(rowFinish, colFinish, gameBoard->size) == TRUE)
-        { // we fount a valid direction so the coordinate is ok
-            return TRUE;
+    memset(gameBoard->board, 0, (size_t) gameBoard->size * gameBoard->size * sizeof(Cell));
+    bitBoardClear(&gameBoard->occupied);
+    bitBoardClear(&gameBoard->hits);
+    bitBoardClear(&gameBoard->misses);
+}
+
+/**
+ * this function gives all the shots of a board to a visitor, from the bitboards of the misses and
+ * the hits (the cost is the number of shots, not the size of the board).
+ * @param gameBoard : the board
+ * @param visit : the visitor
+ * @param context : the context of the visitor
+ */
+void forEachShot(const GameBoard *gameBoard, const ShotVisitor visit, void *context)
+{
+    int size = gameBoard->size;
+    int i;
+    for (i = 0 ; i < BITBOARD_WORDS ; ++i)
+    {
+        uint64_t misses = gameBoard->misses.words[i];
+        uint64_t hits = gameBoard->hits.words[i];
+        uint64_t shots = misses | hits;
+        while (shots != 0)
+        {
+            int bit = __builtin_ctzll(shots);
+            int cell = i * BITBOARD_WORD_BITS + bit;
+            int status = ((hits >> bit) & 1) ? STATUS_HIT : STATUS_MISS;
+            visit(context, cell / size, cell % size, status);
+            shots &= shots - 1;
         }
     }
-    return FALSE;
 }
 
 /**
- * this function uses the rand function to find a start coordinate and a valid direction for
- * the ship size. it tries until a full success
+ * the kernels: the generic ones for any board and fleet, and the ones of the standard fleet on the
+ * common board sizes.
+ */
+FIND_PLACEMENT_KERNEL(findPlacement, game->gameBoard.size)
+FIND_PLACEMENT_KERNEL(findPlacement8, 8)
+FIND_PLACEMENT_KERNEL(findPlacement10, 10)
+
+PLACE_FLEET_KERNEL(placeFleet, findPlacement, game->ships.numOfShips)
+PLACE_FLEET_KERNEL(placeStandardFleet8, findPlacement8, NUM_OF_SHIPS)
+PLACE_FLEET_KERNEL(placeStandardFleet10, findPlacement10, NUM_OF_SHIPS)
+
+/**
+ * @brief a fleet kernel of the standard fleet.
+ * @size the size of the board of the kernel
+ * @place the kernel
+ */
+typedef struct FleetKernel
+{
+    int size;
+    int (*place)(Game *game);
+} FleetKernel;
+
+/**
+ * the fleet kernels of the standard fleet, by the size of the board.
+ */
+const FleetKernel STANDARD_FLEET_KERNELS[] = {
+        {8, placeStandardFleet8},
+        {10, placeStandardFleet10}
+};
+
+/**
+ * this function finds all the legal placements of a ship on the board (inside the board and with
+ * no collision with the ships already placed) and picks one of them uniformly with the rng of
+ * the game (see FIND_PLACEMENT_KERNEL).
  * @param row : a pointer for the row index. the final row index will be writen to the value of
  * the pointer.
  * @param col : a pointer for the column index. the final col index will be writen to the value of
@@ -210,238 +361,395 @@ int isCellValid(const int row, const int col, const int sizeOfShip, GameBoard *g
  * @param direction : the pointer for the direction. the final direction chosen will set in that
  * pointer value.
  * @param sizeOfShip : the size of the ship we want to locate
- * @param gameBoard : the game board
+ * @param game : the game
+ * @return TRUE if a location was found, FALSE if the ship has no legal placement on the board
  */
-void getRandLocation(int *row, int *column, Direction *direction, const int sizeOfShip,
-                     GameBoard *gameBoard)
+int getRandLocation(int *row, int *column, Direction *direction, const int sizeOfShip,
+                    Game *game)
 {
-    int rowStart, colStart;
-    do
-    { // get the start location for the ship randomly
-        rowStart = rand() % gameBoard->size;
-        colStart = rand() % gameBoard->size;
-    } while (isCellFree(rowStart, colStart, gameBoard) == FALSE ||
-             isCellValid(rowStart, colStart, sizeOfShip, gameBoard) == FALSE);
-
-    int rowFinish, colFinish;
-    Direction curDirection;
-    do
-    { // get the direction for the ship to stand randomly
-        curDirection = directions[rand() % 4]; // get a random direction
-        rowFinish = rowStart + curDirection.addToRow * (sizeOfShip - 1);
-        colFinish = colStart + curDirection.addToColumn * (sizeOfShip - 1);
-    } while (isIndexInBoard(rowFinish, colFinish, gameBoard->size) == FALSE);
-    // set the final values
-    *row = rowStart;
-    *column = colStart;
-    *direction = curDirection;
+    int orientation;
+    if (findPlacement(row, column, &orientation, sizeOfShip, game) == FALSE)
+    {
+        return FALSE;
+    }
+    *direction = directions[orientation];
+    return TRUE;
 }
 
 /**
- * this function checks for collisions with other ships in the board. if is returns TRUE it means
- * the location and direction are valid and free from any collision. otherwise it will return FALSE
- * @param row : the start index for the row coordinate for the ship to stand
- * @param col : the start index for the column coordinate for the ship to stand
- * @param direction : the chosen direction of the ship we want to check
- * @param sizeOfShip : the size of the ship we want to locate on the board
- * @param gameBoard : the board of the game
- * @return TRUE for the case that there are no collisions and FALSE otherwise.
+ * this function checks if the ships of the registry of a game are the standard fleet.
+ * @param game : the game
+ * @return TRUE for the standard fleet, FALSE otherwise
  */
-int checkCollision(int row, int col, const Direction direction, const int sizeOfShip,
-                   GameBoard *gameBoard)
+int isStandardFleet(const Game *game)
 {
     int i;
-    for (i = 0 ; i < sizeOfShip ; ++i)
+    if (game->ships.numOfShips != NUM_OF_SHIPS)
+    {
+        return FALSE;
+    }
+    for (i = 0 ; i < NUM_OF_SHIPS ; ++i)
     {
-        if (isCellFree(row, col, gameBoard) == FALSE)
+        if (game->ships.length[i] != standardFleet.ships[i].length)
         {
             return FALSE;
         }
-        row += direction.addToRow;
-        col += direction.addToColumn;
     }
     return TRUE;
 }
 
 /**
- * this function places a single ship in a rand location on the board
- * @param ship : the pointer for the ship we want to place
- * @param gameBoard : the game board
+ * this function places all the ships in the game board in rand locations. the standard fleet on a
+ * common board size is placed by its own kernel, anything else by the generic one. a fleet the
+ * kernel can't place (a dense board) is placed by the backtracking search (see placer.h).
+ * @param game : a pointer to the game
+ * @return TRUE if the fleet was placed, NO_PLACEMENT if it couldn't fit the board,
+ * PLACEMENT_TIMEOUT if the search gave up before it found a layout, FALSE if out of memory
  */
-void placeSingleShip(Ship *ship, GameBoard *gameBoard)
+int placeShips(Game *game)
 {
-    int row, col, i;
-    Direction direction;
-    do
+    int (*place)(Game *game) = placeFleet;
+    int i;
+    if (isStandardFleet(game) == TRUE)
     {
-        // find a location and direction
-        getRandLocation(&row, &col, &direction, ship->length, gameBoard);
-        // check if the place is free
-    } while (checkCollision(row, col, direction, ship->length, gameBoard) == FALSE);
-
-    for (i = 0 ; i < ship->length ; ++i)
-    { // now place the ship
-        gameBoard->board[row][col].content = ship;
-        row += direction.addToRow;
-        col += direction.addToColumn;
+        for (i = 0 ; i < (int) (sizeof(STANDARD_FLEET_KERNELS) / sizeof(FleetKernel)) ; ++i)
+        {
+            if (STANDARD_FLEET_KERNELS[i].size == game->gameBoard.size)
+            {
+                place = STANDARD_FLEET_KERNELS[i].place;
+            }
+        }
+    }
+    STAT_TIMER_START(start);
+    int placeFlag = place(game);
+    if (placeFlag == NO_PLACEMENT)
+    { // every pass of the kernel got stuck, search for a layout
+        placeFlag = solveFleetPlacement(game);
     }
+    STAT_TIMER_STOP(TIMER_PLACEMENT, start);
+    STAT_ADD(COUNTER_FLEETS, 1);
+    return placeFlag;
 }
 
 /**
- * this function places all the ships in the game board in rand locations
- * @param gameBoard : a pointer to the game board
+ * this function gives the size of the cells of a board in its block, rounded up to 8 bytes so
+ * the ship registry after them is aligned.
+ * @param size : the size of the board
+ * @return the number of bytes of the cells
  */
-void placeShips(GameBoard *gameBoard)
+size_t boardCellBytes(const int size)
 {
+    return ((size_t) size * size * sizeof(Cell) + 7) & ~(size_t) 7;
+}
+
+/**
+ * this function builds the game board according to the given size. locates the ships and sets it
+ * for a new game. the whole board is a single block: the size * size cells (rounded up to 8
+ * bytes) and then the arrays of the ship registry. the block is taken from the board pool of the
+ * thread (see pool.h), so a thread that plays game after game allocates no memory for it.
+ * (uses malloc! the free function is separated, please pay attention)
+ * @param game : a pointer to the game whose board the function is going to build
+ * @param fleet : the fleet to place on the board
+ * @return FALSE in case the malloc can't allocate memory for the board, NO_PLACEMENT in case the
+ * fleet can't be placed on the board, PLACEMENT_TIMEOUT in case the search for a layout gave up
+ * (nothing is left allocated in all of them), TRUE otherwise
+ */
+int buildGameBoard(Game *game, const Fleet *fleet)
+{
+    GameBoard *gameBoard = &game->gameBoard;
+    size_t cellBytes = boardCellBytes(gameBoard->size);
+    size_t blockBytes = cellBytes + shipRegistryBytes(fleet->numOfShips);
+    gameBoard->board = (Cell *) acquireBoardBlock(blockBytes);
+    if (gameBoard->board == NULL)
+    { // out of memory
+        return FALSE;
+    }
+    initShipRegistry(&game->ships, (char *) gameBoard->board + cellBytes, fleet->numOfShips);
     int i;
-    for (i = 0 ; i < sizeof(gameShips) / sizeof(Ship) ; ++i)
+    for (i = 0 ; i < fleet->numOfShips ; ++i)
+    {
+        game->ships.length[i] = (unsigned char) fleet->ships[i].length;
+    }
+    int placeFlag = placeShips(game);
+    if (placeFlag != TRUE)
     {
-        placeSingleShip(&gameShips[i], gameBoard);
+        freeGameBoard(gameBoard);
     }
+    return placeFlag;
 }
 
 /**
- * this function init the game board for default values (the Cell's status to '_' and the Cell's
- * content to NULL) and places the ships in random locations.
- * @param gameBoard : the board of the game
+ * this function free the memory allocated for the game board (gives it back to the board pool of
+ * the thread).
+ * @param gameBoard : this is the board of the game.
  */
-void initBoard(GameBoard *gameBoard)
+void freeGameBoard(GameBoard *gameBoard)
 {
-    int i, j;
-    for (i = 0 ; i < gameBoard->size ; ++i)
-    {
-        for (j = 0 ; j < gameBoard->size ; ++j)
-        {
-            gameBoard->board[i][j].status = INIT_CELL;
-            gameBoard->board[i][j].content = NULL;
-
-        }
-    }
-    placeShips(gameBoard); // placing the ships on the board.
+    releaseBoardBlock(gameBoard->board);
+    gameBoard->board = NULL;
 }
 
+
 /**
- * this function builds the game board according to the given size. locates the ships and sets it
- * for a new game. (uses malloc! the free function is separated, please pay attention)
- * @param gameBoard : a pointer to the game board that the function is going to build
- * @return FALSE in case the malloc can't allocate memory for the board, TRUE otherwise
+ * this function checks if the ship that just got hit sunk also. we get its coordinates.
+ * @param row : the index of the row
+ * @param col : the index of the col
+ * @param game : the game
+ * @return TRUE if the ship is sunk, FALSE otherwise. returns WIN_GAME if all the ship where sunk
  */
-int buildGameBoard(GameBoard *gameBoard)
+int isSunk(const int row, const int col, Game *game)
 {
-    int i;
-    gameBoard->board = (Cell **) malloc((gameBoard->size) * sizeof(Cell *));
-    if (gameBoard->board == NULL)
-    { // out of memory
+    int shipIndex = CELL_SHIP(CELL_AT(&game->gameBoard, row, col));
+    assert(shipIndex != NO_SHIP);
+    if (game->ships.isSunk[shipIndex] == FALSE)
+    {
         return FALSE;
     }
-    for (i = 0 ; i < gameBoard->size ; i++)
+    if (remainingShips(&game->ships) == 0)
     {
-        gameBoard->board[i] = (Cell *) malloc((gameBoard->size) * sizeof(Cell));
-        if (gameBoard->board[i] == NULL)
-        { // out of memory
-            return FALSE;
-        }
+        return WIN_GAME;
     }
-    initBoard(gameBoard);
     return TRUE;
 }
 
+/**
+ * this function gives the number of bytes of the arrays of a ship registry.
+ * @param numOfShips : the number of ships
+ * @return the number of bytes (a multiple of 8, so a block can continue after it)
+ */
+size_t shipRegistryBytes(const int numOfShips)
+{
+    size_t words = (size_t) numOfShips * (2 * sizeof(int) + sizeof(uint32_t));
+    size_t bytes = (size_t) numOfShips * 3 * sizeof(unsigned char);
+    return (words + bytes + 7) & ~(size_t) 7;
+}
 
 /**
- * this function adds a sunk ship to the counter to know how many ships are left in the game.
- * it checks if all the ship where sunk and if the answer is positive than it returns the value
- * to finish the game
- *@return TRUE for successful adding. WIN_GAME when add the ship sunk
+ * this function points a ship registry to the arrays in a block of shipRegistryBytes(numOfShips)
+ * bytes, and leaves what is in them as it is.
+ * @param ships : the registry
+ * @param block : the block of its arrays
+ * @param numOfShips : the number of ships
  */
-int addSunkShip(void)
+void mapShipRegistry(ShipRegistry *ships, void *block, const int numOfShips)
 {
-    static int sunkShipCounter = 0;
+    ships->numOfShips = numOfShips;
+    ships->numOfSunk = 0;
+    ships->row = (int *) block;
+    ships->column = ships->row + numOfShips;
+    ships->hitMask = (uint32_t *) (ships->column + numOfShips);
+    ships->orientation = (unsigned char *) (ships->hitMask + numOfShips);
+    ships->length = ships->orientation + numOfShips;
+    ships->isSunk = ships->length + numOfShips;
+}
 
-    sunkShipCounter++;
+/**
+ * this function sets a ship registry on a block of shipRegistryBytes(numOfShips) bytes, with no
+ * hits. the lengths and the places of the ships are set by the caller.
+ * @param ships : the registry
+ * @param block : the block of its arrays
+ * @param numOfShips : the number of ships
+ */
+void initShipRegistry(ShipRegistry *ships, void *block, const int numOfShips)
+{
+    mapShipRegistry(ships, block, numOfShips);
+    memset(ships->hitMask, 0, (size_t) numOfShips * sizeof(uint32_t));
+    memset(ships->isSunk, FALSE, (size_t) numOfShips);
+}
 
-    if (sizeof(gameShips) / sizeof(Ship) == sunkShipCounter)
+/**
+ * this function sets the place of a ship in the registry.
+ * @param ships : the registry
+ * @param shipIndex : the index of the ship
+ * @param row : the row of the first cell of the ship
+ * @param column : the column of the first cell of the ship
+ * @param orientation : the orientation of the ship (index to directions)
+ */
+void registerShip(ShipRegistry *ships, const int shipIndex, const int row, const int column,
+                  const int orientation)
+{
+    ships->row[shipIndex] = row;
+    ships->column[shipIndex] = column;
+    ships->orientation[shipIndex] = (unsigned char) orientation;
+}
+
+/**
+ * this function adds a hit to a ship, in O(1).
+ * @param ships : the registry
+ * @param shipIndex : the index of the ship
+ * @param row : the row of the hit (a cell of the ship)
+ * @param column : the column of the hit
+ * @return TRUE if the hit sunk the ship, FALSE otherwise
+ */
+int hitShip(ShipRegistry *ships, const int shipIndex, const int row, const int column)
+{
+    // one of the two differences is zero, the other is the place of the cell in the ship
+    int cellInShip = (row - ships->row[shipIndex]) + (column - ships->column[shipIndex]);
+    uint32_t allCells = (uint32_t) (((uint64_t) 1 << ships->length[shipIndex]) - 1);
+    ships->hitMask[shipIndex] |= (uint32_t) 1 << cellInShip;
+    if (ships->isSunk[shipIndex] == TRUE || ships->hitMask[shipIndex] != allCells)
     {
-        return WIN_GAME;
+        return FALSE;
     }
+    ships->isSunk[shipIndex] = TRUE;
+    ships->numOfSunk++;
     return TRUE;
 }
 
-
 /**
- * this function checks if the ship that just got hit sunk also. we get its coordinates.
- * @param row : the index of the row
- * @param col : the index of the col
- * @param gameBoard : the board of the game
- * @return TRUE if the ship is sunk, FALSE otherwise. returns WIN_GAME if all the ship where sunk
+ * this function gives the number of ships that were not sunk yet.
+ * @param ships : the registry
+ * @return the number of ships left
  */
-int isSunk(const int row, const int col, GameBoard *gameBoard)
+int remainingShips(const ShipRegistry *ships)
 {
-    Ship *shipGotHit = gameBoard->board[row][col].content;
-    assert(shipGotHit != NULL);
-    if (shipGotHit->numOfHits == shipGotHit->length)
-    {
-        return addSunkShip(); // WIN_GAME or TRUE
-    }
-    return FALSE;
+    return ships->numOfShips - ships->numOfSunk;
 }
 
 /**
- *this function places the move that the user inserted. it prints to the screen the matched
- * massage according to the move that was made (already made, miss, hit, hit and sunk)
+ * this function applies a move to the board of the game (see placeMove).
  * @param row : the index of the row for the move
  * @param column : the index of the column for the move
- * @param gameBoard : the board of the game
- * @return TRUE for successful move and WIN_GAME in case that the move finished the game
+ * @param game : the game
+ * @return the result of the move (already made, miss, hit, hit and sunk or the winning move)
  */
-int placeMove(const int row, const int column, GameBoard *gameBoard)
+MoveResult applyMove(const int row, const int column, Game *game)
 {
-    if (gameBoard->board[row][column].status != INIT_CELL)
+    GameBoard *gameBoard = &game->gameBoard;
+    int index = row * gameBoard->size + column;
+    if (bitBoardTest(&gameBoard->hits, index) || bitBoardTest(&gameBoard->misses, index))
     { // the move was already made
-        printf(REPEATED_MOVE_MSG);
-        return TRUE;
+        return MOVE_REPEATED;
     } // its a new move
-    if (gameBoard->board[row][column].content != NULL)
+    game->numOfMoves++;
+    Cell *cell = &gameBoard->board[index];
+    if (bitBoardTest(&gameBoard->occupied, index))
     { // there is a ship part in this cell
-        gameBoard->board[row][column].status = HIT; // in the user moves board
-        gameBoard->board[row][column].content->numOfHits++; // adding a hit to the ship
-        int sunkFlag = isSunk(row, column, gameBoard);
+        *cell |= STATUS_HIT; // in the user moves board
+        bitBoardSet(&gameBoard->hits, index);
+        hitShip(&game->ships, CELL_SHIP(*cell), row, column); // adding a hit to the ship
+        int sunkFlag = isSunk(row, column, game);
         if (sunkFlag == WIN_GAME)
         { // the ship was sunk after the last move and the user won the game
-            return WIN_GAME;
+            game->status = WIN_GAME;
+            return MOVE_WIN;
         }
         if (sunkFlag == TRUE) // sunk but there are ships left in the game
         {
-            printf(SUNK_MSG);
-            return TRUE;
+            return MOVE_SUNK;
         }
-        printf(HIT_MSG); // just a hit no sunk
-        return TRUE;
+        return MOVE_HIT; // just a hit no sunk
     } // the cell is empty
-    gameBoard->board[row][column].status = MISS;
-    printf(MISS_MSG);
-    return TRUE;
+    *cell |= STATUS_MISS;
+    bitBoardSet(&gameBoard->misses, index);
+    return MOVE_MISS;
+}
+
+/**
+ * this function places a move on the board of the game and returns what happened. it writes
+ * nothing to the screen, the caller shows the result.
+ * @param row : the index of the row for the move
+ * @param column : the index of the column for the move
+ * @param game : the game
+ * @return the result of the move (already made, miss, hit, hit and sunk or the winning move)
+ */
+MoveResult placeMove(const int row, const int column, Game *game)
+{
+    STAT_TIMER_START(start);
+    MoveResult result = applyMove(row, column, game);
+    STAT_TIMER_STOP(TIMER_MOVE, start);
+    STAT_ADD(COUNTER_MOVES, 1);
+    return result;
 }
 
 
 /**
- * this function gets the size of the board from the user
- * @param gameBoard : a pointer to the game board
- * @return TRUE if the size is valid and FALSE otherwise
+ * this function starts a new game: seeds the rng of the game and builds the board with the
+ * fleet on it. (uses malloc! free the game with freeGame)
+ * @param game : the game to init
+ * @param size : the size of the board
+ * @param fleet : the fleet of the game, NULL for the standard fleet
+ * @param seed : the seed of the game. the same seed, size and fleet always give the same layout
+ * @return TRUE on success, INVALID_SIZE if the size is not valid, INVALID_FLEET if the fleet is
+ * not valid for the board, FALSE if out of memory, NO_PLACEMENT if the fleet can't be placed
+ * on the board and PLACEMENT_TIMEOUT if the search for a layout gave up (see placer.h)
  */
-int getSizeOfBoard(GameBoard *gameBoard)
+int initGame(Game *game, const int size, const Fleet *fleet, const uint64_t seed)
 {
-    printf(ENTER_SIZE_MSG);
-    int sizeOfBoard;
-    if (scanf("%d", &sizeOfBoard) != 1)
+    if (isValidSize(size) == FALSE)
     {
-        return FALSE;
+        return INVALID_SIZE;
     }
-    flush();
-    if (isValidSize(sizeOfBoard) == FALSE)
+    if (fleet == NULL)
     {
-        return FALSE;
+        fleet = &standardFleet;
     }
-    gameBoard->size = sizeOfBoard;
-    return TRUE;
+    if (isValidFleet(fleet, size) == FALSE)
+    {
+        return INVALID_FLEET;
+    }
+    game->numOfMoves = 0;
+    game->status = TRUE;
+    game->gameBoard.size = size;
+    rngSeed(&game->rng, seed);
+    return buildGameBoard(game, fleet);
+}
+
+/**
+ * this function starts a new game on a game that was already started, with the same size and
+ * fleet and a new seed. it allocates nothing- the board and the registry of the game are reused.
+ * @param game : the game (started with initGame)
+ * @param seed : the seed of the new game. the layout is the one initGame gives for the seed
+ * @return TRUE on success, NO_PLACEMENT if the fleet can't be placed on the board,
+ * PLACEMENT_TIMEOUT if the search for a layout gave up and FALSE if out of memory (the game has
+ * no layout then, restart it again or free it)
+ */
+int restartGame(Game *game, const uint64_t seed)
+{
+    game->numOfMoves = 0;
+    game->status = TRUE;
+    rngSeed(&game->rng, seed);
+    initShipRegistry(&game->ships, game->ships.row, game->ships.numOfShips);
+    return placeShips(game);
+}
+
+/**
+ * this function plays a single move in the game.
+ * @param game : the game
+ * @param row : the index of the row for the move
+ * @param column : the index of the column for the move
+ * @return the result of the move. MOVE_INVALID for a coordinate out of the board or a move on a
+ * game that is already won
+ */
+MoveResult stepGame(Game *game, const int row, const int column)
+{
+    if (game->status == WIN_GAME || isIndexInBoard(row, column, game->gameBoard.size) == FALSE)
+    {
+        return MOVE_INVALID;
+    }
+    return placeMove(row, column, game);
+}
+
+/**
+ * this function gives the state of the game so far.
+ * @param game : the game
+ * @return the result of the game
+ */
+GameResult gameResult(const Game *game)
+{
+    GameResult result;
+    result.status = game->status;
+    result.numOfMoves = game->numOfMoves;
+    result.numOfHits = bitBoardCount(&game->gameBoard.hits);
+    result.sunkShips = game->ships.numOfSunk;
+    return result;
 }
 
+/**
+ * this function frees the memory of the game.
+ * @param game : the game
+ */
+void freeGame(Game *game)
+{
+    freeGameBoard(&game->gameBoard);
+}
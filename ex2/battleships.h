@@ -28,6 +28,9 @@
 #ifndef EX2_BATTLESHIPS_H
 #define EX2_BATTLESHIPS_H
 
+#include "bitboard.h"
+#include "rng.h"
+
 /**
  * @brief this struct is a direction struct. if you add it to the coordinate you move one step to
  * the direction initialized in it. (can be right, left, up, down...)
@@ -42,41 +45,186 @@ typedef struct Direction
 
 
 /**
- * @brief this is a ship structure. all the instruments in the game are from that type.
+ * @brief this is a ship structure. all the instruments in the game are from that type. it only
+ * describes the ship in a fleet, a placed ship lives in the ShipRegistry of its game.
  * @length the length of the ship (how many cells it catches on the board
- * @numOfHits the number of hits the user made on that ship. init with zero first
  */
 
 typedef struct Ship
 {
     int length;
-    int numOfHits;
 } Ship;
 
+/**
+ * the number of ships in the standard fleet
+ */
+#define NUM_OF_SHIPS 5
+
+/**
+ * the number of directions a ship can be placed in (along a row or along a column)
+ */
+#define NUM_OF_ORIENTATIONS 2
+
 
 /**
- * the board is made with cells. each one has a coordinate on the board.
- * @content a pointer for the content of the cell- it can be a ship or null. init with null please
- * @status the status of the cell in the game board- hit (x), miss (o) or not reached yet(_).
+ * the longest ship (the hits of a ship are a bit mask of its cells).
  */
-typedef struct Cell
+#define MAX_SHIP_LENGTH 32
+
+/**
+ * the largest fleet on a board (the packed cell keeps the ship index plus one in CELL_SHIP_BITS).
+ */
+#define MAX_FLEET_SHIPS 63
+
+/**
+ * @brief a fleet- the ships that are placed at the start of a game.
+ * @numOfShips the number of ships
+ * @ships the ships, in the order they are placed
+ */
+typedef struct Fleet
 {
-    Ship *content;
-    char status;
-} Cell;
+    int numOfShips;
+    Ship ships[MAX_FLEET_SHIPS];
+} Fleet;
 
+/**
+ * @brief the registry of the placed ships of a game, as a struct of arrays indexed by the ship
+ * index. the cells of the board only keep the index of their ship, everything else about the
+ * ship is here, so a hit, a sunk check or the number of the ships left are O(1):
+ * @numOfShips the number of ships
+ * @numOfSunk the number of ships that were sunk so far
+ * @row the row of the first cell of every ship
+ * @column the column of the first cell of every ship
+ * @hitMask the hits of every ship, bit i is the cell number i of the ship from its first cell
+ * @orientation the orientation of every ship (index to directions- along the row or the column)
+ * @length the length of every ship
+ * @isSunk TRUE for a ship that was sunk, FALSE otherwise
+ * all the arrays are in one block of shipRegistryBytes(numOfShips) bytes that the owner of the
+ * registry allocates (see initShipRegistry).
+ */
+typedef struct ShipRegistry
+{
+    int numOfShips;
+    int numOfSunk;
+    int *row;
+    int *column;
+    uint32_t *hitMask;
+    unsigned char *orientation;
+    unsigned char *length;
+    unsigned char *isSunk;
+} ShipRegistry;
 
 /**
- * the game board struct. it contains a dynamic array of the board and its size
- * (num of rows,columns is equal)
+ * the board is made with cells. each one is a single packed byte:
+ * the low CELL_SHIP_BITS bits hold the index of the ship in the cell plus one (0 for an empty
+ * cell) and the two high bits hold the status of the cell in the game- hit, miss or not reached.
+ * use the CELL_* macros to read and write it.
+ */
+typedef unsigned char Cell;
+
+/**
+ * the layout of the packed cell.
+ */
+#define CELL_SHIP_BITS 6
+#define CELL_SHIP_MASK ((1 << CELL_SHIP_BITS) - 1)
+#define CELL_STATUS_MASK (3 << CELL_SHIP_BITS)
+#define NO_SHIP (-1)
+
+/**
+ * the possible statuses of a cell, already shifted to their place in the packed byte.
+ */
+#define STATUS_UNREACHED (0 << CELL_SHIP_BITS)
+#define STATUS_MISS (1 << CELL_SHIP_BITS)
+#define STATUS_HIT (2 << CELL_SHIP_BITS)
+
+/**
+ * @brief access macros for the packed cell.
+ * CELL_AT gives the cell in the given coordinate, CELL_SHIP the ship index in it (or NO_SHIP)
+ * and CELL_STATUS its status (one of the STATUS_* values).
+ */
+#define CELL_AT(gameBoard, row, col) ((gameBoard)->board[(row) * (gameBoard)->size + (col)])
+#define CELL_SHIP(cell) ((int) ((cell) & CELL_SHIP_MASK) - 1)
+#define CELL_STATUS(cell) ((cell) & CELL_STATUS_MASK)
+
+
+/**
+ * the game board struct. it contains one contiguous array of size * size packed cells (row by
+ * row) and its size (num of rows,columns is equal).
+ * next to the cells it keeps the same state as bitboards, so collisions, repeated moves and the
+ * end of the game are checked with word wide operations (the cells of every single ship are in
+ * the ShipRegistry of the game):
+ * @occupied the cells of all the ships together
+ * @hits the cells the user shot and hit
+ * @misses the cells the user shot and missed
  */
 typedef struct GameBoard
 {
-    Cell **board;
+    Cell *board;
     int size;
+    BitBoard occupied;
+    BitBoard hits;
+    BitBoard misses;
 } GameBoard;
 
 
+/**
+ * @brief a single game. it owns everything the game needs, so there can be as many games as we
+ * want at the same time. start it with initGame and free it with freeGame.
+ * @gameBoard the board of the game
+ * @ships the placed ships of this game and their hits (its arrays share the block of the board)
+ * @rng the random generator of the game
+ * @numOfMoves the number of (not repeated) moves made so far
+ * @status TRUE while the game runs, WIN_GAME once all the ships were sunk
+ */
+typedef struct Game
+{
+    GameBoard gameBoard;
+    ShipRegistry ships;
+    Rng rng;
+    int numOfMoves;
+    int status;
+} Game;
+
+
+/**
+ * @brief the possible results of a single move.
+ */
+typedef enum MoveResult
+{
+    MOVE_MISS,
+    MOVE_HIT,
+    MOVE_SUNK,
+    MOVE_REPEATED,
+    MOVE_WIN,
+    MOVE_INVALID
+} MoveResult;
+
+
+/**
+ * @brief a summary of the game so far.
+ * @status TRUE while the game runs, WIN_GAME once all the ships were sunk
+ * @numOfMoves the number of (not repeated) moves made
+ * @numOfHits the number of moves that hit a ship
+ * @sunkShips the number of ships that were sunk
+ */
+typedef struct GameResult
+{
+    int status;
+    int numOfMoves;
+    int numOfHits;
+    int sunkShips;
+} GameResult;
+
+/**
+ * @brief a function that gets the shots of a board one by one (see forEachShot).
+ * @param context : the context of the caller
+ * @param row : the row of the shot
+ * @param col : the column of the shot
+ * @param status : the status of the cell (STATUS_MISS or STATUS_HIT)
+ */
+typedef void (*ShotVisitor)(void *context, int row, int col, int status);
+
+
 /**
  * constants for true and false conditions. mostly for readability of the code.
  */
@@ -89,14 +237,98 @@ typedef struct GameBoard
 #define EXIT_GAME (-1)
 #define WIN_GAME 2
 
+/**
+ * the flag for a fleet that can't be placed on the board
+ */
+#define NO_PLACEMENT 3
+
+/**
+ * the flag for a fleet the placement search gave up on- it ran out of steps, so the fleet may
+ * still have a layout (with another seed)
+ */
+#define PLACEMENT_TIMEOUT 7
+
+/**
+ * the flag for a board size that is not valid
+ */
+#define INVALID_SIZE 4
+
+/**
+ * the flag for a fleet that is not valid for the board
+ */
+#define INVALID_FLEET 5
+
+/**
+ * the limits of the size of the board (defined in battleships.c)
+ */
+extern const int MIN_SIZE;
+extern const int MAX_SIZE;
+
+/**
+ * the directions a ship can be placed in and the standard fleet (defined in battleships.c)
+ */
+extern const Direction directions[NUM_OF_ORIENTATIONS];
+extern const Fleet standardFleet;
+
 
 
 // ------------------------------ function declarations -----------------------------
 
 
+// ------------------------------ the game engine (battleships.c) ---------------------
+
+/**
+ * this function starts a new game: seeds the rng of the game and builds the board with the
+ * fleet on it. (uses malloc! free the game with freeGame)
+ * @param game : the game to init
+ * @param size : the size of the board
+ * @param fleet : the fleet of the game, NULL for the standard fleet
+ * @param seed : the seed of the game. the same seed, size and fleet always give the same layout
+ * @return TRUE on success, INVALID_SIZE if the size is not valid, INVALID_FLEET if the fleet is
+ * not valid for the board, FALSE if out of memory, NO_PLACEMENT if the fleet can't be placed
+ * on the board and PLACEMENT_TIMEOUT if the search for a layout gave up (see placer.h)
+ */
+int initGame(Game *game, int size, const Fleet *fleet, uint64_t seed);
+
+/**
+ * this function starts a new game on a game that was already started, with the same size and
+ * fleet and a new seed. it allocates nothing- the board and the registry of the game are reused.
+ * @param game : the game (started with initGame)
+ * @param seed : the seed of the new game. the layout is the one initGame gives for the seed
+ * @return TRUE on success, NO_PLACEMENT if the fleet can't be placed on the board,
+ * PLACEMENT_TIMEOUT if the search for a layout gave up and FALSE if out of memory (the game has
+ * no layout then, restart it again or free it)
+ */
+int restartGame(Game *game, uint64_t seed);
+
+/**
+ * this function plays a single move in the game.
+ * @param game : the game
+ * @param row : the index of the row for the move
+ * @param column : the index of the column for the move
+ * @return the result of the move. MOVE_INVALID for a coordinate out of the board or a move on a
+ * game that is already won
+ */
+MoveResult stepGame(Game *game, int row, int column);
+
+/**
+ * this function gives the state of the game so far.
+ * @param game : the game
+ * @return the result of the game
+ */
+GameResult gameResult(const Game *game);
+
 /**
- * this function uses the rand function to find a start coordinate and a valid direction for
- * the ship size. it tries until a full success
+ * this function frees the memory of the game.
+ * @param game : the game
+ */
+void freeGame(Game *game);
+
+
+/**
+ * this function finds all the legal placements of a ship on the board (inside the board and with
+ * no collision with the ships already placed) and picks one of them uniformly with the rng of
+ * the game.
  * @param row : a pointer for the row index. the final row index will be writen to the value of
  * the pointer.
  * @param col : a pointer for the column index. the final col index will be writen to the value of
@@ -104,81 +336,174 @@ typedef struct GameBoard
  * @param direction : the pointer for the direction. the final direction chosen will set in that
  * pointer value.
  * @param sizeOfShip : the size of the ship we want to locate
- * @param gameBoard : the game board
+ * @param game : the game
+ * @return TRUE if a location was found, FALSE if the ship has no legal placement on the board
  */
-void getRandLocation(int *row, int *column, Direction *direction, int sizeOfShip,
-                     GameBoard *gameBoard);
+int getRandLocation(int *row, int *column, Direction *direction, int sizeOfShip, Game *game);
 
 
 /**
- * this function places all the ships in the game board in rand locations
- * @param gameBoard : a pointer to the game board
+ * this function finds all the legal placements of a ship on the board and picks one of them
+ * uniformly with the rng of the game. it is the generic placement kernel, for any board size.
+ * @param row : a pointer for the row index of the placement
+ * @param column : a pointer for the column index of the placement
+ * @param orientation : a pointer for the orientation of the placement (index to directions)
+ * @param sizeOfShip : the size of the ship we want to locate
+ * @param game : the game
+ * @return TRUE if a location was found, FALSE if the ship has no legal placement on the board
  */
-void placeShips(GameBoard *gameBoard);
+int findPlacement(int *row, int *column, int *orientation, int sizeOfShip, Game *game);
 
+/**
+ * this function places a single ship on the board, in a free location.
+ * @param shipIndex : the index of the ship we want to place in the registry of the game
+ * @param row : the row of the first cell of the ship
+ * @param col : the column of the first cell of the ship
+ * @param orientation : the orientation of the ship (index to directions)
+ * @param game : the game
+ */
+void placeShipAt(int shipIndex, int row, int col, int orientation, Game *game);
 
 /**
- * this function builds the game board according to the given size. locates the ships and sets it
- * for a new game. (uses malloc! the free function is separated, please pay attention)
- * @param gameBoard : a pointer to the game board that the function is going to build
- * @return FALSE in case the malloc can't allocate memory for the board, TRUE otherwise
+ * this function init the game board for default values (every cell is unreached and empty, which
+ * is the zero byte) with no ships on it.
+ * @param gameBoard : the board of the game
  */
-int buildGameBoard(GameBoard *gameBoard);
+void initBoard(GameBoard *gameBoard);
 
 /**
- * this function free the memory allocated for the game board.
- * @param gameBoard : this is the board of the game.
+ * this function gives all the shots of a board to a visitor, from the bitboards of the misses and
+ * the hits (the cost is the number of shots, not the size of the board).
+ * @param gameBoard : the board
+ * @param visit : the visitor
+ * @param context : the context of the visitor
  */
-void freeGameBoard(GameBoard *gameBoard);
+void forEachShot(const GameBoard *gameBoard, ShotVisitor visit, void *context);
+
+/**
+ * this function places all the ships of the registry of the game in rand locations. it is the
+ * generic fleet kernel, for any board and any fleet.
+ * @param game : a pointer to the game
+ * @return TRUE if the fleet was placed, NO_PLACEMENT if it couldn't fit the board
+ */
+int placeFleet(Game *game);
+
+/**
+ * this function checks if the ships of the registry of a game are the standard fleet.
+ * @param game : the game
+ * @return TRUE for the standard fleet, FALSE otherwise
+ */
+int isStandardFleet(const Game *game);
+
+/**
+ * this function places all the ships in the game board in rand locations. the standard fleet on a
+ * common board size is placed by its own kernel, anything else by the generic one. a fleet the
+ * kernel can't place (a dense board) is placed by the backtracking search (see placer.h).
+ * @param game : a pointer to the game
+ * @return TRUE if the fleet was placed, NO_PLACEMENT if it couldn't fit the board,
+ * PLACEMENT_TIMEOUT if the search gave up before it found a layout, FALSE if out of memory
+ */
+int placeShips(Game *game);
 
 
 /**
- * this function gets the move from the user and checks its validation.
- * @param row : the pointer for the row var that will set in the input value
- * @param column : the pointer for the col var that will set in the input value
- * @param gameBoard : the game board.
- * @return FALSE in case the input is not valid, TRUE otherwise
+ * this function gives the size of the cells of a board in its block, rounded up to 8 bytes so
+ * the ship registry after them is aligned.
+ * @param size : the size of the board
+ * @return the number of bytes of the cells
+ */
+size_t boardCellBytes(int size);
+
+/**
+ * this function builds the game board according to the given size. locates the ships and sets it
+ * for a new game. the cells and the ship registry are a single block, taken from the board pool
+ * of the thread (see pool.h).
+ * (uses malloc! the free function is separated, please pay attention)
+ * @param game : a pointer to the game whose board the function is going to build
+ * @param fleet : the fleet to place on the board
+ * @return FALSE in case the malloc can't allocate memory for the board, NO_PLACEMENT in case the
+ * fleet can't be placed on the board, PLACEMENT_TIMEOUT in case the search for a layout gave up,
+ * TRUE otherwise
  */
-int getMove(int *row, int *column, GameBoard *gameBoard);
+int buildGameBoard(Game *game, const Fleet *fleet);
+
+/**
+ * this function free the memory allocated for the game board (gives it back to the board pool of
+ * the thread).
+ * @param gameBoard : this is the board of the game.
+ */
+void freeGameBoard(GameBoard *gameBoard);
 
 /**
  * this function checks if the ship that just got hit sunk also. we get its coordinates.
  * @param row : the index of the row
  * @param col : the index of the col
- * @param gameBoard : the board of the game
+ * @param game : the game
  * @return TRUE if the ship is sunk, FALSE otherwise. returns WIN_GAME if all the ship where sunk
  */
-int isSunk(int row, int col, GameBoard *gameBoard);
+int isSunk(int row, int col, Game *game);
 
 /**
- *this function places the move that the user inserted. it prints to the screen the matched
- * massage according to the move that was made (already made, miss, hit, hit and sunk)
- * @param row : the index of the row for the move
- * @param column : the index of the column for the move
- * @param gameBoard : the board of the game
- * @return TRUE for successful move and WIN_GAME in case that the move finished the game
+ * this function gives the number of bytes of the arrays of a ship registry.
+ * @param numOfShips : the number of ships
+ * @return the number of bytes (a multiple of 8, so a block can continue after it)
  */
-int placeMove(int row, int column, GameBoard *gameBoard);
+size_t shipRegistryBytes(int numOfShips);
 
 /**
- * this function prints the game board.
- * @param gameBoard : the game board
+ * this function points a ship registry to the arrays in a block of shipRegistryBytes(numOfShips)
+ * bytes, and leaves what is in them as it is.
+ * @param ships : the registry
+ * @param block : the block of its arrays
+ * @param numOfShips : the number of ships
  */
-void printBoard(const GameBoard *gameBoard);
+void mapShipRegistry(ShipRegistry *ships, void *block, int numOfShips);
 
 /**
- * this function activates a single round in the game.
- * @param gameBoard : the game board
- * @return TRUE if the round finished as planed. EXIT_GAME if the user asked to exit the game
+ * this function sets a ship registry on a block of shipRegistryBytes(numOfShips) bytes, with no
+ * hits. the lengths and the places of the ships are set by the caller.
+ * @param ships : the registry
+ * @param block : the block of its arrays
+ * @param numOfShips : the number of ships
  */
-int playSingleRound(GameBoard *gameBoard);
+void initShipRegistry(ShipRegistry *ships, void *block, int numOfShips);
 
 /**
- * @brief this function terminates the game. prints game over and the final board.
- * @note here we use the free function for the allocation of the game board
- * @param gameBoard : the board of the game
+ * this function sets the place of a ship in the registry.
+ * @param ships : the registry
+ * @param shipIndex : the index of the ship
+ * @param row : the row of the first cell of the ship
+ * @param column : the column of the first cell of the ship
+ * @param orientation : the orientation of the ship (index to directions)
+ */
+void registerShip(ShipRegistry *ships, int shipIndex, int row, int column, int orientation);
+
+/**
+ * this function adds a hit to a ship, in O(1).
+ * @param ships : the registry
+ * @param shipIndex : the index of the ship
+ * @param row : the row of the hit (a cell of the ship)
+ * @param column : the column of the hit
+ * @return TRUE if the hit sunk the ship, FALSE otherwise
+ */
+int hitShip(ShipRegistry *ships, int shipIndex, int row, int column);
+
+/**
+ * this function gives the number of ships that were not sunk yet.
+ * @param ships : the registry
+ * @return the number of ships left
+ */
+int remainingShips(const ShipRegistry *ships);
+
+/**
+ * this function places a move on the board of the game and returns what happened. it writes
+ * nothing to the screen, the caller shows the result.
+ * @param row : the index of the row for the move
+ * @param column : the index of the column for the move
+ * @param game : the game
+ * @return the result of the move (already made, miss, hit, hit and sunk or the winning move)
  */
-void endGame(GameBoard *gameBoard);
+MoveResult placeMove(int row, int column, Game *game);
 
 /**
  * this function checks if a given coordinate is legal according to the size of the board.
@@ -189,18 +514,66 @@ void endGame(GameBoard *gameBoard);
  */
 int isIndexInBoard(int row, int col, int sizeOfBoard);
 
+/**
+ * this function checks the validity of the size of the board.
+ * @param sizeOfBoard: the size of the board
+ * @return TRUE if the size is valid, FALSE otherwise
+ */
+int isValidSize(int sizeOfBoard);
+
+/**
+ * this function checks the validity of a fleet for a board: 1 to MAX_FLEET_SHIPS ships, each one
+ * with a length from 1 to the size of the board (and up to MAX_SHIP_LENGTH).
+ * @param fleet : the fleet
+ * @param sizeOfBoard : the size of the board
+ * @return TRUE if the fleet is valid, FALSE otherwise
+ */
+int isValidFleet(const Fleet *fleet, int sizeOfBoard);
+
+
+// ------------------------------ the user interface (battleships_game.c) --------------
+
+struct Renderer; // the board renderer, see render.h
+struct LineReader; // the reader of the user input, see input.h
+
+/**
+ * this function activates a single round in the game.
+ * @param game : the game
+ * @param renderer : the renderer of the board (see render.h)
+ * @param reader : the reader of the user input (see input.h), NULL to let the computer player
+ * choose the move
+ * @return TRUE if the round finished as planed. EXIT_GAME if the user asked to exit the game (or
+ * the input ended), WIN_GAME if the move won the game
+ */
+int playSingleRound(Game *game, struct Renderer *renderer, struct LineReader *reader);
+
+/**
+ * @brief this function terminates the game. prints game over and the final board.
+ * @note here we use the free function for the allocation of the game
+ * @param game : the game
+ * @param renderer : the renderer of the board (see render.h)
+ */
+void endGame(Game *game, struct Renderer *renderer);
+
 /**
  * this function gets the size of the board from the user
- * @param gameBoard : a pointer to the game board
+ * @param sizeOfBoard : a pointer to the size that will set in the input value
+ * @param reader : the reader of the user input (see input.h)
  * @return TRUE if the size is valid and FALSE otherwise
  */
-int getSizeOfBoard(GameBoard *gameBoard);
+int getSizeOfBoard(int *sizeOfBoard, struct LineReader *reader);
 
 /**
  * this function runs the rounds of the game in a loop until the game is over
- * @param gameBoard : the board of the game.
+ * @param game : the game.
+ * @param renderer : the renderer of the board (see render.h)
+ * @param reader : the reader of the user input (see input.h), NULL to let the computer player
+ * choose the moves
+ * @param savePath : the path to save a snapshot of the game to when it ends (see snapshot.h),
+ * NULL to not save it
  */
-void playGame(GameBoard *gameBoard);
+void playGame(Game *game, struct Renderer *renderer, struct LineReader *reader,
+              const char *savePath);
 
 
 #endif //EX2_BATTLESHIPS_H
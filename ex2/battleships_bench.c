@@ -0,0 +1,745 @@
+// ------------------------------ includes ------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "battleships.h"
+#include "render.h"
+#include "input.h"
+#include "stats.h"
+
+/**
+ * @file battleships_bench.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the micro benchmarks of the game- the placement of the fleet, the moves, the rendering
+ * and the parsing of the moves.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * every benchmark runs an operation in samples. the number of operations in a sample is doubled
+ * until a sample takes at least SAMPLE_NS, then a few samples are thrown away to warm up and the
+ * rest are measured. the report is the median and the 99th percentile of the time of an operation
+ * over the samples. all the games use fixed seeds, so every run measures the same work.
+ * the results are printed as a table, and can be written as json. a json of an earlier run can be
+ * given as a baseline- every benchmark whose median got slower by more than the threshold is
+ * reported, and the exit code tells if there was such a regression.
+ * Input  : the options from the command line
+ * Process: runs the benchmarks
+ * Output : the results of the benchmarks
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the shortest time of a sample, in nano seconds.
+ */
+#define SAMPLE_NS 200000
+
+/**
+ * the number of samples that are thrown away before the measure.
+ */
+#define WARMUP_SAMPLES 10
+
+/**
+ * the default and the largest number of measured samples.
+ */
+#define DEFAULT_SAMPLES 101
+#define MAX_SAMPLES 10001
+
+/**
+ * the limits of the benchmarks and of their names.
+ */
+#define MAX_BENCHMARKS 64
+#define NAME_CAPACITY 32
+
+/**
+ * the number of lines in the input of the parsing benchmark.
+ */
+#define PARSE_LINES 1024
+
+/**
+ * the seed of all the games of the benchmarks.
+ */
+const uint64_t BENCH_SEED = 20261017;
+
+/**
+ * the default size of the board of the move and render benchmarks.
+ */
+const int BENCH_SIZE = 10;
+
+/**
+ * the default slowdown (in percents) of a median that counts as a regression.
+ */
+const double DEFAULT_THRESHOLD = 10;
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the command line arguments are not valid
+ */
+const char *BENCH_USAGE_MSG =
+        "usage: ex2_bench [--filter <name prefix>] [--samples <number>] [--json <file>] "
+        "[--baseline <file>] [--threshold <percents>]\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that a file can't be opened
+ */
+const char *BENCH_FILE_ERROR_MSG = "can't open %s\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the fleet could not be placed on a board
+ */
+const char *BENCH_PLACEMENT_ERROR_MSG = "the fleet could not be placed on a %d board\n";
+
+/**
+ * @brief a benchmark.
+ * @name the name of the benchmark
+ * @param the parameter of the benchmark (the size of the board)
+ * @setup prepares the state of the benchmark, returns TRUE on success
+ * @run runs the operation a number of times and returns the nano seconds it took
+ * @opsPerSample the number of operations in a sample
+ * @median the median time of an operation in nano seconds
+ * @p99 the 99th percentile time of an operation in nano seconds
+ */
+typedef struct Benchmark
+{
+    char name[NAME_CAPACITY];
+    int param;
+    int (*setup)(int param);
+    uint64_t (*run)(long iterations);
+    long opsPerSample;
+    double median;
+    double p99;
+} Benchmark;
+
+/**
+ * @brief the options of the benchmarks.
+ * @filter only the benchmarks whose name starts with it run (NULL for all)
+ * @samples the number of measured samples
+ * @jsonFile the file to write the json results to (NULL for none)
+ * @baselineFile the json of an earlier run to compare to (NULL for none)
+ * @threshold the slowdown in percents that counts as a regression
+ */
+typedef struct BenchOptions
+{
+    const char *filter;
+    int samples;
+    const char *jsonFile;
+    const char *baselineFile;
+    double threshold;
+} BenchOptions;
+
+/**
+ * the state of the running benchmark. the game of a move benchmark is saved after the setup, and
+ * restored (outside the measured time) once its cells were used up.
+ */
+int benchSize;
+Game benchGame;
+Game savedGame;
+Cell savedCells[BITBOARD_MAX_SIDE * BITBOARD_MAX_SIDE];
+uint32_t savedHitMask[NUM_OF_SHIPS];
+unsigned char savedIsSunk[NUM_OF_SHIPS];
+int hasGame = FALSE;
+int moveCells[BITBOARD_MAX_SIDE * BITBOARD_MAX_SIDE];
+int numOfMoveCells;
+Renderer benchRenderer;
+int sinkFd = -1;
+LineReader benchReader;
+char parseInput[PARSE_LINES * 8];
+int parseInputLength;
+volatile int benchSink;
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function frees the game of the last benchmark, if there is one.
+ */
+void releaseGame(void)
+{
+    if (hasGame == TRUE)
+    {
+        freeGame(&benchGame);
+        hasGame = FALSE;
+    }
+}
+
+/**
+ * this function starts the game of a benchmark.
+ * @param size : the size of the board
+ * @return TRUE on success, FALSE if the fleet could not be placed
+ */
+int startGame(const int size)
+{
+    releaseGame();
+    if (initGame(&benchGame, size, NULL, BENCH_SEED) != TRUE)
+    {
+        fprintf(stderr, BENCH_PLACEMENT_ERROR_MSG, size);
+        return FALSE;
+    }
+    hasGame = TRUE;
+    return TRUE;
+}
+
+/**
+ * this function saves the game of a move benchmark- the game, its cells and the hits of its ships.
+ */
+void saveGame(void)
+{
+    savedGame = benchGame;
+    memcpy(savedCells, benchGame.gameBoard.board,
+           (size_t) (benchGame.gameBoard.size * benchGame.gameBoard.size) * sizeof(Cell));
+    memcpy(savedHitMask, benchGame.ships.hitMask, sizeof(savedHitMask));
+    memcpy(savedIsSunk, benchGame.ships.isSunk, sizeof(savedIsSunk));
+}
+
+/**
+ * this function restores the saved game of a move benchmark.
+ */
+void restoreGame(void)
+{
+    benchGame = savedGame;
+    memcpy(benchGame.gameBoard.board, savedCells,
+           (size_t) (benchGame.gameBoard.size * benchGame.gameBoard.size) * sizeof(Cell));
+    memcpy(benchGame.ships.hitMask, savedHitMask, sizeof(savedHitMask));
+    memcpy(benchGame.ships.isSunk, savedIsSunk, sizeof(savedIsSunk));
+}
+
+/**
+ * this function sets the size of the placement benchmark.
+ * @param size : the size of the board
+ * @return TRUE
+ */
+int setupPlace(const int size)
+{
+    benchSize = size;
+    return TRUE;
+}
+
+/**
+ * this function builds boards with a whole fleet on them (buildGameBoard and placeShips).
+ * @param iterations : the number of boards
+ * @return the nano seconds it took
+ */
+uint64_t runPlace(const long iterations)
+{
+    Game game;
+    long i;
+    uint64_t start = statsNanos();
+    for (i = 0 ; i < iterations ; ++i)
+    {
+        if (initGame(&game, benchSize, NULL, BENCH_SEED + (uint64_t) i) == TRUE)
+        {
+            freeGame(&game);
+        }
+    }
+    return statsNanos() - start;
+}
+
+/**
+ * this function prepares the cells of the miss benchmark- all the empty cells.
+ * @param size : the size of the board
+ * @return TRUE on success, FALSE if the fleet could not be placed
+ */
+int setupMiss(const int size)
+{
+    if (startGame(size) == FALSE)
+    {
+        return FALSE;
+    }
+    int cell;
+    numOfMoveCells = 0;
+    for (cell = 0 ; cell < size * size ; ++cell)
+    {
+        if (CELL_SHIP(benchGame.gameBoard.board[cell]) == NO_SHIP)
+        {
+            moveCells[numOfMoveCells++] = cell;
+        }
+    }
+    saveGame();
+    return TRUE;
+}
+
+/**
+ * this function prepares the cells of the hit benchmark- all the cells of the ships but the last
+ * one of every ship, so every move is a plain hit.
+ * @param size : the size of the board
+ * @return TRUE on success, FALSE if the fleet could not be placed
+ */
+int setupHit(const int size)
+{
+    if (startGame(size) == FALSE)
+    {
+        return FALSE;
+    }
+    int seen[NUM_OF_SHIPS] = {0};
+    int cell;
+    numOfMoveCells = 0;
+    for (cell = 0 ; cell < size * size ; ++cell)
+    {
+        int ship = CELL_SHIP(benchGame.gameBoard.board[cell]);
+        if (ship != NO_SHIP && ++seen[ship] < benchGame.ships.length[ship])
+        {
+            moveCells[numOfMoveCells++] = cell;
+        }
+    }
+    saveGame();
+    return TRUE;
+}
+
+/**
+ * this function prepares the repeat benchmark- a cell that was already missed, again and again.
+ * @param size : the size of the board
+ * @return TRUE on success, FALSE if the fleet could not be placed
+ */
+int setupRepeat(const int size)
+{
+    if (setupMiss(size) == FALSE)
+    {
+        return FALSE;
+    }
+    placeMove(moveCells[0] / size, moveCells[0] % size, &benchGame);
+    int i;
+    numOfMoveCells = size * size;
+    for (i = 1 ; i < numOfMoveCells ; ++i)
+    {
+        moveCells[i] = moveCells[0];
+    }
+    saveGame();
+    return TRUE;
+}
+
+/**
+ * this function makes the moves of a move benchmark, round after round over its cells. the game
+ * is restored between the rounds, outside the measured time.
+ * @param iterations : the number of moves
+ * @return the nano seconds it took
+ */
+uint64_t runMoves(const long iterations)
+{
+    int size = benchGame.gameBoard.size;
+    uint64_t elapsed = 0;
+    int results = 0;
+    long done = 0;
+    while (done < iterations)
+    {
+        long round = iterations - done < numOfMoveCells ? iterations - done : numOfMoveCells;
+        long i;
+        uint64_t start = statsNanos();
+        for (i = 0 ; i < round ; ++i)
+        {
+            results += placeMove(moveCells[i] / size, moveCells[i] % size, &benchGame);
+        }
+        elapsed += statsNanos() - start;
+        done += round;
+        restoreGame();
+    }
+    benchSink = results;
+    return elapsed;
+}
+
+/**
+ * this function prepares a render benchmark- a board with a few moves on it, rendered once.
+ * @param size : the size of the board
+ * @param isIncremental : TRUE for the incremental mode, FALSE for full frames
+ * @return TRUE on success, FALSE if the fleet could not be placed
+ */
+int setupRender(const int size, const int isIncremental)
+{
+    if (startGame(size) == FALSE)
+    {
+        return FALSE;
+    }
+    int cell;
+    for (cell = 0 ; cell < size * size ; cell += 3)
+    {
+        placeMove(cell / size, cell % size, &benchGame);
+    }
+    initRenderer(&benchRenderer, sinkFd, isIncremental);
+    renderBoard(&benchRenderer, &benchGame.gameBoard);
+    return TRUE;
+}
+
+/**
+ * this function prepares a full frame render benchmark.
+ * @param size : the size of the board
+ * @return TRUE on success, FALSE if the fleet could not be placed
+ */
+int setupRenderFull(const int size)
+{
+    return setupRender(size, FALSE);
+}
+
+/**
+ * this function prepares an incremental render benchmark.
+ * @param size : the size of the board
+ * @return TRUE on success, FALSE if the fleet could not be placed
+ */
+int setupRenderIncremental(const int size)
+{
+    return setupRender(size, TRUE);
+}
+
+/**
+ * this function renders the board to the sink (/dev/null).
+ * @param iterations : the number of frames
+ * @return the nano seconds it took
+ */
+uint64_t runRender(const long iterations)
+{
+    long i;
+    uint64_t start = statsNanos();
+    for (i = 0 ; i < iterations ; ++i)
+    {
+        renderBoard(&benchRenderer, &benchGame.gameBoard);
+    }
+    return statsNanos() - start;
+}
+
+/**
+ * this function prepares the input of the parsing benchmark- lines of moves of all the forms.
+ * @param size : the size of the board
+ * @return TRUE
+ */
+int setupParse(const int size)
+{
+    Rng rng;
+    rngSeed(&rng, BENCH_SEED);
+    int i;
+    parseInputLength = 0;
+    for (i = 0 ; i < PARSE_LINES ; ++i)
+    {
+        char row = (char) ('a' + rngBounded(&rng, (uint32_t) size));
+        int column = 1 + (int) rngBounded(&rng, (uint32_t) size);
+        parseInputLength += sprintf(parseInput + parseInputLength, (i % 2 == 0) ? "%c %d\n" :
+                                                                   "%c%d\n", row, column);
+    }
+    return TRUE;
+}
+
+/**
+ * this function reads and parses moves from the input in memory, the way getMove does.
+ * @param iterations : the number of moves
+ * @return the nano seconds it took
+ */
+uint64_t runParse(const long iterations)
+{
+    int sum = 0;
+    long i;
+    int linesLeft = 0;
+    uint64_t start = statsNanos();
+    for (i = 0 ; i < iterations ; ++i)
+    {
+        if (linesLeft == 0)
+        { // back to the start of the input
+            memcpy(benchReader.buffer, parseInput, (size_t) parseInputLength);
+            benchReader.start = 0;
+            benchReader.end = parseInputLength;
+            benchReader.isEof = TRUE;
+            linesLeft = PARSE_LINES;
+        }
+        const char *line;
+        int length, row, col;
+        readLine(&benchReader, &line, &length);
+        if (parseMove(line, length, &row, &col) == PARSE_OK)
+        {
+            sum += row + col;
+        }
+        linesLeft--;
+    }
+    uint64_t elapsed = statsNanos() - start;
+    benchSink = sum;
+    return elapsed;
+}
+
+/**
+ * this function compares two sample times, for qsort.
+ * @param first : the first time
+ * @param second : the second time
+ * @return negative, 0 or positive as the first is smaller, equal or larger
+ */
+int compareTimes(const void *first, const void *second)
+{
+    double a = *(const double *) first;
+    double b = *(const double *) second;
+    return (a > b) - (a < b);
+}
+
+/**
+ * this function measures a benchmark.
+ * @param benchmark : the benchmark
+ * @param numOfSamples : the number of measured samples
+ * @return TRUE on success, FALSE if the setup of the benchmark failed
+ */
+int measure(Benchmark *benchmark, const int numOfSamples)
+{
+    static double times[MAX_SAMPLES];
+    if (benchmark->setup(benchmark->param) == FALSE)
+    {
+        return FALSE;
+    }
+    long iterations = 1;
+    while (benchmark->run(iterations) < SAMPLE_NS)
+    {
+        iterations *= 2;
+    }
+    int i;
+    for (i = 0 ; i < WARMUP_SAMPLES ; ++i)
+    {
+        benchmark->run(iterations);
+    }
+    for (i = 0 ; i < numOfSamples ; ++i)
+    {
+        times[i] = (double) benchmark->run(iterations) / (double) iterations;
+    }
+    qsort(times, (size_t) numOfSamples, sizeof(double), compareTimes);
+    benchmark->opsPerSample = iterations;
+    benchmark->median = times[numOfSamples / 2];
+    benchmark->p99 = times[(numOfSamples * 99 - 1) / 100];
+    return TRUE;
+}
+
+/**
+ * this function adds a benchmark to the list.
+ * @param benchmarks : the list
+ * @param count : the number of benchmarks in the list, will be increased
+ * @param name : the name of the benchmark
+ * @param param : the parameter of the benchmark
+ * @param setup : the setup of the benchmark
+ * @param run : the operation of the benchmark
+ */
+void addBenchmark(Benchmark *benchmarks, int *count, const char *name, const int param,
+                  int (*setup)(int), uint64_t (*run)(long))
+{
+    Benchmark *benchmark = &benchmarks[(*count)++];
+    snprintf(benchmark->name, NAME_CAPACITY, "%s/%d", name, param);
+    benchmark->param = param;
+    benchmark->setup = setup;
+    benchmark->run = run;
+}
+
+/**
+ * this function builds the list of all the benchmarks.
+ * @param benchmarks : the list
+ * @return the number of benchmarks
+ */
+int listBenchmarks(Benchmark *benchmarks)
+{
+    int count = 0;
+    int size;
+    for (size = MIN_SIZE ; size <= MAX_SIZE ; ++size)
+    {
+        addBenchmark(benchmarks, &count, "place", size, setupPlace, runPlace);
+    }
+    addBenchmark(benchmarks, &count, "move_miss", BENCH_SIZE, setupMiss, runMoves);
+    addBenchmark(benchmarks, &count, "move_hit", BENCH_SIZE, setupHit, runMoves);
+    addBenchmark(benchmarks, &count, "move_repeat", BENCH_SIZE, setupRepeat, runMoves);
+    addBenchmark(benchmarks, &count, "render_full", BENCH_SIZE, setupRenderFull, runRender);
+    addBenchmark(benchmarks, &count, "render_full", MAX_SIZE, setupRenderFull, runRender);
+    addBenchmark(benchmarks, &count, "render_incremental", BENCH_SIZE, setupRenderIncremental,
+                 runRender);
+    addBenchmark(benchmarks, &count, "render_incremental", MAX_SIZE, setupRenderIncremental,
+                 runRender);
+    addBenchmark(benchmarks, &count, "parse_move", BENCH_SIZE, setupParse, runParse);
+    return count;
+}
+
+/**
+ * this function writes the results as json- one benchmark in a line, so a baseline can be read
+ * back line by line.
+ * @param file : the file to write to
+ * @param benchmarks : the benchmarks
+ * @param count : the number of benchmarks
+ */
+void writeJson(FILE *file, const Benchmark *benchmarks, const int count)
+{
+    int i;
+    fprintf(file, "{\"benchmarks\": [\n");
+    for (i = 0 ; i < count ; ++i)
+    {
+        fprintf(file, "  {\"name\": \"%s\", \"median_ns\": %.2f, \"p99_ns\": %.2f, "
+                      "\"ops_per_sample\": %ld}%s\n", benchmarks[i].name, benchmarks[i].median,
+                benchmarks[i].p99, benchmarks[i].opsPerSample, (i + 1 < count) ? "," : "");
+    }
+    fprintf(file, "]}\n");
+}
+
+/**
+ * this function compares the results to a baseline and reports the regressions.
+ * @param file : the json of the baseline
+ * @param benchmarks : the benchmarks
+ * @param count : the number of benchmarks
+ * @param threshold : the slowdown in percents that counts as a regression
+ * @return the number of regressions
+ */
+int compareBaseline(FILE *file, const Benchmark *benchmarks, const int count,
+                    const double threshold)
+{
+    char line[MAX_LINE_LENGTH];
+    char name[NAME_CAPACITY];
+    double median;
+    int regressions = 0;
+    int i;
+    printf("\n%-26s %12s %12s %9s\n", "compared to baseline", "baseline", "now", "change");
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if (sscanf(line, " {\"name\": \"%31[^\"]\", \"median_ns\": %lf", name, &median) != 2)
+        {
+            continue;
+        }
+        for (i = 0 ; i < count ; ++i)
+        {
+            if (strcmp(benchmarks[i].name, name) != 0 || median <= 0)
+            {
+                continue;
+            }
+            double change = 100 * (benchmarks[i].median - median) / median;
+            int isRegression = (change > threshold) ? TRUE : FALSE;
+            printf("%-26s %12.2f %12.2f %+8.1f%%%s\n", name, median, benchmarks[i].median, change,
+                   (isRegression == TRUE) ? "  REGRESSION" : "");
+            if (isRegression == TRUE)
+            {
+                regressions++;
+            }
+        }
+    }
+    return regressions;
+}
+
+/**
+ * this function reads the options of the benchmarks from the command line.
+ * @param argc : the number of the arguments
+ * @param argv : the arguments
+ * @param options : will be set to the options
+ * @return TRUE if the arguments are valid, FALSE otherwise
+ */
+int parseBenchArguments(const int argc, char *argv[], BenchOptions *options)
+{
+    options->filter = NULL;
+    options->samples = DEFAULT_SAMPLES;
+    options->jsonFile = NULL;
+    options->baselineFile = NULL;
+    options->threshold = DEFAULT_THRESHOLD;
+    int i;
+    for (i = 1 ; i + 1 < argc ; i += 2)
+    {
+        const char *value = argv[i + 1];
+        if (strcmp(argv[i], "--filter") == 0)
+        {
+            options->filter = value;
+        }
+        else if (strcmp(argv[i], "--samples") == 0)
+        {
+            if (sscanf(value, "%d", &options->samples) != 1 || options->samples < 1 ||
+                options->samples > MAX_SAMPLES)
+            {
+                return FALSE;
+            }
+        }
+        else if (strcmp(argv[i], "--json") == 0)
+        {
+            options->jsonFile = value;
+        }
+        else if (strcmp(argv[i], "--baseline") == 0)
+        {
+            options->baselineFile = value;
+        }
+        else if (strcmp(argv[i], "--threshold") == 0)
+        {
+            if (sscanf(value, "%lf", &options->threshold) != 1)
+            {
+                return FALSE;
+            }
+        }
+        else
+        {
+            return FALSE;
+        }
+    }
+    return (i == argc) ? TRUE : FALSE;
+}
+
+/**
+ * the main function of the benchmarks.
+ * @param argc : the number of the arguments
+ * @param argv : the arguments (see BENCH_USAGE_MSG)
+ * @return 0 on success, 1 if the arguments are not valid or a benchmark failed, 2 if there was
+ * a regression from the baseline
+ */
+int main(int argc, char *argv[])
+{
+    BenchOptions options;
+    if (parseBenchArguments(argc, argv, &options) == FALSE)
+    {
+        fprintf(stderr, BENCH_USAGE_MSG);
+        return 1;
+    }
+    sinkFd = open("/dev/null", O_WRONLY);
+    if (sinkFd < 0)
+    {
+        fprintf(stderr, BENCH_FILE_ERROR_MSG, "/dev/null");
+        return 1;
+    }
+    initLineReader(&benchReader, -1);
+    static Benchmark all[MAX_BENCHMARKS];
+    static Benchmark benchmarks[MAX_BENCHMARKS];
+    int numOfAll = listBenchmarks(all);
+    int count = 0;
+    int i;
+    printf("%-26s %12s %12s %12s\n", "benchmark", "median ns", "p99 ns", "ops/sample");
+    for (i = 0 ; i < numOfAll ; ++i)
+    {
+        if (options.filter != NULL &&
+            strncmp(all[i].name, options.filter, strlen(options.filter)) != 0)
+        {
+            continue;
+        }
+        if (measure(&all[i], options.samples) == FALSE)
+        {
+            releaseGame();
+            return 1;
+        }
+        benchmarks[count++] = all[i];
+        printf("%-26s %12.2f %12.2f %12ld\n", all[i].name, all[i].median, all[i].p99,
+               all[i].opsPerSample);
+        fflush(stdout);
+    }
+    releaseGame();
+    close(sinkFd);
+    if (options.jsonFile != NULL)
+    {
+        FILE *json = fopen(options.jsonFile, "w");
+        if (json == NULL)
+        {
+            fprintf(stderr, BENCH_FILE_ERROR_MSG, options.jsonFile);
+            return 1;
+        }
+        writeJson(json, benchmarks, count);
+        fclose(json);
+    }
+    if (options.baselineFile != NULL)
+    {
+        FILE *baseline = fopen(options.baselineFile, "r");
+        if (baseline == NULL)
+        {
+            fprintf(stderr, BENCH_FILE_ERROR_MSG, options.baselineFile);
+            return 1;
+        }
+        int regressions = compareBaseline(baseline, benchmarks, count, options.threshold);
+        fclose(baseline);
+        if (regressions > 0)
+        {
+            return 2;
+        }
+    }
+    return 0;
+}
@@ -1,7 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <memory.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "battleships.h"
+#include "render.h"
+#include "input.h"
+#include "ai.h"
+#include "sparse.h"
+#include "snapshot.h"
+#include "journal.h"
+#include "stats.h"
 
 /**
  * @file battleShips_game.c
@@ -26,23 +37,101 @@
 
 // -------------------------- const definitions -------------------------
 
+/**
+ * @var string massage
+ * @brief informative massage for the case that the input coordinates was already chosen.
+ */
+const char *REPEATED_MOVE_MSG = "you already placed that move.\n";
+
+/**
+ * @var string massage
+ * @brief informative massage for the case that the user didn't hit any ship.
+ */
+const char *MISS_MSG = "Miss.\n";
+
+/**
+ * @var string massage
+ * @brief informative massage for the case that the user hit a ship
+ */
+const char *HIT_MSG = "Hit!\n";
+
+/**
+ * @var string massage
+ * @brief informative massage for the case that the user sunk a ship
+ */
+const char *SUNK_MSG = "Hit and Sunk.\n";
+
+/**
+ * @var string massage
+ * @brief informative massage to ask the user for a board size
+ */
+const char *ENTER_SIZE_MSG = "enter board size: ";
+
 /**
  * @var string massage
  * @brief error massage for the case that the input for the size the user entered is not valid
  */
 const char *INVALID_SIZE_MSG = "the size you entered is not valid\n";
 
+/**
+ * @var string massage
+ * @brief error massage for the case that the size the user entered can't be parsed
+ */
+const char *BAD_SIZE_MSG = "bad size: %s\n";
+
 /**
  * @var string massage
  * @brief error massage for the case that the allocate of the memory failed.
  */
 const char *OUT_OF_MEMORY_MSG = "fail to allocate memory\n";
 
+/**
+ * @var string massage
+ * @brief error massage for the case that the fleet can't be placed on the board.
+ */
+const char *NO_PLACEMENT_MSG = "the fleet can't be placed on the board\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the search for a layout of the fleet gave up.
+ */
+const char *PLACEMENT_TIMEOUT_MSG = "no layout of the fleet was found in time, try another seed\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the fleet doesn't fit the size of the board.
+ */
+const char *INVALID_FLEET_MSG = "the fleet is not valid for the board\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the fleet of the command line can't be parsed
+ */
+const char *BAD_FLEET_MSG = "bad fleet: %s\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the game to resume is not a valid snapshot
+ */
+const char *INVALID_SNAPSHOT_MSG = "can't resume the game, not a valid snapshot\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the game can't be saved
+ */
+const char *SAVE_ERROR_MSG = "can't save the game";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the journal can't be written
+ */
+const char *JOURNAL_ERROR_MSG = "can't write the journal";
+
 /**
  * @var string massage
  * @brief error massage for the case that the move entered is not valid
  */
-const char *INVALID_MOVE_MSG = "Invalid move, try again\n";
+const char *INVALID_MOVE_MSG = "Invalid move (%s), try again\n";
 
 /**
  * @var string massage
@@ -50,6 +139,25 @@ const char *INVALID_MOVE_MSG = "Invalid move, try again\n";
  */
 const char *ENTER_MOVE_MSG = "enter coordinates: ";
 
+/**
+ * @var string massage
+ * @brief informative massage for the case that the time of a move passed and it is skipped
+ */
+const char *TIMEOUT_SKIP_MSG = "\nthe time for the move is over, the move is skipped\n";
+
+/**
+ * @var string massage
+ * @brief informative massage for the case that the time of a move passed and the computer plays it
+ */
+const char *TIMEOUT_AI_MSG = "\nthe time for the move is over, the computer plays it\n";
+
+/**
+ * @var string massage
+ * @brief informative massage for the case that the time of the move or of the game passed and the
+ * game ends
+ */
+const char *TIMEOUT_END_MSG = "\nthe time is over, the game ends\n";
+
 /**
  * @var string massage
  * @brief informative massage for the case that we start a new game
@@ -63,209 +171,1009 @@ const char *START_GAME_MSG = "Ready to play\n";
 const char *END_GAME_MSG = "Game over\n";
 
 /**
- * @var constant for identify user input.
- * @brief if the user asks to exit the program before the game was finished it will write this word
+ * @var string massage
+ * @brief error massage for the case that the command line arguments are not valid
+ */
+const char *USAGE_MSG =
+        "usage: ex2 [--seed <number>] [--incremental] [--autoplay] [--batch [<moves file>]] "
+        "[--ships <number>] [--fleet <lengths> | --fleet-file <path>] [--save <path>] "
+        "[--resume <path>] [--journal <path>] [--stats text|json] [--viewport <side>] "
+        "[--move-timeout <seconds>] [--game-timeout <seconds>] [--on-timeout skip|ai|end]\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the moves file of the batch mode can't be opened
+ */
+const char *OPEN_FILE_ERROR_MSG = "can't open the moves file";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the fleet file can't be read
+ */
+const char *FLEET_FILE_ERROR_MSG = "can't read the fleet file";
+
+/**
+ * @var constant for the command line.
+ * @brief the flag that sets the seed of the game. the same seed always gives the same ships layout
+ */
+const char *SEED_FLAG = "--seed";
+
+/**
+ * @var constant for the command line.
+ * @brief the flag of the batch mode- the size and the moves are read from a file (or the standard
+ * input) and only the result of every move is printed, with no board.
  */
-const char *EXIT_CALL = "exit";
+const char *BATCH_FLAG = "--batch";
 
 /**
- * the lowest index possible for the game board. maximal is simply the board size - 1.
- * maximal cant be constant cause its unknown at compile time
+ * @var constant for the command line.
+ * @brief the flag of the incremental rendering- after the first frame only the cells that changed
+ * are redrawn (with ANSI cursor escapes), for slow terminals.
  */
-const int MIN_INDEX = 0;
+const char *INCREMENTAL_FLAG = "--incremental";
+
+/**
+ * @var constant for the command line.
+ * @brief the flag of the autoplay mode- the computer player chooses all the moves.
+ */
+const char *AUTOPLAY_FLAG = "--autoplay";
+
+/**
+ * @var constant for the command line.
+ * @brief the flag of the number of ships on a board bigger than MAX_SIZE (batch mode only).
+ */
+const char *SHIPS_FLAG = "--ships";
+
+/**
+ * @var constant for the command line.
+ * @brief the flag of the fleet of the game- the lengths of its ships, like "5,4,3,3,2" or
+ * "2x4,3x2" (see parseFleet).
+ */
+const char *FLEET_FLAG = "--fleet";
+
+/**
+ * @var constant for the command line.
+ * @brief the flag of the fleet file- a file with the lengths of the ships of the fleet, in the
+ * format of the fleet flag (with new lines and "#" comments).
+ */
+const char *FLEET_FILE_FLAG = "--fleet-file";
+
+/**
+ * @var constant for the command line.
+ * @brief the flag that saves a snapshot of the game (see snapshot.h) to a path when the game ends
+ * or the user exits.
+ */
+const char *SAVE_FLAG = "--save";
+
+/**
+ * @var constant for the command line.
+ * @brief the flag that resumes the game from a snapshot instead of starting a new one.
+ */
+const char *RESUME_FLAG = "--resume";
+
+/**
+ * @var constant for the command line.
+ * @brief the flag that writes every move and its result to a journal (see journal.h), for a new
+ * game on a board up to MAX_SIZE.
+ */
+const char *JOURNAL_FLAG = "--journal";
+
+/**
+ * @var constant for the command line.
+ * @brief the flag that writes the counters and the latency histograms of the hot paths (see
+ * stats.h) to the standard error when the program exits, as "text" or "json".
+ */
+const char *STATS_FLAG = "--stats";
+
+/**
+ * @var constant for the command line.
+ * @brief the flag of the viewport rendering- only a window of the given side around the last shot
+ * and an overview of the whole board are rendered (see render.h). in the batch mode the window of
+ * the last move is rendered at the end (on a board of any size).
+ */
+const char *VIEWPORT_FLAG = "--viewport";
+
+/**
+ * @var constant for the command line.
+ * @brief the flag of the time the user has for every move (and for the size of the board), in
+ * seconds. when it passes the action of the on timeout flag is taken.
+ */
+const char *MOVE_TIMEOUT_FLAG = "--move-timeout";
+
+/**
+ * @var constant for the command line.
+ * @brief the flag of the time the user has for the whole game, in seconds. when it passes the game
+ * ends (and is saved if there is a save path).
+ */
+const char *GAME_TIMEOUT_FLAG = "--game-timeout";
+
+/**
+ * @var constant for the command line.
+ * @brief the flag of what happens when the time of a move passes- "skip" the move, let the
+ * computer play it ("ai") or "end" the game (the default).
+ */
+const char *ON_TIMEOUT_FLAG = "--on-timeout";
+
+/**
+ * @brief the names of the actions of the on timeout flag, indexed by the TimeoutAction.
+ */
+const char *TIMEOUT_ACTION_NAMES[] = {"skip", "ai", "end"};
+
+/**
+ * @brief the code printed in the batch mode for every result of a move, indexed by the MoveResult-
+ * miss, hit, sunk, repeated, win and invalid.
+ */
+const char MOVE_CODES[] = {'m', 'h', 's', 'r', 'w', 'i'};
+
+/**
+ * the size of the output buffer of the batch mode.
+ */
+#define BATCH_OUTPUT_BUFFER (1 << 16)
+
+/**
+ * the largest fleet file we read.
+ */
+#define FLEET_FILE_CAPACITY 4096
+
+/**
+ * the nano seconds in a second.
+ */
+#define NANOS_PER_SECOND 1000000000u
+
+/**
+ * @brief what happens when the time of a move passes.
+ */
+typedef enum TimeoutAction
+{
+    TIMEOUT_SKIP, // the move is skipped
+    TIMEOUT_AI, // the computer player plays the move
+    TIMEOUT_END, // the game ends
+    NUM_OF_TIMEOUT_ACTIONS
+} TimeoutAction;
+
+/**
+ * @brief the turn clock of an interactive game.
+ * @moveNanos the time the user has for a move, 0 for no limit
+ * @gameDeadline the time (of statsNanos) the game ends at, 0 for no limit
+ * @action what happens when the time of a move passes
+ */
+typedef struct TurnClock
+{
+    uint64_t moveNanos;
+    uint64_t gameDeadline;
+    TimeoutAction action;
+} TurnClock;
+
+/**
+ * @brief the options of the program from the command line.
+ * @seed the seed of the game
+ * @isBatch TRUE for the batch mode, FALSE for the interactive game
+ * @batchFile the path of the moves file of the batch mode, NULL for the standard input
+ * @isIncremental TRUE for the incremental rendering, FALSE to render full frames
+ * @isAutoplay TRUE to let the computer player choose the moves, FALSE to read them from the user
+ * @numOfShips the number of ships on a board bigger than MAX_SIZE
+ * @fleet the fleet of the game, NULL for the standard fleet (points to fleetBuffer otherwise)
+ * @fleetBuffer the fleet from the command line
+ * @savePath the path to save the game to when it ends, NULL to not save it
+ * @resumePath the path of the snapshot to resume the game from, NULL for a new game
+ * @journalPath the path of the journal of the game, NULL for no journal
+ * @viewportSide the side of the window of the viewport rendering, 0 to render the whole board
+ * @moveTimeout the seconds the user has for a move, 0 for no limit
+ * @gameTimeout the seconds the user has for the game, 0 for no limit
+ * @timeoutAction what happens when the time of a move passes
+ */
+typedef struct Options
+{
+    uint64_t seed;
+    int isBatch;
+    const char *batchFile;
+    int isIncremental;
+    int isAutoplay;
+    int numOfShips;
+    const Fleet *fleet;
+    Fleet fleetBuffer;
+    const char *savePath;
+    const char *resumePath;
+    const char *journalPath;
+    int viewportSide;
+    int moveTimeout;
+    int gameTimeout;
+    TimeoutAction timeoutAction;
+} Options;
+
+/**
+ * the journal of the game, NULL for no journal. it is set before the game starts.
+ */
+MoveJournal *gameJournal = NULL;
+
+/**
+ * the turn clock of the game, with no limits until it is started by main.
+ */
+TurnClock turnClock = {0, 0, TIMEOUT_END};
+
 
 
 // ------------------------------ functions -----------------------------
 
+/**
+ * this function starts the turn clock of the game- the time of the game starts now.
+ * @param options : the options of the program
+ */
+void startTurnClock(const Options *options)
+{
+    turnClock.moveNanos = (uint64_t) options->moveTimeout * NANOS_PER_SECOND;
+    turnClock.gameDeadline = (options->gameTimeout == 0) ? 0 :
+                             statsNanos() + (uint64_t) options->gameTimeout * NANOS_PER_SECOND;
+    turnClock.action = options->timeoutAction;
+}
+
+/**
+ * this function sets the deadline of the reader for the next move- the time of a move from now,
+ * or the end of the time of the game if it comes first.
+ * @param reader : the reader of the user input
+ */
+void armTurnClock(LineReader *reader)
+{
+    uint64_t deadline = turnClock.gameDeadline;
+    if (turnClock.moveNanos != 0)
+    {
+        uint64_t moveDeadline = statsNanos() + turnClock.moveNanos;
+        if (deadline == 0 || moveDeadline < deadline)
+        {
+            deadline = moveDeadline;
+        }
+    }
+    setReaderDeadline(reader, deadline);
+}
+
+/**
+ * this function checks if the time of the game passed.
+ * @return TRUE if it passed, FALSE otherwise
+ */
+int isGameTimeOver(void)
+{
+    return (turnClock.gameDeadline != 0 && statsNanos() >= turnClock.gameDeadline) ? TRUE : FALSE;
+}
+
+/**
+ * this function reads the size of the board from a line of the input, and prints why it can't
+ * be parsed if it is not a number.
+ * @param reader : the reader of the input
+ * @param sizeOfBoard : a pointer to the size that will set in the input value
+ * @return TRUE if the line is a number, FALSE otherwise
+ */
+int readSize(LineReader *reader, int *sizeOfBoard)
+{
+    const char *line;
+    int length;
+    ParseResult sizeFlag = readLine(reader, &line, &length);
+    if (sizeFlag == PARSE_OK)
+    {
+        sizeFlag = parseNumber(line, length, sizeOfBoard);
+    }
+    if (sizeFlag != PARSE_OK && sizeFlag != PARSE_END_OF_INPUT && sizeFlag != PARSE_TIMEOUT)
+    {
+        fprintf(stderr, BAD_SIZE_MSG, parseResultMessage(sizeFlag));
+    }
+    return (sizeFlag == PARSE_OK) ? TRUE : FALSE;
+}
+
+/**
+ * this function gets the size of the board from the user
+ * @param sizeOfBoard : a pointer to the size that will set in the input value
+ * @param reader : the reader of the user input
+ * @return TRUE if the size is valid and FALSE otherwise
+ */
+int getSizeOfBoard(int *sizeOfBoard, LineReader *reader)
+{
+    printf(ENTER_SIZE_MSG);
+    fflush(stdout);
+    if (readSize(reader, sizeOfBoard) == FALSE)
+    {
+        return FALSE;
+    }
+    return isValidSize(*sizeOfBoard);
+}
 
 
 /**
  * this function runs the rounds of the game in a loop until the game is over
- * @param gameBoard : the board of the game.
+ * @param game : the game.
+ * @param renderer : the renderer of the board
+ * @param reader : the reader of the user input, NULL to let the computer player choose the moves
+ * @param savePath : the path to save a snapshot of the game to when it ends, NULL to not save it
  */
-void playGame(GameBoard *gameBoard)
+void playGame(Game *game, Renderer *renderer, LineReader *reader, const char *savePath)
 {
     printf(START_GAME_MSG);
-    int gameFlag = TRUE;
+    int gameFlag = (game->status == WIN_GAME) ? WIN_GAME : TRUE; // a resumed game can be over
     while (gameFlag == TRUE)
     {
-        gameFlag = playSingleRound(gameBoard);
+        gameFlag = playSingleRound(game, renderer, reader);
+    }
+    if (savePath != NULL && saveSnapshotFile(game, savePath) == FALSE)
+    {
+        perror(SAVE_ERROR_MSG);
     }
     if (gameFlag == WIN_GAME)
     {
-        endGame(gameBoard);
+        endGame(game, renderer);
         return;
     }
     if (gameFlag == EXIT_GAME)
     {
-        freeGameBoard(gameBoard);
+        freeGame(game);
+    }
+}
+
+
+/**
+ * this function prints the matched massage for the result of a move.
+ * @param result : the result of the move
+ * @param renderer : the renderer of the board
+ */
+void printMoveResult(const MoveResult result, Renderer *renderer)
+{
+    switch (result)
+    {
+        case MOVE_REPEATED:
+            renderMessage(renderer, REPEATED_MOVE_MSG);
+            break;
+        case MOVE_MISS:
+            renderMessage(renderer, MISS_MSG);
+            break;
+        case MOVE_HIT:
+            renderMessage(renderer, HIT_MSG);
+            break;
+        case MOVE_SUNK:
+            renderMessage(renderer, SUNK_MSG);
+            break;
+        default: // the winning move is followed by the game over massage
+            break;
+    }
+}
+
+
+/**
+ * this function gets the move from the user and checks its validation.
+ * @param row : the pointer for the row var that will set in the input value
+ * @param column : the pointer for the col var that will set in the input value
+ * @param gameBoard : the game board.
+ * @param reader : the reader of the user input
+ * @return PARSE_OK for a valid move, PARSE_EXIT to exit, PARSE_END_OF_INPUT when there is no more
+ * input, or the reason the move is not valid
+ */
+ParseResult getMove(int *row, int *column, const GameBoard *gameBoard, LineReader *reader)
+{
+    printf(ENTER_MOVE_MSG);
+    fflush(stdout);
+    const char *line;
+    int length;
+    ParseResult result = readLine(reader, &line, &length);
+    if (result != PARSE_OK)
+    {
+        return result;
     }
+    result = parseMove(line, length, row, column);
+    if (result == PARSE_OK && isIndexInBoard(*row, *column, gameBoard->size) == FALSE)
+    {
+        return PARSE_OUT_OF_BOARD;
+    }
+    return result;
 }
 
+/**
+ * this function lets the computer player choose the move, and shows it as if the user typed it.
+ * @param row : the pointer for the row var that will set in the chosen value
+ * @param column : the pointer for the col var that will set in the chosen value
+ * @param game : the game
+ * @return PARSE_OK for a move, PARSE_END_OF_INPUT if there is no cell left to shoot at
+ */
+ParseResult getComputerMove(int *row, int *column, const Game *game)
+{
+    printf(ENTER_MOVE_MSG);
+    if (chooseShot(game, row, column) == FALSE)
+    {
+        return PARSE_END_OF_INPUT;
+    }
+    printf("%c %d\n", 'a' + *row, *column + 1);
+    return PARSE_OK;
+}
+
+/**
+ * this function takes the action of the turn clock for a move whose time passed. when the time of
+ * the whole game passed the game ends, whatever the action is.
+ * @param row : the pointer for the row var that will set in the move of the computer player
+ * @param column : the pointer for the col var that will set in the move of the computer player
+ * @param game : the game
+ * @param renderer : the renderer of the board
+ * @return PARSE_OK for a move of the computer player, PARSE_EMPTY if the move is skipped,
+ * PARSE_TIMEOUT if the game ends and PARSE_END_OF_INPUT if there is no cell left to shoot at
+ */
+ParseResult takeTimeoutAction(int *row, int *column, const Game *game, Renderer *renderer)
+{
+    if (turnClock.action == TIMEOUT_END || isGameTimeOver() == TRUE)
+    {
+        renderMessage(renderer, TIMEOUT_END_MSG);
+        return PARSE_TIMEOUT;
+    }
+    if (turnClock.action == TIMEOUT_SKIP)
+    {
+        renderMessage(renderer, TIMEOUT_SKIP_MSG);
+        return PARSE_EMPTY;
+    }
+    renderMessage(renderer, TIMEOUT_AI_MSG);
+    return getComputerMove(row, column, game);
+}
 
 /**
  * this function activates a single round in the game.
- * @param gameBoard : the game board
- * @return TRUE if the round finished as planed. EXIT_GAME if the user asked to exit the game
+ * @param game : the game
+ * @param renderer : the renderer of the board
+ * @param reader : the reader of the user input, NULL to let the computer player choose the move
+ * @return TRUE if the round finished as planed (or the move was skipped). EXIT_GAME if the user
+ * asked to exit the game (or the input or the time ended), WIN_GAME if the move won the game
  */
-int playSingleRound(GameBoard *gameBoard)
+int playSingleRound(Game *game, Renderer *renderer, LineReader *reader)
 {
-    printBoard(gameBoard);
+    renderBoard(renderer, &game->gameBoard);
     int row, col;
-    int validMove = getMove(&row, &col, gameBoard);
-    while (validMove == FALSE)
+    if (reader != NULL)
+    { // the time of the move includes the invalid tries
+        armTurnClock(reader);
+    }
+    ParseResult validMove = (reader == NULL) ? getComputerMove(&row, &col, game) :
+                            getMove(&row, &col, &game->gameBoard, reader);
+    while (validMove != PARSE_OK && validMove != PARSE_EXIT && validMove != PARSE_END_OF_INPUT &&
+           validMove != PARSE_TIMEOUT)
     {
-        fprintf(stderr, INVALID_MOVE_MSG);
-        validMove = getMove(&row, &col, gameBoard);
+        fprintf(stderr, INVALID_MOVE_MSG, parseResultMessage(validMove));
+        validMove = getMove(&row, &col, &game->gameBoard, reader);
     }
-    if (validMove == EXIT_GAME)
+    if (validMove == PARSE_TIMEOUT)
+    {
+        validMove = takeTimeoutAction(&row, &col, game, renderer);
+        if (validMove == PARSE_EMPTY)
+        {
+            return TRUE;
+        }
+    }
+    if (validMove != PARSE_OK)
     {
         return EXIT_GAME;
     }
-    return placeMove(row, col, gameBoard); // can return win game flag
-
+    MoveResult result = stepJournaledGame(game, gameJournal, row, col);
+    if (gameJournal != NULL && flushJournal(gameJournal) == FALSE)
+    { // the moves of a player are slow, so every one of them is written right away
+        perror(JOURNAL_ERROR_MSG);
+        close(gameJournal->fd);
+        gameJournal = NULL;
+    }
+    focusViewport(renderer, row, col);
+    printMoveResult(result, renderer);
+    if (result == MOVE_WIN)
+    {
+        return WIN_GAME;
+    }
+    return TRUE;
 }
 
 /**
  * @brief this function terminates the game. prints game over and the final board.
- * @note here we use the free function for the allocation of the game board
- * @param gameBoard : the board of the game
+ * @note here we use the free function for the allocation of the game
+ * @param game : the game
+ * @param renderer : the renderer of the board
  */
-void endGame(GameBoard *gameBoard)
+void endGame(Game *game, Renderer *renderer)
 {
-    printf(END_GAME_MSG);
-    printBoard(gameBoard);
-    freeGameBoard(gameBoard);
+    renderMessage(renderer, END_GAME_MSG);
+    renderBoard(renderer, &game->gameBoard);
+    freeGame(game);
 }
 
 /**
- * this function prints the game board.
- * @param gameBoard : the game board
+ * this function allocates and starts a new game. prints the matched error massage on failure.
+ * @param sizeOfBoard : the size of the board
+ * @param fleet : the fleet of the game, NULL for the standard fleet
+ * @param seed : the seed of the game
+ * @return the game (free it with freeGame and free), or NULL on failure
  */
-void printBoard(const GameBoard *gameBoard)
+Game *createGame(const int sizeOfBoard, const Fleet *fleet, const uint64_t seed)
 {
-    char rowNum = 1;
-    int colNum = 'a';
-    int rowIndex, colIndex;
-    printf(" ");
-    for (rowIndex = 0 ; rowIndex < gameBoard->size ; ++rowIndex) // print the col numbers
+    Game *game = (Game *) malloc(sizeof(Game));
+    if (game == NULL)
     {
-        printf(" %d", rowNum++);
+        fprintf(stderr, OUT_OF_MEMORY_MSG);
+        return NULL;
     }
-    printf("\n");
-    for (rowIndex = 0 ; rowIndex < gameBoard->size ; ++rowIndex)
+    int initFlag = initGame(game, sizeOfBoard, fleet, seed);
+    if (initFlag != TRUE)
     {
-        printf("%c", colNum++); // print the row numbers
-        for (colIndex = 0 ; colIndex < gameBoard->size ; ++colIndex)
-        { // print the status of the cell
-            printf(" %c", gameBoard->board[rowIndex][colIndex].status);
+        if (initFlag == INVALID_SIZE || initFlag == INVALID_FLEET)
+        {
+            fprintf(stderr, initFlag == INVALID_SIZE ? INVALID_SIZE_MSG : INVALID_FLEET_MSG);
+        }
+        else
+        { // the malloc failed or the fleet can't fit
+            fprintf(stderr, initFlag == NO_PLACEMENT ? NO_PLACEMENT_MSG :
+                            initFlag == PLACEMENT_TIMEOUT ? PLACEMENT_TIMEOUT_MSG :
+                            OUT_OF_MEMORY_MSG);
         }
-        printf("\n");
+        free(game);
+        return NULL;
     }
+    return game;
 }
 
+/**
+ * this function allocates a game and resumes it from a snapshot. prints the matched error massage
+ * on failure.
+ * @param path : the path of the snapshot
+ * @return the game (free it with freeGame and free), or NULL on failure
+ */
+Game *resumeSavedGame(const char *path)
+{
+    Game *game = (Game *) malloc(sizeof(Game));
+    if (game == NULL)
+    {
+        fprintf(stderr, OUT_OF_MEMORY_MSG);
+        return NULL;
+    }
+    int loadFlag = loadSnapshotFile(game, path);
+    if (loadFlag != TRUE)
+    {
+        fprintf(stderr, loadFlag == INVALID_SNAPSHOT ? INVALID_SNAPSHOT_MSG : OUT_OF_MEMORY_MSG);
+        free(game);
+        return NULL;
+    }
+    return game;
+}
 
 /**
- * this function receives a char and returns if its a small letter or not
- * @param ch : the char we want to check
- * @return TRUE if the char is a small english letter. otherwise FALSE.
+ * this function starts the journal of a new game (see JOURNAL_FLAG) and sets it as the journal of
+ * the game. prints the reason if it fails.
+ * @param game : the game, before its first move
+ * @param options : the options of the program (the path of the journal and the seed)
+ * @return TRUE if the journal was started, FALSE otherwise
  */
-int isLetter(char ch)
+int startGameJournal(const Game *game, const Options *options)
 {
-    if (ch >= 'a' && ch <= 'z')
+    static MoveJournal journal;
+    int fd = open(options->journalPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || openJournal(&journal, fd, game, options->seed) == FALSE)
     {
-        return TRUE;
+        perror(JOURNAL_ERROR_MSG);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return FALSE;
     }
-    return FALSE;
+    gameJournal = &journal;
+    return TRUE;
 }
 
+/**
+ * this function creates a game on a sparse board (for a size bigger than MAX_SIZE) and prints
+ * the reason if it fails.
+ * @param sizeOfBoard : the size of the board
+ * @param numOfShips : the number of ships
+ * @param fleet : the fleet the ships are taken from, NULL for the standard fleet
+ * @param seed : the seed of the game
+ * @return the game (free it with freeSparseGame and free), NULL on failure
+ */
+SparseGame *createSparseGame(const int sizeOfBoard, const int numOfShips, const Fleet *fleet,
+                             const uint64_t seed)
+{
+    SparseGame *game = (SparseGame *) malloc(sizeof(SparseGame));
+    if (game == NULL)
+    {
+        fprintf(stderr, OUT_OF_MEMORY_MSG);
+        return NULL;
+    }
+    int initFlag = initSparseGame(game, sizeOfBoard, numOfShips, fleet, seed);
+    if (initFlag != TRUE)
+    {
+        fprintf(stderr, initFlag == INVALID_SIZE ? INVALID_SIZE_MSG :
+                        initFlag == INVALID_FLEET ? INVALID_FLEET_MSG :
+                        initFlag == NO_PLACEMENT ? NO_PLACEMENT_MSG : OUT_OF_MEMORY_MSG);
+        free(game);
+        return NULL;
+    }
+    return game;
+}
 
 /**
- * this function checks if a given coordinate is legal according to the size of the board.
- * @param row : the row index
- * @param col : the column index
- * @param sizeOfBoard : the size of the game board
- * @return TRUE for the case that the coordinate is valid. otherwise FALSE.
+ * this function renders the window of the viewport rendering around a move and the overview of
+ * the board, for the end of the batch mode.
+ * @param game : the game, NULL for a sparse game
+ * @param sparseGame : the sparse game (if game is NULL)
+ * @param side : the side of the window
+ * @param row : the row of the move, -1 for the center of the board
+ * @param col : the column of the move
  */
-int isIndexInBoard(const int row, const int col, const int sizeOfBoard)
+void renderLastWindow(const Game *game, const SparseGame *sparseGame, const int side,
+                      const int row, const int col)
 {
-    if (row >= MIN_INDEX && row < sizeOfBoard && col >= MIN_INDEX && col < sizeOfBoard)
+    static Renderer renderer;
+    BoardView view;
+    initRenderer(&renderer, STDOUT_FILENO, FALSE);
+    setViewport(&renderer, side);
+    focusViewport(&renderer, row, col);
+    if (game != NULL)
+    {
+        viewGameBoard(&game->gameBoard, &view);
+    }
+    else
     {
-        return TRUE;
+        viewSparseBoard(&sparseGame->board, &view);
     }
-    return FALSE;
+    renderView(&renderer, &view);
 }
 
+/**
+ * this function runs the game in the batch mode: the first line of the input is the size of the
+ * board and every other line is a move. for every move it prints its result code (one of
+ * MOVE_CODES) in its own line, and at the end a summary of the game. the output is fully buffered
+ * and the board is never printed, so long move scripts run as fast as the engine.
+ * a board bigger than MAX_SIZE is a sparse board (see sparse.h) with numOfShips ships.
+ * @param reader : the reader of the moves input
+ * @param options : the options of the program (the seed, the fleet and the number of ships on a
+ * sparse board)
+ * @return 0 if the script ran, 1 if the game could not start
+ */
+int runBatch(LineReader *reader, const Options *options)
+{
+    const char *line;
+    int length, sizeOfBoard;
+    if (readSize(reader, &sizeOfBoard) == FALSE)
+    {
+        fprintf(stderr, INVALID_SIZE_MSG);
+        return 1;
+    }
+    Game *game = NULL;
+    SparseGame *sparseGame = NULL;
+    if (sizeOfBoard > MAX_SIZE)
+    {
+        sparseGame = createSparseGame(sizeOfBoard, options->numOfShips, options->fleet,
+                                      options->seed);
+    }
+    else
+    {
+        game = createGame(sizeOfBoard, options->fleet, options->seed);
+        if (game != NULL && options->journalPath != NULL && startGameJournal(game, options) == FALSE)
+        {
+            freeGame(game);
+            free(game);
+            return 1;
+        }
+    }
+    if (game == NULL && sparseGame == NULL)
+    {
+        return 1;
+    }
+    static char outputBuffer[BATCH_OUTPUT_BUFFER];
+    setvbuf(stdout, outputBuffer, _IOFBF, sizeof(outputBuffer));
+    int row, col;
+    int lastRow = -1, lastCol = -1;
+    ParseResult lineFlag;
+    while ((lineFlag = readLine(reader, &line, &length)) != PARSE_END_OF_INPUT)
+    {
+        if (lineFlag == PARSE_OK)
+        {
+            lineFlag = parseMove(line, length, &row, &col);
+        }
+        if (lineFlag == PARSE_EXIT)
+        {
+            break;
+        }
+        MoveResult result = MOVE_INVALID;
+        if (lineFlag == PARSE_OK)
+        {
+            result = (game != NULL) ? stepJournaledGame(game, gameJournal, row, col) :
+                     stepSparseGame(sparseGame, row, col);
+            if (gameJournal != NULL && gameJournal->error != 0)
+            { // the moves from here on can't be journaled, say so right away
+                errno = gameJournal->error;
+                perror(JOURNAL_ERROR_MSG);
+                close(gameJournal->fd);
+                gameJournal = NULL;
+            }
+            lastRow = row;
+            lastCol = col;
+        }
+        putchar(MOVE_CODES[result]);
+        putchar('\n');
+    }
+    if (game != NULL && gameJournal != NULL && (flushJournal(gameJournal) == FALSE ||
+                                                close(gameJournal->fd) != 0))
+    {
+        perror(JOURNAL_ERROR_MSG);
+    }
+    GameResult summary = (game != NULL) ? gameResult(game) : sparseGameResult(sparseGame);
+    printf("moves %d hits %d sunk %d/%d %s\n", summary.numOfMoves, summary.numOfHits,
+           summary.sunkShips, (game != NULL) ? game->ships.numOfShips :
+                               sparseGame->ships.numOfShips,
+           summary.status == WIN_GAME ? "won" : "not finished");
+    if (options->viewportSide > 0)
+    {
+        renderLastWindow(game, sparseGame, options->viewportSide, lastRow, lastCol);
+    }
+    fflush(stdout);
+    if (game != NULL)
+    {
+        freeGame(game);
+        free(game);
+    }
+    else
+    {
+        freeSparseGame(sparseGame);
+        free(sparseGame);
+    }
+    return 0;
+}
 
 /**
- * this function gets the move from the user and checks its validation.
- * @param row : the pointer for the row var that will set in the input value
- * @param column : the pointer for the col var that will set in the input value
- * @param gameBoard : the game board.
- * @return FALSE in case the input is not valid, TRUE for valid input, EXIT_GAME (-1) to exit
+ * this function reads a fleet file (see FLEET_FILE_FLAG).
+ * @param path : the path of the file
+ * @param fleet : will be set to the fleet
+ * @return PARSE_OK for a fleet, PARSE_END_OF_INPUT if the file can't be read, PARSE_LINE_TOO_LONG
+ * if it is bigger than FLEET_FILE_CAPACITY, or the reason the fleet is not valid
  */
-int getMove(int *row, int *column, GameBoard *gameBoard)
+ParseResult readFleetFile(const char *path, Fleet *fleet)
 {
-    printf(ENTER_MOVE_MSG);
-    char inputRow[10];
-    char inputCol[10];
-    scanf("%s", inputRow);
-    if (strcmp(inputRow, EXIT_CALL) == TRUE)
-    { // we need to exit the program
-        return EXIT_GAME;
+    char text[FLEET_FILE_CAPACITY];
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return PARSE_END_OF_INPUT;
     }
-    if (strlen(inputRow) != 1)
-    { // the input is not a single char
-        return FALSE;
+    int length = 0;
+    ssize_t readBytes;
+    while (length < FLEET_FILE_CAPACITY &&
+           (readBytes = read(fd, text + length, (size_t) (FLEET_FILE_CAPACITY - length))) > 0)
+    {
+        length += (int) readBytes;
     }
-    scanf("%s", inputCol); // get the col coordinate
-    int currCol = atoi(inputCol);
-    char rowInLetter = inputRow[0];
-    if (isLetter(rowInLetter) == FALSE)
-    { // the input is not a letter follows by a number.
-        return FALSE;
+    close(fd);
+    if (length == FLEET_FILE_CAPACITY)
+    {
+        return PARSE_LINE_TOO_LONG;
     }
-    *row = rowInLetter - 'a';
-    *column = currCol - 1;
-    return isIndexInBoard(*row, *column, gameBoard->size); // checks if the index is valid
+    return parseFleet(text, length, fleet);
 }
 
 /**
- * this function free the memory allocated for the game board.
- * @param gameBoard : this is the board of the game.
+ * this function reads the options of the program from the command line. with no seed given, the
+ * seed is made from the time and the process id so every run gets a new layout.
+ * @param argc : the number of the arguments
+ * @param argv : the arguments
+ * @param options : the options that will be set
+ * @return TRUE if the arguments are valid, FALSE otherwise
  */
-void freeGameBoard(GameBoard *gameBoard)
+int parseArguments(const int argc, char *argv[], Options *options)
 {
+    options->seed = (uint64_t) time(NULL) ^ ((uint64_t) getpid() << 32);
+    options->isBatch = FALSE;
+    options->batchFile = NULL;
+    options->isIncremental = FALSE;
+    options->isAutoplay = FALSE;
+    options->numOfShips = NUM_OF_SHIPS;
+    options->fleet = NULL;
+    options->savePath = NULL;
+    options->resumePath = NULL;
+    options->journalPath = NULL;
+    options->viewportSide = 0;
+    options->moveTimeout = 0;
+    options->gameTimeout = 0;
+    options->timeoutAction = TIMEOUT_END;
     int i;
-    for (i = 0 ; i < gameBoard->size ; i++)
+    for (i = 1 ; i < argc ; ++i)
     {
-        free(gameBoard->board[i]);
-        gameBoard->board[i] = NULL;
+        if (strcmp(argv[i], SEED_FLAG) == 0 && i + 1 < argc)
+        {
+            char *end;
+            options->seed = strtoull(argv[++i], &end, 0);
+            if (*argv[i] == '\0' || *end != '\0')
+            { // not a number
+                return FALSE;
+            }
+        }
+        else if (strcmp(argv[i], BATCH_FLAG) == 0)
+        {
+            options->isBatch = TRUE;
+            if (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0)
+            {
+                options->batchFile = argv[++i];
+            }
+        }
+        else if (strcmp(argv[i], INCREMENTAL_FLAG) == 0)
+        {
+            options->isIncremental = TRUE;
+        }
+        else if (strcmp(argv[i], AUTOPLAY_FLAG) == 0)
+        {
+            options->isAutoplay = TRUE;
+        }
+        else if (strcmp(argv[i], SHIPS_FLAG) == 0 && i + 1 < argc)
+        {
+            if (sscanf(argv[++i], "%d", &options->numOfShips) != 1 || options->numOfShips < 1)
+            {
+                return FALSE;
+            }
+        }
+        else if (strcmp(argv[i], SAVE_FLAG) == 0 && i + 1 < argc)
+        {
+            options->savePath = argv[++i];
+        }
+        else if (strcmp(argv[i], RESUME_FLAG) == 0 && i + 1 < argc)
+        {
+            options->resumePath = argv[++i];
+        }
+        else if (strcmp(argv[i], JOURNAL_FLAG) == 0 && i + 1 < argc)
+        {
+            options->journalPath = argv[++i];
+        }
+        else if (strcmp(argv[i], VIEWPORT_FLAG) == 0 && i + 1 < argc)
+        {
+            if (sscanf(argv[++i], "%d", &options->viewportSide) != 1 ||
+                options->viewportSide < 1 || options->viewportSide > RENDER_MAX_VIEWPORT)
+            {
+                return FALSE;
+            }
+        }
+        else if ((strcmp(argv[i], MOVE_TIMEOUT_FLAG) == 0 ||
+                  strcmp(argv[i], GAME_TIMEOUT_FLAG) == 0) && i + 1 < argc)
+        {
+            int *timeout = (strcmp(argv[i], MOVE_TIMEOUT_FLAG) == 0) ? &options->moveTimeout :
+                           &options->gameTimeout;
+            if (sscanf(argv[++i], "%d", timeout) != 1 || *timeout < 1)
+            {
+                return FALSE;
+            }
+        }
+        else if (strcmp(argv[i], ON_TIMEOUT_FLAG) == 0 && i + 1 < argc)
+        {
+            i++;
+            options->timeoutAction = NUM_OF_TIMEOUT_ACTIONS;
+            int action;
+            for (action = 0 ; action < NUM_OF_TIMEOUT_ACTIONS ; ++action)
+            {
+                if (strcmp(argv[i], TIMEOUT_ACTION_NAMES[action]) == 0)
+                {
+                    options->timeoutAction = (TimeoutAction) action;
+                }
+            }
+            if (options->timeoutAction == NUM_OF_TIMEOUT_ACTIONS)
+            {
+                return FALSE;
+            }
+        }
+        else if (strcmp(argv[i], STATS_FLAG) == 0 && i + 1 < argc)
+        {
+            if (reportStatsAtExit(argv[++i]) == FALSE)
+            {
+                return FALSE;
+            }
+        }
+        else if ((strcmp(argv[i], FLEET_FLAG) == 0 || strcmp(argv[i], FLEET_FILE_FLAG) == 0) &&
+                 i + 1 < argc && options->fleet == NULL)
+        {
+            ParseResult fleetFlag;
+            if (strcmp(argv[i], FLEET_FLAG) == 0)
+            {
+                fleetFlag = parseFleet(argv[i + 1], (int) strlen(argv[i + 1]),
+                                       &options->fleetBuffer);
+            }
+            else
+            {
+                fleetFlag = readFleetFile(argv[i + 1], &options->fleetBuffer);
+                if (fleetFlag == PARSE_END_OF_INPUT)
+                {
+                    perror(FLEET_FILE_ERROR_MSG);
+                    return FALSE;
+                }
+            }
+            if (fleetFlag != PARSE_OK)
+            {
+                fprintf(stderr, BAD_FLEET_MSG, parseResultMessage(fleetFlag));
+                return FALSE;
+            }
+            options->fleet = &options->fleetBuffer;
+            i++;
+        }
+        else
+        {
+            return FALSE;
+        }
+    }
+    if (options->journalPath != NULL && options->resumePath != NULL)
+    { // a journal starts from the seed of a new game
+        return FALSE;
     }
-    free(gameBoard->board);
-    gameBoard->board = NULL;
+    return TRUE;
 }
 
 
 /**
  * the main function that runs the game.
+ * @param argc : the number of the arguments
+ * @param argv : the arguments. an optional "--seed <number>" for a reproducible game, an
+ * optional "--incremental" for the incremental rendering, an optional "--autoplay" to let the
+ * computer play and an optional "--batch [<moves file>]" for the batch mode (with an optional
+ * "--ships <number>" for the number of ships on a board bigger than MAX_SIZE). the fleet of the
+ * game is the standard fleet, or the one given with "--fleet <lengths>" or "--fleet-file <path>".
+ * an interactive game can be saved with "--save <path>" and resumed with "--resume <path>", and
+ * the moves of a new game can be written to a journal with "--journal <path>". "--stats text" or
+ * "--stats json" writes the stats of the hot paths to the standard error at exit, and
+ * "--viewport <side>" renders a window of the board and an overview instead of the whole board.
+ * "--move-timeout <seconds>" and "--game-timeout <seconds>" limit the time of the user for every
+ * move and for the game, and "--on-timeout skip|ai|end" sets what happens to a move that is late
  * @return 0 for a standard exit from the program, 1 for an exit because of an error in the program
  */
-int main()
+int main(int argc, char *argv[])
 {
-    GameBoard *gameBoard = (GameBoard *) malloc(sizeof(GameBoard));
-    if (getSizeOfBoard(gameBoard) == FALSE)
+    Options options;
+    if (parseArguments(argc, argv, &options) == FALSE)
     {
-        fprintf(stderr, INVALID_SIZE_MSG);
+        fprintf(stderr, USAGE_MSG);
         return 1;
     }
+    static LineReader reader;
+    if (options.isBatch == TRUE)
+    {
+        int fd = (options.batchFile == NULL) ? STDIN_FILENO : open(options.batchFile, O_RDONLY);
+        if (fd < 0)
+        {
+            perror(OPEN_FILE_ERROR_MSG);
+            return 1;
+        }
+        initLineReader(&reader, fd);
+        int exitCode = runBatch(&reader, &options);
+        if (fd != STDIN_FILENO)
+        {
+            close(fd);
+        }
+        return exitCode;
+    }
 
-    if (buildGameBoard(gameBoard) == FALSE)
-    { // the malloc failed
-        fprintf(stderr, OUT_OF_MEMORY_MSG);
+    initLineReader(&reader, STDIN_FILENO);
+    startTurnClock(&options);
+    Game *game;
+    if (options.resumePath != NULL)
+    {
+        game = resumeSavedGame(options.resumePath);
+    }
+    else
+    {
+        int sizeOfBoard;
+        armTurnClock(&reader);
+        if (getSizeOfBoard(&sizeOfBoard, &reader) == FALSE)
+        {
+            fprintf(stderr, "%s", (reader.deadline != 0 && statsNanos() >= reader.deadline) ?
+                                  TIMEOUT_END_MSG : INVALID_SIZE_MSG);
+            return 1;
+        }
+        game = createGame(sizeOfBoard, options.fleet, options.seed);
+        if (game != NULL && options.journalPath != NULL && startGameJournal(game, &options) == FALSE)
+        {
+            freeGame(game);
+            free(game);
+            return 1;
+        }
+    }
+    if (game == NULL)
+    {
         return 1;
     }
-    playGame(gameBoard);
-    free(gameBoard);
+    static Renderer renderer;
+    initRenderer(&renderer, STDOUT_FILENO, options.isIncremental);
+    setViewport(&renderer, options.viewportSide);
+    playGame(game, &renderer, (options.isAutoplay == TRUE) ? NULL : &reader, options.savePath);
+    if (gameJournal != NULL)
+    {
+        close(gameJournal->fd);
+    }
+    free(game);
     return 0;
 }
@@ -0,0 +1,555 @@
+// ------------------------------ includes ------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "battleships.h"
+#include "input.h"
+#include "stats.h"
+#include "pool.h"
+#include "selfplay.h"
+
+/**
+ * @file battleships_genboards.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the bulk board generator. it makes the layouts of a lot of boards on all the cores and
+ * writes them to a file of fixed size records.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * the file is a BoardsHeader, the lengths of the ships of the fleet (one byte each), zero bytes
+ * up to headerBytes and then count records of recordBytes bytes. the record of board number i is
+ * at headerBytes + i * recordBytes and has 3 bytes for every ship of the fleet (in the order of
+ * the fleet)- the row and the column of its first cell and its orientation (0 along the row, 1
+ * along the column). board number i is the layout of the seed firstSeed + i, so the file doesn't
+ * depend on the number of threads.
+ * the output file is mapped to memory and every thread writes its records right in their place,
+ * so the records are in order with no buffer and no allocation for a board. the boards are cut to
+ * chunks that the threads take with an atomic counter (every board costs about the same).
+ * a layout is drawn like the fleet kernels draw it (every ship is uniform over its legal
+ * placements given the ships before it), with a table of the bitboards of all the placements of
+ * every length that is made once: a random placement that collides with the ships already placed
+ * is drawn again, and a ship that keeps colliding picks one of its legal placements from the
+ * whole table (like FIND_PLACEMENT_KERNEL). a ship with no legal placement draws the whole layout
+ * again, like a pass of the kernels. after LAYOUT_DRAWS such layouts the layout is made by the
+ * engine instead (restartGame- more passes of its kernel and then its backtracking placer), on a
+ * Game of the thread that is allocated once. so the layouts have the same distribution as the
+ * layouts of the engine.
+ * Input  : the options from the command line
+ * Process: makes the layouts
+ * Output : the file of the layouts and the speed
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the first bytes of a boards file ("BSGB" in the file) and the version of the layout.
+ */
+#define BOARDS_MAGIC 0x42475342u
+#define BOARDS_VERSION 1
+
+/**
+ * the bytes of a ship in a record.
+ */
+#define SHIP_RECORD_BYTES 3
+
+/**
+ * the number of boards in a chunk- the unit of work of a thread.
+ */
+#define CHUNK_BOARDS 4096
+
+/**
+ * the number of random draws of a ship before its legal placements are listed, and the number of
+ * layouts that are drawn before the layout is left to the engine.
+ */
+#define SHIP_DRAWS 32
+#define LAYOUT_DRAWS 16
+
+/**
+ * the largest number of words of the bitboard of a board.
+ */
+#define MAX_BOARD_WORDS BITBOARD_WORDS
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the command line arguments are not valid
+ */
+const char *GENBOARDS_USAGE_MSG =
+        "usage: ex2_genboards --out <path> [--size <number>] [--fleet <lengths>] "
+        "[--count <number>] [--seed <first seed>] [--threads <number>]\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the output file can't be made
+ */
+const char *GENBOARDS_OUTPUT_ERROR_MSG = "can't make the output file";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the threads can't start
+ */
+const char *GENBOARDS_START_ERROR_MSG = "failed to start the threads";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the fleet could not be placed on the board
+ */
+const char *GENBOARDS_PLACEMENT_ERROR_MSG = "the fleet could not be placed on a %d board\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the search for a layout of the fleet gave up
+ */
+const char *GENBOARDS_TIMEOUT_ERROR_MSG =
+        "no layout of the fleet was found in time on a %d board, try another seed\n";
+
+/**
+ * the default options.
+ */
+const uint64_t DEFAULT_BOARDS = 1000000;
+const int DEFAULT_BOARD_SIZE = 10;
+
+/**
+ * @brief the head of a boards file.
+ * @magic BOARDS_MAGIC
+ * @version BOARDS_VERSION
+ * @size the size of the boards
+ * @numOfShips the number of ships in the fleet
+ * @headerBytes the offset of the first record
+ * @recordBytes the size of a record
+ * @count the number of records
+ * @firstSeed the seed of the first board
+ */
+typedef struct BoardsHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint8_t size;
+    uint8_t numOfShips;
+    uint32_t headerBytes;
+    uint32_t recordBytes;
+    uint64_t count;
+    uint64_t firstSeed;
+} BoardsHeader;
+
+/**
+ * @brief all the placements of a ship of a single length on the board.
+ * @numOfPlacements the number of placements
+ * @masks the bitboards of the placements, numOfWords words each
+ * @codes the row, the column and the orientation of every placement (a ship record)
+ */
+typedef struct PlacementTable
+{
+    uint32_t numOfPlacements;
+    uint64_t *masks;
+    unsigned char *codes;
+} PlacementTable;
+
+/**
+ * @brief the options of the generator.
+ * @outPath the path of the output file
+ * @size the size of the boards
+ * @count the number of boards
+ * @seed the seed of the first board
+ * @numOfThreads the number of threads
+ * @fleet the fleet of the boards
+ */
+typedef struct GenboardsOptions
+{
+    const char *outPath;
+    int size;
+    uint64_t count;
+    uint64_t seed;
+    int numOfThreads;
+    Fleet fleet;
+} GenboardsOptions;
+
+/**
+ * @brief a generator thread.
+ * @thread the thread
+ * @numOfFallbacks the number of layouts that were left to the engine
+ */
+typedef struct Generator
+{
+    pthread_t thread;
+    uint64_t numOfFallbacks;
+} Generator;
+
+
+/**
+ * the options, the placement tables of the ships, the output and the next chunk. they are set
+ * before the threads start (the next chunk is only changed with atomic adds).
+ */
+GenboardsOptions options;
+int numOfWords;
+PlacementTable tables[MAX_SHIP_LENGTH + 1];
+const PlacementTable *shipTables[MAX_FLEET_SHIPS];
+unsigned char *records;
+size_t recordBytes;
+uint64_t nextChunk = 0;
+int placementFlag = TRUE;
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function makes the placement table of every length of the fleet.
+ * @return TRUE on success, FALSE if out of memory
+ */
+int buildTables(void)
+{
+    int size = options.size;
+    int i, direction, row, col;
+    numOfWords = (size * size + BITBOARD_WORD_BITS - 1) / BITBOARD_WORD_BITS;
+    for (i = 0 ; i < options.fleet.numOfShips ; ++i)
+    {
+        int length = options.fleet.ships[i].length;
+        PlacementTable *table = &tables[length];
+        shipTables[i] = table;
+        if (table->masks != NULL)
+        { // another ship of the same length
+            continue;
+        }
+        int numOfDirections = (length == 1) ? 1 : NUM_OF_ORIENTATIONS;
+        uint32_t maxPlacements = (uint32_t) (numOfDirections * size * (size - length + 1));
+        table->masks = (uint64_t *) calloc(maxPlacements * numOfWords, sizeof(uint64_t));
+        table->codes = (unsigned char *) malloc(maxPlacements * SHIP_RECORD_BYTES);
+        if (table->masks == NULL || table->codes == NULL)
+        {
+            return FALSE;
+        }
+        for (direction = 0 ; direction < numOfDirections ; ++direction)
+        {
+            for (row = 0 ; row + (length - 1) * direction < size ; ++row)
+            {
+                for (col = 0 ; col + (length - 1) * (1 - direction) < size ; ++col)
+                {
+                    BitBoard mask;
+                    bitBoardSegment(&mask, row * size + col, (direction == 0) ? 1 : size, length);
+                    memcpy(table->masks + table->numOfPlacements * numOfWords, mask.words,
+                           numOfWords * sizeof(uint64_t));
+                    unsigned char *code = table->codes + table->numOfPlacements * SHIP_RECORD_BYTES;
+                    code[0] = (unsigned char) row;
+                    code[1] = (unsigned char) col;
+                    code[2] = (unsigned char) direction;
+                    table->numOfPlacements++;
+                }
+            }
+        }
+    }
+    return TRUE;
+}
+
+/**
+ * DRAW_LAYOUT_KERNEL defines a function that draws a layout of the fleet with the placement
+ * tables and writes its record:
+ * int name(Rng *rng, unsigned char *record)
+ * it returns TRUE if the layout was drawn, FALSE if every layout had a ship with no legal
+ * placement (a dense board).
+ * WORDS is the expression of the number of words of the bitboard of the board- a kernel with a
+ * constant WORDS has its overlap checks unrolled.
+ */
+#define DRAW_LAYOUT_KERNEL(name, WORDS) \
+int name(Rng *rng, unsigned char *record) \
+{ \
+    const int words = (WORDS); \
+    uint32_t legal[NUM_OF_ORIENTATIONS * BITBOARD_MAX_SIDE * BITBOARD_MAX_SIDE]; \
+    int layout, ship, draw, w; \
+    for (layout = 0 ; layout < LAYOUT_DRAWS ; ++layout) \
+    { \
+        uint64_t occupied[MAX_BOARD_WORDS] = {0}; \
+        for (ship = 0 ; ship < options.fleet.numOfShips ; ++ship) \
+        { \
+            const PlacementTable *table = shipTables[ship]; \
+            uint32_t placement = 0, candidate; \
+            uint64_t collision = 1; \
+            for (draw = 0 ; draw < SHIP_DRAWS && collision != 0 ; ++draw) \
+            { \
+                placement = rngBounded(rng, table->numOfPlacements); \
+                const uint64_t *mask = table->masks + placement * words; \
+                collision = 0; \
+                for (w = 0 ; w < words ; ++w) \
+                { \
+                    collision |= mask[w] & occupied[w]; \
+                } \
+            } \
+            if (collision != 0) \
+            { /* a crowded board, pick one of the legal placements */ \
+                uint32_t numOfLegal = 0; \
+                for (candidate = 0 ; candidate < table->numOfPlacements ; ++candidate) \
+                { \
+                    const uint64_t *mask = table->masks + candidate * words; \
+                    collision = 0; \
+                    for (w = 0 ; w < words ; ++w) \
+                    { \
+                        collision |= mask[w] & occupied[w]; \
+                    } \
+                    if (collision == 0) \
+                    { \
+                        legal[numOfLegal++] = candidate; \
+                    } \
+                } \
+                if (numOfLegal == 0) \
+                { /* no room for the ship, draw the whole layout again */ \
+                    break; \
+                } \
+                placement = legal[rngBounded(rng, numOfLegal)]; \
+            } \
+            const uint64_t *mask = table->masks + placement * words; \
+            for (w = 0 ; w < words ; ++w) \
+            { \
+                occupied[w] |= mask[w]; \
+            } \
+            memcpy(record + ship * SHIP_RECORD_BYTES, \
+                   table->codes + placement * SHIP_RECORD_BYTES, SHIP_RECORD_BYTES); \
+        } \
+        if (ship == options.fleet.numOfShips) \
+        { \
+            return TRUE; \
+        } \
+    } \
+    return FALSE; \
+}
+
+/**
+ * the kernels: the generic one, the one of the boards up to 8x8 (a word) and the one of the
+ * boards up to 11x11 (two words).
+ */
+DRAW_LAYOUT_KERNEL(drawLayout, numOfWords)
+DRAW_LAYOUT_KERNEL(drawLayout1, 1)
+DRAW_LAYOUT_KERNEL(drawLayout2, 2)
+
+/**
+ * this function writes the layout of a game to a record.
+ * @param game : the game
+ * @param record : the record
+ */
+void writeGameRecord(const Game *game, unsigned char *record)
+{
+    int i;
+    for (i = 0 ; i < game->ships.numOfShips ; ++i)
+    {
+        record[i * SHIP_RECORD_BYTES] = (unsigned char) game->ships.row[i];
+        record[i * SHIP_RECORD_BYTES + 1] = (unsigned char) game->ships.column[i];
+        record[i * SHIP_RECORD_BYTES + 2] = game->ships.orientation[i];
+    }
+}
+
+/**
+ * this function is the main function of a generator thread.
+ * @param arg : the Generator of the thread
+ * @return NULL
+ */
+void *runGenerator(void *arg)
+{
+    Generator *generator = (Generator *) arg;
+    int (*draw)(Rng *rng, unsigned char *record) = (numOfWords == 1) ? drawLayout1 :
+                                                   (numOfWords == 2) ? drawLayout2 : drawLayout;
+    Game game; // for the layouts that are left to the engine
+    int hasGame = FALSE;
+    uint64_t board;
+    while (__atomic_load_n(&placementFlag, __ATOMIC_RELAXED) == TRUE &&
+           (board = __atomic_fetch_add(&nextChunk, 1, __ATOMIC_RELAXED) * CHUNK_BOARDS) <
+           options.count)
+    {
+        uint64_t end = (board + CHUNK_BOARDS < options.count) ? board + CHUNK_BOARDS :
+                       options.count;
+        unsigned char *record = records + board * recordBytes;
+        for ( ; board < end ; ++board, record += recordBytes)
+        {
+            Rng rng;
+            rngSeed(&rng, options.seed + board);
+            if (draw(&rng, record) == TRUE)
+            {
+                continue;
+            }
+            int placeFlag = (hasGame == TRUE) ? restartGame(&game, options.seed + board) :
+                            initGame(&game, options.size, &options.fleet, options.seed + board);
+            hasGame = (hasGame == TRUE || placeFlag == TRUE) ? TRUE : FALSE; // initGame frees on failure
+            if (placeFlag != TRUE)
+            {
+                __atomic_store_n(&placementFlag, placeFlag, __ATOMIC_RELAXED);
+                break;
+            }
+            writeGameRecord(&game, record);
+            generator->numOfFallbacks++;
+        }
+    }
+    if (hasGame == TRUE)
+    {
+        freeGame(&game);
+    }
+    drainBoardPool();
+    return NULL;
+}
+
+/**
+ * this function reads the options of the generator from the command line.
+ * @param argc : the number of the arguments
+ * @param argv : the arguments
+ * @return TRUE if the arguments are valid, FALSE otherwise
+ */
+int parseGenboardsArguments(const int argc, char *argv[])
+{
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    options.outPath = NULL;
+    options.size = DEFAULT_BOARD_SIZE;
+    options.count = DEFAULT_BOARDS;
+    options.seed = (uint64_t) time(NULL) ^ ((uint64_t) getpid() << 32);
+    options.numOfThreads = (processors < 1) ? 1 : (processors > MAX_THREADS) ? MAX_THREADS :
+                                                 (int) processors;
+    options.fleet = standardFleet;
+    uint64_t number;
+    int i;
+    for (i = 1 ; i + 1 < argc ; i += 2)
+    {
+        const char *value = argv[i + 1];
+        if (strcmp(argv[i], "--out") == 0)
+        {
+            options.outPath = value;
+        }
+        else if (strcmp(argv[i], "--fleet") == 0)
+        {
+            if (parseFleet(value, (int) strlen(value), &options.fleet) != PARSE_OK)
+            {
+                return FALSE;
+            }
+        }
+        else if (parseCount(value, &number) == FALSE)
+        {
+            return FALSE;
+        }
+        else if (strcmp(argv[i], "--count") == 0 && number > 0)
+        {
+            options.count = number;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && number > 0 && number <= MAX_THREADS)
+        {
+            options.numOfThreads = (int) number;
+        }
+        else if (strcmp(argv[i], "--size") == 0 && isValidSize((int) number) == TRUE &&
+                 number <= BITBOARD_MAX_SIDE)
+        {
+            options.size = (int) number;
+        }
+        else if (strcmp(argv[i], "--seed") == 0)
+        {
+            options.seed = number;
+        }
+        else
+        {
+            return FALSE;
+        }
+    }
+    return (i == argc && options.outPath != NULL &&
+            isValidFleet(&options.fleet, options.size) == TRUE) ? TRUE : FALSE;
+}
+
+/**
+ * this function makes the output file at its full size and maps it to memory, with its header.
+ * @param fd : will be set to the file
+ * @param mapped : will be set to the mapped file
+ * @param length : will be set to the length of the file
+ * @return TRUE on success, FALSE otherwise
+ */
+int mapOutput(int *fd, unsigned char **mapped, size_t *length)
+{
+    BoardsHeader header;
+    memset(&header, 0, sizeof(BoardsHeader));
+    header.magic = BOARDS_MAGIC;
+    header.version = BOARDS_VERSION;
+    header.size = (uint8_t) options.size;
+    header.numOfShips = (uint8_t) options.fleet.numOfShips;
+    header.headerBytes = (uint32_t) ((sizeof(BoardsHeader) + options.fleet.numOfShips + 7) &
+                                     ~(size_t) 7);
+    header.recordBytes = (uint32_t) recordBytes;
+    header.count = options.count;
+    header.firstSeed = options.seed;
+    *length = header.headerBytes + options.count * recordBytes;
+    *fd = open(options.outPath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (*fd < 0 || ftruncate(*fd, (off_t) *length) != 0)
+    {
+        return FALSE;
+    }
+    *mapped = mmap(NULL, *length, PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 0);
+    if (*mapped == MAP_FAILED)
+    {
+        return FALSE;
+    }
+    memcpy(*mapped, &header, sizeof(BoardsHeader));
+    int i;
+    for (i = 0 ; i < options.fleet.numOfShips ; ++i)
+    {
+        (*mapped)[sizeof(BoardsHeader) + i] = (unsigned char) options.fleet.ships[i].length;
+    }
+    records = *mapped + header.headerBytes;
+    return TRUE;
+}
+
+/**
+ * the main function of the generator.
+ * @param argc : the number of the arguments
+ * @param argv : the arguments (see GENBOARDS_USAGE_MSG)
+ * @return 0 on success, 1 if the arguments are not valid or the generation failed
+ */
+int main(int argc, char *argv[])
+{
+    if (parseGenboardsArguments(argc, argv) == FALSE)
+    {
+        fprintf(stderr, GENBOARDS_USAGE_MSG);
+        return 1;
+    }
+    recordBytes = (size_t) options.fleet.numOfShips * SHIP_RECORD_BYTES;
+    int fd;
+    unsigned char *mapped;
+    size_t length;
+    if (buildTables() == FALSE || mapOutput(&fd, &mapped, &length) == FALSE)
+    {
+        perror(GENBOARDS_OUTPUT_ERROR_MSG);
+        return 1;
+    }
+    static Generator generators[MAX_THREADS];
+    uint64_t start = statsNanos();
+    int i;
+    for (i = 0 ; i < options.numOfThreads ; ++i)
+    {
+        if (pthread_create(&generators[i].thread, NULL, runGenerator, &generators[i]) != 0)
+        {
+            perror(GENBOARDS_START_ERROR_MSG);
+            return 1;
+        }
+    }
+    uint64_t numOfFallbacks = 0;
+    for (i = 0 ; i < options.numOfThreads ; ++i)
+    {
+        pthread_join(generators[i].thread, NULL);
+        numOfFallbacks += generators[i].numOfFallbacks;
+    }
+    double seconds = (double) (statsNanos() - start) / 1e9;
+    munmap(mapped, length);
+    close(fd);
+    if (placementFlag != TRUE)
+    {
+        fprintf(stderr, (placementFlag == PLACEMENT_TIMEOUT) ? GENBOARDS_TIMEOUT_ERROR_MSG :
+                        GENBOARDS_PLACEMENT_ERROR_MSG, options.size);
+        unlink(options.outPath);
+        return 1;
+    }
+    printf("boards  %" PRIu64 " of size %d, %d threads, %.3f s (%.0f boards/s)\n", options.count,
+           options.size, options.numOfThreads, seconds, (double) options.count / seconds);
+    printf("records %zu bytes, %" PRIu64 " layouts left to the engine\n", recordBytes,
+           numOfFallbacks);
+    return 0;
+}
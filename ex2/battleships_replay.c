@@ -0,0 +1,457 @@
+// ------------------------------ includes ------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "battleships.h"
+#include "journal.h"
+#include "writer.h"
+
+/**
+ * @file battleships_replay.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the journal replay tool. it plays a move journal (see journal.h) again on the engine and
+ * checks that every move gets the result that was recorded.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * the journal is mapped to memory and the game is started again from the seed and the fleet in
+ * its header. then every record is decoded and played with stepGame, with no rendering, and its
+ * result is compared with the recorded one. a journal that was cut in the middle of a record (a
+ * crash) is replayed up to its last whole record.
+ * the file may also be the log of the group commit writer of the server (see writer.h). then its
+ * frames are split to their streams first, and every stream is replayed as a journal of its own.
+ * Input  : the path of the journal (or the log) and the number of times to replay it
+ * Process: replays the journal
+ * Output : the number of moves, the mismatches and the speed of the replay
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the command line arguments are not valid
+ */
+const char *REPLAY_USAGE_MSG = "usage: ex2_replay <journal or log> [--repeat <number>]\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the journal can't be opened
+ */
+const char *REPLAY_OPEN_ERROR_MSG = "can't open the journal";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the file is not a journal
+ */
+const char *INVALID_JOURNAL_MSG = "not a valid journal\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the game of the journal can't be started
+ */
+const char *REPLAY_GAME_ERROR_MSG = "can't start the game of the journal\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the streams of a log don't fit in the memory
+ */
+const char *REPLAY_MEMORY_ERROR_MSG = "out of memory\n";
+
+/**
+ * @brief the names of the results of a move, for the mismatch report.
+ */
+const char *RESULT_NAMES[] = {"miss", "hit", "sunk", "repeated", "win", "invalid"};
+
+/**
+ * the exit code for a journal whose results don't match the engine.
+ */
+#define MISMATCH_EXIT 2
+
+/**
+ * a flag for a log with a frame that is not valid.
+ */
+#define INVALID_LOG 6
+
+/**
+ * the multiplier of the hash of the stream ids (the golden ratio in 32 bits), and the number of
+ * slots the map of the streams starts with (a power of 2).
+ */
+#define STREAM_HASH_MULTIPLIER 2654435761u
+#define INITIAL_STREAM_SLOTS 64
+
+/**
+ * @brief the summary of a single replay.
+ * @numOfMoves the number of records that were replayed
+ * @numOfMismatches the number of moves whose result is not the recorded one
+ * @end the reason the replay stopped
+ */
+typedef struct ReplaySummary
+{
+    long numOfMoves;
+    long numOfMismatches;
+    JournalRecord end;
+} ReplaySummary;
+
+/**
+ * @brief the bytes of a single stream of a log.
+ * @id the id of the stream
+ * @data the bytes
+ * @length the number of bytes
+ * @capacity the size of data
+ */
+typedef struct StreamBuffer
+{
+    uint32_t id;
+    unsigned char *data;
+    size_t length;
+    size_t capacity;
+} StreamBuffer;
+
+/**
+ * @brief the streams of a log while it is split, with an open addressing map from the id of a
+ * stream to its place, so an id is never used as an index.
+ * @streams the streams, in the order of their first frame
+ * @numOfStreams the number of streams
+ * @capacity the size of streams
+ * @slots the map- the place of a stream plus one, 0 for an empty slot
+ * @numOfSlots the size of slots (a power of 2, at least twice the number of streams)
+ */
+typedef struct StreamTable
+{
+    StreamBuffer *streams;
+    uint32_t numOfStreams;
+    uint32_t capacity;
+    uint32_t *slots;
+    uint32_t numOfSlots;
+} StreamTable;
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function replays a journal once.
+ * @param data : the journal
+ * @param length : the length of the journal
+ * @param summary : will be set to the summary of the replay
+ * @param isReported : TRUE to print the first mismatch
+ * @return TRUE if the journal was replayed, FALSE if it is not valid or its game can't start
+ */
+int replayJournal(const unsigned char *data, const size_t length, ReplaySummary *summary,
+                  const int isReported)
+{
+    JournalReader reader;
+    if (openJournalReader(&reader, data, length) == FALSE)
+    {
+        fprintf(stderr, INVALID_JOURNAL_MSG);
+        return FALSE;
+    }
+    Game game;
+    if (initGame(&game, reader.header.size, &reader.fleet, reader.header.seed) != TRUE)
+    {
+        fprintf(stderr, REPLAY_GAME_ERROR_MSG);
+        return FALSE;
+    }
+    summary->numOfMoves = 0;
+    summary->numOfMismatches = 0;
+    int row, column;
+    MoveResult recorded;
+    while ((summary->end = readJournalRecord(&reader, &row, &column, &recorded)) == RECORD_OK)
+    {
+        MoveResult result = stepGame(&game, row, column);
+        summary->numOfMoves++;
+        if (result != recorded)
+        {
+            if (summary->numOfMismatches == 0 && isReported == TRUE)
+            {
+                printf("mismatch at move %ld (%c %d): recorded %s, replayed %s\n",
+                       summary->numOfMoves, 'a' + row, column + 1, RESULT_NAMES[recorded],
+                       RESULT_NAMES[result]);
+            }
+            summary->numOfMismatches++;
+        }
+    }
+    freeGame(&game);
+    return TRUE;
+}
+
+/**
+ * this function finds the slot of a stream id in the map of a table.
+ * @param table : the table
+ * @param id : the id of the stream
+ * @return the slot- the one of the stream, or the empty one it goes to
+ */
+uint32_t findStreamSlot(const StreamTable *table, const uint32_t id)
+{
+    uint32_t mask = table->numOfSlots - 1;
+    uint32_t slot = (id * STREAM_HASH_MULTIPLIER) & mask;
+    while (table->slots[slot] != 0 && table->streams[table->slots[slot] - 1].id != id)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/**
+ * this function doubles the map of a table, and puts the streams in it again.
+ * @param table : the table
+ * @return TRUE on success, FALSE if it is out of memory
+ */
+int growStreamSlots(StreamTable *table)
+{
+    uint32_t numOfSlots = (table->numOfSlots == 0) ? INITIAL_STREAM_SLOTS : 2 * table->numOfSlots;
+    uint32_t *slots = calloc(numOfSlots, sizeof(uint32_t));
+    if (slots == NULL)
+    {
+        return FALSE;
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->numOfSlots = numOfSlots;
+    uint32_t i;
+    for (i = 0 ; i < table->numOfStreams ; ++i)
+    {
+        table->slots[findStreamSlot(table, table->streams[i].id)] = i + 1;
+    }
+    return TRUE;
+}
+
+/**
+ * this function finds a stream of a table by its id, and adds it if it is new.
+ * @param table : the table
+ * @param id : the id of the stream
+ * @return the stream, or NULL if it is out of memory
+ */
+StreamBuffer *findStream(StreamTable *table, const uint32_t id)
+{
+    if (2 * (table->numOfStreams + 1) > table->numOfSlots && growStreamSlots(table) == FALSE)
+    {
+        return NULL;
+    }
+    uint32_t slot = findStreamSlot(table, id);
+    if (table->slots[slot] != 0)
+    {
+        return &table->streams[table->slots[slot] - 1];
+    }
+    if (table->numOfStreams == table->capacity)
+    {
+        uint32_t capacity = (table->capacity == 0) ? INITIAL_STREAM_SLOTS : 2 * table->capacity;
+        StreamBuffer *grown = realloc(table->streams, capacity * sizeof(StreamBuffer));
+        if (grown == NULL)
+        {
+            return NULL;
+        }
+        table->streams = grown;
+        table->capacity = capacity;
+    }
+    StreamBuffer *stream = &table->streams[table->numOfStreams++];
+    memset(stream, 0, sizeof(StreamBuffer));
+    stream->id = id;
+    table->slots[slot] = table->numOfStreams;
+    return stream;
+}
+
+/**
+ * this function splits a log of the writer to the journals of its streams. a frame that was cut
+ * at the end of the log (a crash) keeps the bytes that were written.
+ * @param data : the log
+ * @param length : the length of the log
+ * @param streams : will be set to the streams, in the order of their first frame (free them with
+ * freeStreams, also on a failure)
+ * @param numOfStreams : will be set to the size of streams
+ * @return TRUE on success, INVALID_LOG if a frame has no stream id (0), FALSE if it is out of
+ * memory
+ */
+int splitWriterLog(const unsigned char *data, const size_t length, StreamBuffer **streams,
+                   uint32_t *numOfStreams)
+{
+    size_t position = sizeof(WriterLogHeader);
+    StreamTable table = {NULL, 0, 0, NULL, 0};
+    int splitFlag = TRUE;
+    while (splitFlag == TRUE && position + sizeof(WriterFrame) <= length)
+    {
+        WriterFrame frame;
+        memcpy(&frame, data + position, sizeof(WriterFrame));
+        position += sizeof(WriterFrame);
+        size_t frameLength = (frame.length < length - position) ? frame.length : length - position;
+        StreamBuffer *stream = (frame.stream == 0) ? NULL : findStream(&table, frame.stream);
+        if (stream == NULL)
+        {
+            splitFlag = (frame.stream == 0) ? INVALID_LOG : FALSE;
+            break;
+        }
+        if (stream->length + frameLength > stream->capacity)
+        {
+            size_t capacity = 2 * (stream->length + frameLength);
+            unsigned char *grown = realloc(stream->data, capacity);
+            if (grown == NULL)
+            {
+                splitFlag = FALSE;
+                break;
+            }
+            stream->data = grown;
+            stream->capacity = capacity;
+        }
+        memcpy(stream->data + stream->length, data + position, frameLength);
+        stream->length += frameLength;
+        position += frameLength;
+    }
+    free(table.slots);
+    *streams = table.streams;
+    *numOfStreams = table.numOfStreams;
+    return splitFlag;
+}
+
+/**
+ * this function frees the streams of a log.
+ * @param streams : the streams
+ * @param numOfStreams : the number of streams
+ */
+void freeStreams(StreamBuffer *streams, const uint32_t numOfStreams)
+{
+    uint32_t i;
+    for (i = 0 ; i < numOfStreams ; ++i)
+    {
+        free(streams[i].data);
+    }
+    free(streams);
+}
+
+/**
+ * this function replays all the streams of a log once, and sums their summaries.
+ * @param streams : the streams
+ * @param numOfStreams : the number of streams
+ * @param summary : will be set to the summary of all the streams (its end is the worst end)
+ * @param isReported : TRUE to print the first mismatch of every stream
+ * @return TRUE if all the streams were replayed, FALSE otherwise
+ */
+int replayStreams(const StreamBuffer *streams, const uint32_t numOfStreams, ReplaySummary *summary,
+                  const int isReported)
+{
+    summary->numOfMoves = 0;
+    summary->numOfMismatches = 0;
+    summary->end = RECORD_END;
+    uint32_t i;
+    for (i = 0 ; i < numOfStreams ; ++i)
+    {
+        ReplaySummary streamSummary;
+        if (streams[i].length == 0)
+        {
+            continue;
+        }
+        if (replayJournal(streams[i].data, streams[i].length, &streamSummary, isReported) == FALSE)
+        {
+            return FALSE;
+        }
+        summary->numOfMoves += streamSummary.numOfMoves;
+        summary->numOfMismatches += streamSummary.numOfMismatches;
+        if (streamSummary.end > summary->end)
+        {
+            summary->end = streamSummary.end;
+        }
+    }
+    return TRUE;
+}
+
+/**
+ * the main function of the replay tool.
+ * @param argc : the number of the arguments
+ * @param argv : the arguments (see REPLAY_USAGE_MSG)
+ * @return 0 if the journal matches the engine, MISMATCH_EXIT if it doesn't, 1 on an error
+ */
+int main(int argc, char *argv[])
+{
+    long repeat = 1;
+    if ((argc != 2 && argc != 4) ||
+        (argc == 4 && (strcmp(argv[2], "--repeat") != 0 || sscanf(argv[3], "%ld", &repeat) != 1 ||
+                       repeat < 1)))
+    {
+        fprintf(stderr, REPLAY_USAGE_MSG);
+        return 1;
+    }
+    int fd = open(argv[1], O_RDONLY);
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) != 0)
+    {
+        perror(REPLAY_OPEN_ERROR_MSG);
+        return 1;
+    }
+    size_t length = (size_t) status.st_size;
+    const unsigned char *data = (length == 0) ? NULL :
+                                mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        perror(REPLAY_OPEN_ERROR_MSG);
+        return 1;
+    }
+
+    StreamBuffer *streams = NULL;
+    uint32_t numOfStreams = 0;
+    int isLog = FALSE;
+    WriterLogHeader logHeader;
+    if (length >= sizeof(WriterLogHeader))
+    {
+        memcpy(&logHeader, data, sizeof(WriterLogHeader));
+        isLog = (logHeader.magic == WRITER_LOG_MAGIC) ? TRUE : FALSE;
+    }
+    if (isLog == TRUE)
+    {
+        int splitFlag = (logHeader.version != WRITER_LOG_VERSION) ? INVALID_LOG :
+                        splitWriterLog(data, length, &streams, &numOfStreams);
+        if (splitFlag != TRUE)
+        {
+            fprintf(stderr, (splitFlag == FALSE) ? REPLAY_MEMORY_ERROR_MSG : INVALID_JOURNAL_MSG);
+            freeStreams(streams, numOfStreams);
+            return 1;
+        }
+    }
+
+    ReplaySummary summary;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    long i;
+    for (i = 0 ; i < repeat ; ++i)
+    {
+        int replayFlag = (isLog == TRUE) ?
+                         replayStreams(streams, numOfStreams, &summary, (i == 0) ? TRUE : FALSE) :
+                         replayJournal(data, length, &summary, (i == 0) ? TRUE : FALSE);
+        if (replayFlag == FALSE)
+        {
+            return 1;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (double) (end.tv_sec - start.tv_sec) +
+                     (double) (end.tv_nsec - start.tv_nsec) / 1e9;
+    double totalMoves = (double) summary.numOfMoves * (double) repeat;
+
+    if (isLog == TRUE)
+    {
+        uint32_t numOfGames = 0;
+        for (i = 0 ; i < numOfStreams ; ++i)
+        {
+            numOfGames += (streams[i].length > 0) ? 1 : 0;
+        }
+        printf("games %u\n", numOfGames);
+        freeStreams(streams, numOfStreams);
+    }
+    printf("moves %ld mismatches %ld%s\n", summary.numOfMoves, summary.numOfMismatches,
+           (summary.end == RECORD_TRUNCATED) ? " (the last record is cut)" :
+           (summary.end == RECORD_BAD) ? " (stopped at a bad record)" : "");
+    printf("replayed %ld times in %.3f ms (%.0f moves/s)\n", repeat, seconds * 1000,
+           (seconds > 0) ? totalMoves / seconds : 0);
+    munmap((void *) data, length);
+    return (summary.numOfMismatches == 0 && summary.end != RECORD_BAD) ? 0 : MISMATCH_EXIT;
+}
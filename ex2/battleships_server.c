@@ -0,0 +1,985 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "battleships.h"
+#include "input.h"
+#include "ai.h"
+#include "snapshot.h"
+#include "journal.h"
+#include "writer.h"
+
+/**
+ * @file battleships_server.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the game server. many players play the battleship game at the same time, each one over
+ * a connection to a unix domain socket.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * the main thread accepts the connections and hands them to a small number of worker threads
+ * (round robin). every worker runs its own epoll loop over its sessions, so a session is only
+ * touched by one thread and needs no locks. a session is a Game plus a fixed input and output
+ * buffer, so its memory doesn't depend on the number of sessions.
+ * the protocol is one command per line:
+ *   new <size> [<seed>]  - start a new game        -> ok | error <reason>
+ *   <letter> <number>    - make a move (also c12)  -> miss | hit | sunk | repeated | invalid |
+ *                                                     win <number of moves>
+ *   ai                   - let the computer player make the move, the reply starts with its
+ *                          coordinate (like "c 12 hit")
+ *   save                 - save a snapshot of the game (see snapshot.h) -> saved <token>
+ *   resume <token>       - resume a saved game, on any session -> ok | error <reason>
+ *   writer               - the state of the writer -> writer depth <bytes> commits <number>
+ *                          dropped <number> failed <number> latency <average> <max> (in micro
+ *                          seconds)
+ *   exit                 - close the session
+ * the snapshots are kept in the snapshot directory, one file per token, so an idle player can
+ * leave and come back to its game later (even after the server restarts).
+ * the workers never touch the disk. every session has a queue of the group commit writer (see
+ * writer.h)- a save pushes the snapshot to it as a whole file, and with --journal every new game
+ * starts a stream of the log and every move pushes its journal record (see journal.h) to it. a
+ * "saved" reply means the writer has the snapshot- it is on the disk once its group is committed,
+ * and if the writer fails to write it, it is counted in the "failed" of the writer and a resume
+ * of its token replies "error snapshot". a resume is a task of the writer- the writer maps and
+ * checks the snapshot after it committed the snapshots that were saved before (on any session),
+ * and hands it back to the worker through the eventfd of the worker. until then the session runs
+ * no more commands.
+ * Input  : the socket path, the number of workers, the snapshot directory and the options of the
+ * writer from the command line
+ * Process: runs the games of all the connected players
+ * Output : the result of every command to its player
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the sizes of the buffers of a session. a command never gets close to LINE_CAPACITY and a reply
+ * never gets close to REPLY_CAPACITY.
+ */
+#define LINE_CAPACITY 64
+#define OUT_CAPACITY 1024
+#define REPLY_CAPACITY 96
+
+/**
+ * the number of hex digits of a snapshot token.
+ */
+#define TOKEN_DIGITS 16
+
+/**
+ * the number of epoll events a worker handles in one wait, and the limits for the workers.
+ */
+#define MAX_EVENTS 256
+#define MAX_WORKERS 64
+#define DEFAULT_WORKERS 4
+
+/**
+ * the size of the queue of the listening socket.
+ */
+#define LISTEN_BACKLOG 1024
+
+/**
+ * a flag for a session that was closed while its resume waits for the writer.
+ */
+#define CLOSED_SESSION -1
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the command line arguments are not valid
+ */
+const char *SERVER_USAGE_MSG =
+        "usage: ex2_server <socket path> [<number of workers> [<snapshot directory>]]\n"
+        "                  [--journal <log path>] [--commit-ms <number>] [--commit-kb <number>]\n";
+
+/**
+ * @var constant for the snapshots.
+ * @brief the suffix of the snapshot files
+ */
+const char SNAPSHOT_SUFFIX[] = ".snap";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the server can't start
+ */
+const char *SERVER_START_ERROR_MSG = "failed to start the server";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the log of the writer can't be opened
+ */
+const char *WRITER_LOG_ERROR_MSG = "can't open the log";
+
+/**
+ * @brief the replies for the results of a move, indexed by the MoveResult (win has its own
+ * format since it reports the number of moves).
+ */
+const char *MOVE_REPLIES[] = {"miss\n", "hit\n", "sunk\n", "repeated\n", "win", "invalid\n"};
+
+/**
+ * @brief a single connected player.
+ * @fd the socket of the player
+ * @hasGame TRUE after a game was started on the session (and has to be freed)
+ * @events the events the session is registered for in the epoll of its worker
+ * @game the game of the player
+ * @queue the queue of the session in the writer
+ * @isJournaled TRUE if the moves of the game go to the log
+ * @journalCell the cell of the last move in the log
+ * @resume the resume that waits for the writer, NULL if there is none
+ * @in the bytes that were read and don't make a full line yet
+ * @inLength the number of bytes in in
+ * @out the replies that were not sent yet
+ * @outLength the number of bytes in out
+ */
+typedef struct Session
+{
+    int fd;
+    int hasGame;
+    unsigned int events;
+    Game game;
+    WriterQueue *queue;
+    int isJournaled;
+    int journalCell;
+    struct ResumeRequest *resume;
+    char in[LINE_CAPACITY];
+    int inLength;
+    char out[OUT_CAPACITY];
+    int outLength;
+} Session;
+
+/**
+ * @brief a worker thread and its epoll loop.
+ * @thread the thread of the worker
+ * @epollFd the epoll of the sessions of the worker
+ * @rng draws the seeds of the games that were started with no seed
+ * @eventFd an eventfd in the epoll of the worker, the writer signals it when a resume is ready
+ * @resumed the resumes that are ready (the writer pushes them with a compare and swap)
+ */
+typedef struct Worker
+{
+    pthread_t thread;
+    int epollFd;
+    Rng rng;
+    int eventFd;
+    struct ResumeRequest *resumed;
+} Worker;
+
+/**
+ * @brief a resume of a session, that the writer maps for its worker.
+ * @task the task of the writer
+ * @worker the worker of the session
+ * @session the session
+ * @path the path of the snapshot
+ * @flag TRUE if the snapshot was mapped to view, INVALID_SNAPSHOT otherwise
+ * @view the mapped snapshot
+ * @next the next resume that is ready
+ */
+typedef struct ResumeRequest
+{
+    WriterTask task;
+    Worker *worker;
+    Session *session;
+    char path[PATH_MAX];
+    int flag;
+    SnapshotView view;
+    struct ResumeRequest *next;
+} ResumeRequest;
+
+
+/**
+ * the directory of the snapshots. it is set before the workers start.
+ */
+const char *snapshotDir = ".";
+
+/**
+ * the group commit writer of the snapshots and the log, and TRUE if there is a log.
+ */
+GroupWriter groupWriter;
+int hasLog = FALSE;
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function closes a session and frees everything it holds. a session with a resume that
+ * waits for the writer is freed once the resume is ready (see finishResume).
+ * @param worker : the worker of the session
+ * @param session : the session
+ */
+void closeSession(Worker *worker, Session *session)
+{
+    epoll_ctl(worker->epollFd, EPOLL_CTL_DEL, session->fd, NULL);
+    close(session->fd);
+    closeWriterQueue(session->queue);
+    if (session->hasGame == TRUE)
+    {
+        freeGame(&session->game);
+    }
+    if (session->resume != NULL)
+    {
+        session->fd = CLOSED_SESSION;
+        return;
+    }
+    free(session);
+}
+
+/**
+ * this function adds a reply to the output of a session.
+ * @param session : the session
+ * @param reply : the reply (a full line)
+ */
+void addReply(Session *session, const char *reply)
+{
+    int length = (int) strlen(reply);
+    memcpy(session->out + session->outLength, reply, (size_t) length);
+    session->outLength += length;
+}
+
+/**
+ * this function starts the stream of a new game of a session in the log, if there is a log.
+ * @param session : the session, with its new game
+ * @param seed : the seed of the game
+ */
+void journalNewGame(Session *session, const uint64_t seed)
+{
+    unsigned char header[JOURNAL_MAX_HEADER];
+    uint32_t stream;
+    session->isJournaled = FALSE;
+    if (hasLog == FALSE || pushWriterStream(&groupWriter, session->queue, &stream) == FALSE)
+    {
+        return;
+    }
+    int length = encodeJournalHeader(header, &session->game, seed);
+    if (pushWriterLog(&groupWriter, session->queue, header, length) == TRUE)
+    {
+        session->isJournaled = TRUE;
+        session->journalCell = 0;
+    }
+}
+
+/**
+ * this function runs the "new" command- starts a new game on the session.
+ * @param worker : the worker of the session
+ * @param session : the session
+ * @param args : the rest of the command line (the size and maybe a seed)
+ */
+void newGameCommand(Worker *worker, Session *session, const char *args)
+{
+    int size;
+    unsigned long long seed;
+    int numOfArgs = sscanf(args, "%d %llu", &size, &seed);
+    if (numOfArgs < 1)
+    {
+        addReply(session, "error usage\n");
+        return;
+    }
+    if (numOfArgs == 1)
+    {
+        seed = rngNext(&worker->rng);
+    }
+    if (session->hasGame == TRUE)
+    {
+        freeGame(&session->game);
+        session->hasGame = FALSE;
+    }
+    switch (initGame(&session->game, size, NULL, (uint64_t) seed))
+    {
+        case TRUE:
+            session->hasGame = TRUE;
+            journalNewGame(session, (uint64_t) seed);
+            addReply(session, "ok\n");
+            break;
+        case INVALID_SIZE:
+            addReply(session, "error size\n");
+            break;
+        case NO_PLACEMENT:
+            addReply(session, "error placement\n");
+            break;
+        case PLACEMENT_TIMEOUT:
+            addReply(session, "error timeout\n");
+            break;
+        default:
+            addReply(session, "error memory\n");
+            break;
+    }
+}
+
+/**
+ * this function runs the move command- a letter for the row and a number for the column.
+ * @param session : the session
+ * @param line : the command line
+ */
+void moveCommand(Session *session, const char *line)
+{
+    int row, column;
+    if (session->hasGame == FALSE)
+    {
+        addReply(session, "error no game\n");
+        return;
+    }
+    if (strcmp(line, "ai") == 0)
+    {
+        if (chooseShot(&session->game, &row, &column) == FALSE)
+        {
+            addReply(session, MOVE_REPLIES[MOVE_INVALID]);
+            return;
+        }
+        char coordinate[REPLY_CAPACITY];
+        snprintf(coordinate, sizeof(coordinate), "%c %d ", 'a' + row, column + 1);
+        addReply(session, coordinate);
+    }
+    else if (parseMove(line, (int) strlen(line), &row, &column) != PARSE_OK)
+    {
+        addReply(session, MOVE_REPLIES[MOVE_INVALID]);
+        return;
+    }
+    MoveResult result = stepGame(&session->game, row, column);
+    if (session->isJournaled == TRUE && result != MOVE_INVALID)
+    { // a dropped record would make the rest of the stream wrong, so the stream ends there
+        unsigned char record[JOURNAL_MAX_RECORD];
+        int length = encodeJournalRecord(record, &session->journalCell, session->game.gameBoard.size,
+                                         row, column, result);
+        session->isJournaled = pushWriterLog(&groupWriter, session->queue, record, length);
+    }
+    if (result == MOVE_WIN)
+    {
+        char reply[REPLY_CAPACITY];
+        snprintf(reply, sizeof(reply), "%s %d\n", MOVE_REPLIES[MOVE_WIN],
+                 gameResult(&session->game).numOfMoves);
+        addReply(session, reply);
+        return;
+    }
+    addReply(session, MOVE_REPLIES[result]);
+}
+
+/**
+ * this function gives the path of the snapshot of a token.
+ * @param path : will be set to the path (PATH_MAX bytes)
+ * @param token : the token
+ * @return TRUE if the token is valid and the path fits, FALSE otherwise
+ */
+int snapshotPath(char *path, const char *token)
+{
+    int i;
+    for (i = 0 ; i < TOKEN_DIGITS ; ++i)
+    { // only hex digits, so a token is never a path of its own
+        if (!((token[i] >= '0' && token[i] <= '9') || (token[i] >= 'a' && token[i] <= 'f')))
+        {
+            return FALSE;
+        }
+    }
+    if (token[TOKEN_DIGITS] != '\0' ||
+        snprintf(path, PATH_MAX, "%s/%s%s", snapshotDir, token, SNAPSHOT_SUFFIX) >= PATH_MAX)
+    {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * this function runs the "save" command- saves a snapshot of the game of the session under a new
+ * token. the snapshot is handed to the writer, so the worker never waits for the disk.
+ * @param worker : the worker of the session
+ * @param session : the session
+ */
+void saveCommand(Worker *worker, Session *session)
+{
+    if (session->hasGame == FALSE)
+    {
+        addReply(session, "error no game\n");
+        return;
+    }
+    char token[TOKEN_DIGITS + 1];
+    char path[PATH_MAX];
+    snprintf(token, sizeof(token), "%016llx", (unsigned long long) rngNext(&worker->rng));
+    WriterFile *file = NULL;
+    if (snapshotPath(path, token) == FALSE ||
+        (file = newWriterFile(path, snapshotBytes(&session->game))) == NULL)
+    {
+        addReply(session, "error save\n");
+        return;
+    }
+    encodeSnapshot(&session->game, file->data);
+    if (pushWriterFile(&groupWriter, session->queue, file) == FALSE)
+    {
+        free(file);
+        addReply(session, "error busy\n");
+        return;
+    }
+    char reply[REPLY_CAPACITY];
+    snprintf(reply, sizeof(reply), "saved %s\n", token);
+    addReply(session, reply);
+}
+
+/**
+ * the task of a resume, on the writer thread- maps and checks the snapshot and hands it to the
+ * worker of the session.
+ * @param task : the task of the resume
+ */
+void mapResume(WriterTask *task)
+{
+    ResumeRequest *request = (ResumeRequest *) task;
+    Worker *worker = request->worker;
+    request->flag = INVALID_SNAPSHOT;
+    int fd = open(request->path, O_RDONLY);
+    if (fd >= 0)
+    {
+        if (mapSnapshot(&request->view, fd) == TRUE)
+        {
+            request->flag = TRUE;
+        }
+        close(fd);
+    }
+    request->next = __atomic_load_n(&worker->resumed, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&worker->resumed, &request->next, request, 1,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    { // the writer pushed another resume first, request->next is the new head
+    }
+    uint64_t one = 1;
+    if (write(worker->eventFd, &one, sizeof(one)) < 0)
+    { // the counter is full, so the worker is signaled already
+    }
+}
+
+/**
+ * this function runs the "resume" command- replaces the game of the session with a saved one.
+ * the snapshot is mapped by the writer, the reply is sent once it is ready (see finishResume).
+ * @param worker : the worker of the session
+ * @param session : the session
+ * @param args : the rest of the command line (the token)
+ */
+void resumeCommand(Worker *worker, Session *session, const char *args)
+{
+    char path[PATH_MAX];
+    while (*args == ' ')
+    {
+        args++;
+    }
+    if (snapshotPath(path, args) == FALSE)
+    {
+        addReply(session, "error usage\n");
+        return;
+    }
+    if (session->hasGame == TRUE)
+    {
+        freeGame(&session->game);
+        session->hasGame = FALSE;
+    }
+    session->isJournaled = FALSE; // the log has no header for a resumed game
+    ResumeRequest *request = (ResumeRequest *) malloc(sizeof(ResumeRequest));
+    if (request == NULL)
+    {
+        addReply(session, "error memory\n");
+        return;
+    }
+    request->task.run = mapResume;
+    request->worker = worker;
+    request->session = session;
+    strcpy(request->path, path);
+    if (pushWriterTask(&groupWriter, session->queue, &request->task) == FALSE)
+    {
+        free(request);
+        addReply(session, "error busy\n");
+        return;
+    }
+    session->resume = request;
+}
+
+/**
+ * this function runs the "writer" command- replies with the depth of the queues and the latency of
+ * the commits of the writer.
+ * @param session : the session
+ */
+void writerCommand(Session *session)
+{
+    WriterStats stats;
+    readWriterStats(&groupWriter, &stats);
+    char reply[REPLY_CAPACITY];
+    snprintf(reply, sizeof(reply),
+             "writer depth %llu commits %llu dropped %llu failed %llu latency %llu %llu\n",
+             (unsigned long long) stats.queueDepth, (unsigned long long) stats.commits,
+             (unsigned long long) stats.dropped, (unsigned long long) stats.failedFiles,
+             (unsigned long long) ((stats.commits > 0) ? stats.totalCommitMicros / stats.commits : 0),
+             (unsigned long long) stats.maxCommitMicros);
+    addReply(session, reply);
+}
+
+/**
+ * this function runs a single command line of a session.
+ * @param worker : the worker of the session
+ * @param session : the session
+ * @param line : the command line (with no new line at its end)
+ * @return TRUE to keep the session, EXIT_GAME to close it
+ */
+int runCommand(Worker *worker, Session *session, const char *line)
+{
+    if (strncmp(line, "new", 3) == 0)
+    {
+        newGameCommand(worker, session, line + 3);
+        return TRUE;
+    }
+    if (strcmp(line, "exit") == 0)
+    {
+        return EXIT_GAME;
+    }
+    if (strcmp(line, "save") == 0)
+    {
+        saveCommand(worker, session);
+        return TRUE;
+    }
+    if (strncmp(line, "resume", 6) == 0)
+    {
+        resumeCommand(worker, session, line + 6);
+        return TRUE;
+    }
+    if (strcmp(line, "writer") == 0)
+    {
+        writerCommand(session);
+        return TRUE;
+    }
+    moveCommand(session, line);
+    return TRUE;
+}
+
+/**
+ * this function runs all the full lines in the input of a session, as long as there is room for
+ * their replies and no resume waits for the writer.
+ * @param worker : the worker of the session
+ * @param session : the session
+ * @return TRUE to keep the session, EXIT_GAME to close it
+ */
+int runCommands(Worker *worker, Session *session)
+{
+    int start = 0;
+    int flag = TRUE;
+    while (flag == TRUE && session->resume == NULL &&
+           session->outLength + REPLY_CAPACITY <= OUT_CAPACITY)
+    {
+        char *end = memchr(session->in + start, '\n', (size_t) (session->inLength - start));
+        if (end == NULL)
+        {
+            break;
+        }
+        *end = '\0';
+        if (end > session->in + start && end[-1] == '\r')
+        {
+            end[-1] = '\0';
+        }
+        flag = runCommand(worker, session, session->in + start);
+        start = (int) (end - session->in) + 1;
+    }
+    session->inLength -= start;
+    memmove(session->in, session->in + start, (size_t) session->inLength);
+    if (session->inLength == LINE_CAPACITY && session->resume == NULL &&
+        session->outLength + REPLY_CAPACITY <= OUT_CAPACITY &&
+        memchr(session->in, '\n', LINE_CAPACITY) == NULL)
+    { // a line that can't be a command (a full buffer of lines waits for room for their replies)
+        addReply(session, "error line\n");
+        session->inLength = 0;
+    }
+    return flag;
+}
+
+/**
+ * this function sends as much as it can of the output of a session.
+ * @param session : the session
+ * @return TRUE if the connection is fine, FALSE if it broke
+ */
+int flushSession(Session *session)
+{
+    if (session->outLength == 0)
+    {
+        return TRUE;
+    }
+    ssize_t sent = send(session->fd, session->out, (size_t) session->outLength, MSG_NOSIGNAL);
+    if (sent < 0)
+    {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? TRUE : FALSE;
+    }
+    session->outLength -= (int) sent;
+    memmove(session->out, session->out + sent, (size_t) session->outLength);
+    return TRUE;
+}
+
+/**
+ * this function updates the events a session waits for. while it has replies to send it waits
+ * only for the socket to be writable, so a player that doesn't read can't fill our memory. while
+ * its resume waits for the writer (and it has nothing to send) it is out of the epoll, since it
+ * can't run commands anyway.
+ * @param worker : the worker of the session
+ * @param session : the session
+ */
+void updateEvents(Worker *worker, Session *session)
+{
+    unsigned int events = (session->outLength > 0) ? EPOLLOUT :
+                          (session->resume != NULL) ? 0 : EPOLLIN;
+    if (events != session->events)
+    {
+        struct epoll_event event;
+        event.events = events;
+        event.data.ptr = session;
+        int operation = (session->events == 0) ? EPOLL_CTL_ADD :
+                        (events == 0) ? EPOLL_CTL_DEL : EPOLL_CTL_MOD;
+        epoll_ctl(worker->epollFd, operation, session->fd, &event);
+        session->events = events;
+    }
+}
+
+/**
+ * this function sends the replies of a session and runs the commands in its input.
+ * @param worker : the worker of the session
+ * @param session : the session
+ */
+void serveSession(Worker *worker, Session *session)
+{
+    if (flushSession(session) == FALSE)
+    {
+        closeSession(worker, session);
+        return;
+    }
+    int flag = runCommands(worker, session);
+    if (flushSession(session) == FALSE || flag == EXIT_GAME)
+    {
+        closeSession(worker, session);
+        return;
+    }
+    updateEvents(worker, session);
+}
+
+/**
+ * this function handles an event on a session- reads the new input, runs the commands in it and
+ * sends the replies.
+ * @param worker : the worker of the session
+ * @param session : the session
+ */
+void handleSession(Worker *worker, Session *session)
+{
+    if (session->events == EPOLLIN && session->inLength < LINE_CAPACITY)
+    { // with a full buffer a read of 0 bytes would look like the player left
+        ssize_t numRead = read(session->fd, session->in + session->inLength,
+                               (size_t) (LINE_CAPACITY - session->inLength));
+        if (numRead == 0 || (numRead < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+        { // the player left
+            closeSession(worker, session);
+            return;
+        }
+        if (numRead > 0)
+        {
+            session->inLength += (int) numRead;
+        }
+    }
+    serveSession(worker, session);
+}
+
+/**
+ * this function finishes a resume that the writer made ready- resumes the game from the mapped
+ * snapshot (its pages were just read by the checks of the writer), replies and goes on with the
+ * commands of the session.
+ * @param worker : the worker of the session
+ * @param request : the resume
+ */
+void finishResume(Worker *worker, ResumeRequest *request)
+{
+    Session *session = request->session;
+    session->resume = NULL;
+    int flag = request->flag;
+    if (flag == TRUE)
+    {
+        if (session->fd != CLOSED_SESSION)
+        {
+            flag = resumeGame(&session->game, request->view.header);
+        }
+        unmapSnapshot(&request->view);
+    }
+    free(request);
+    if (session->fd == CLOSED_SESSION)
+    {
+        free(session);
+        return;
+    }
+    switch (flag)
+    {
+        case TRUE:
+            session->hasGame = TRUE;
+            addReply(session, "ok\n");
+            break;
+        case INVALID_SNAPSHOT:
+            addReply(session, "error snapshot\n");
+            break;
+        default:
+            addReply(session, "error memory\n");
+            break;
+    }
+    serveSession(worker, session);
+}
+
+/**
+ * this function finishes all the resumes of a worker that are ready, in the order they were
+ * made ready.
+ * @param worker : the worker
+ */
+void finishResumes(Worker *worker)
+{
+    uint64_t count;
+    if (read(worker->eventFd, &count, sizeof(count)) < 0)
+    { // another signal was read with the resumes before it
+    }
+    ResumeRequest *request = __atomic_exchange_n(&worker->resumed, NULL, __ATOMIC_ACQUIRE);
+    ResumeRequest *ordered = NULL;
+    while (request != NULL)
+    { // the list is newest first
+        ResumeRequest *next = request->next;
+        request->next = ordered;
+        ordered = request;
+        request = next;
+    }
+    while (ordered != NULL)
+    {
+        ResumeRequest *next = ordered->next;
+        finishResume(worker, ordered);
+        ordered = next;
+    }
+}
+
+/**
+ * the loop of a worker thread.
+ * @param arg : the worker
+ * @return NULL (never returns)
+ */
+void *runWorker(void *arg)
+{
+    Worker *worker = (Worker *) arg;
+    struct epoll_event events[MAX_EVENTS];
+    while (1)
+    {
+        int numEvents = epoll_wait(worker->epollFd, events, MAX_EVENTS, -1);
+        int i;
+        for (i = 0 ; i < numEvents ; ++i)
+        {
+            if (events[i].data.ptr == worker)
+            {
+                finishResumes(worker);
+                continue;
+            }
+            handleSession(worker, (Session *) events[i].data.ptr);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * this function opens the listening socket of the server.
+ * @param path : the path of the unix domain socket
+ * @return the socket, or -1 on failure
+ */
+int openListener(const char *path)
+{
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        return -1;
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    unlink(path);
+    if (bind(listener, (struct sockaddr *) &address, sizeof(address)) < 0 ||
+        listen(listener, LISTEN_BACKLOG) < 0)
+    {
+        close(listener);
+        return -1;
+    }
+    return listener;
+}
+
+/**
+ * this function starts the worker threads.
+ * @param workers : the workers
+ * @param numOfWorkers : the number of workers
+ * @return TRUE on success, FALSE otherwise
+ */
+int startWorkers(Worker *workers, const int numOfWorkers)
+{
+    int i;
+    uint64_t seed = (uint64_t) time(NULL) ^ ((uint64_t) getpid() << 32);
+    for (i = 0 ; i < numOfWorkers ; ++i)
+    {
+        rngSeed(&workers[i].rng, seed + (uint64_t) i);
+        workers[i].resumed = NULL;
+        workers[i].epollFd = epoll_create1(0);
+        workers[i].eventFd = eventfd(0, EFD_NONBLOCK);
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = &workers[i];
+        if (workers[i].epollFd < 0 || workers[i].eventFd < 0 ||
+            epoll_ctl(workers[i].epollFd, EPOLL_CTL_ADD, workers[i].eventFd, &event) < 0 ||
+            pthread_create(&workers[i].thread, NULL, runWorker, &workers[i]) != 0)
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/**
+ * this function accepts the players forever, and hands every new session to the next worker.
+ * @param listener : the listening socket
+ * @param workers : the workers
+ * @param numOfWorkers : the number of workers
+ */
+void acceptPlayers(const int listener, Worker *workers, const int numOfWorkers)
+{
+    int next = 0;
+    while (1)
+    {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0)
+        {
+            continue;
+        }
+        Session *session = (Session *) malloc(sizeof(Session));
+        if (session == NULL || (session->queue = openWriterQueue(&groupWriter)) == NULL)
+        {
+            free(session);
+            close(fd);
+            continue;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        session->fd = fd;
+        session->hasGame = FALSE;
+        session->isJournaled = FALSE;
+        session->resume = NULL;
+        session->events = EPOLLIN;
+        session->inLength = 0;
+        session->outLength = 0;
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = session;
+        if (epoll_ctl(workers[next].epollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            close(fd);
+            closeWriterQueue(session->queue);
+            free(session);
+            continue;
+        }
+        next = (next + 1) % numOfWorkers;
+    }
+}
+
+/**
+ * this function reads the options of the writer that come after the positional arguments, and
+ * starts the writer.
+ * @param argc : the number of the arguments
+ * @param argv : the arguments
+ * @param first : the index of the first option
+ * @return TRUE if the writer started, FALSE if the options are not valid, EXIT_GAME if the log
+ * can't be opened or the writer can't start
+ */
+int startGroupWriter(const int argc, char *argv[], const int first)
+{
+    const char *logPath = NULL;
+    unsigned long commitMillis = WRITER_DEFAULT_COMMIT_MICROS / 1000;
+    unsigned long commitKilobytes = WRITER_DEFAULT_COMMIT_BYTES / 1024;
+    int i;
+    for (i = first ; i < argc ; i += 2)
+    {
+        if (i + 1 == argc)
+        {
+            return FALSE;
+        }
+        if (strcmp(argv[i], "--journal") == 0)
+        {
+            logPath = argv[i + 1];
+        }
+        else if ((strcmp(argv[i], "--commit-ms") != 0 ||
+                  sscanf(argv[i + 1], "%lu", &commitMillis) != 1) &&
+                 (strcmp(argv[i], "--commit-kb") != 0 ||
+                  sscanf(argv[i + 1], "%lu", &commitKilobytes) != 1))
+        {
+            return FALSE;
+        }
+    }
+    int logFd = -1;
+    if (logPath != NULL)
+    {
+        logFd = open(logPath, O_RDWR | O_CREAT | O_APPEND, 0644); // read for the ids of the log
+        if (logFd < 0)
+        {
+            perror(WRITER_LOG_ERROR_MSG);
+            return EXIT_GAME;
+        }
+        hasLog = TRUE;
+    }
+    if (startWriter(&groupWriter, logFd, (uint64_t) commitMillis * 1000,
+                    (uint64_t) commitKilobytes * 1024) == FALSE)
+    {
+        perror(SERVER_START_ERROR_MSG);
+        return EXIT_GAME;
+    }
+    return TRUE;
+}
+
+/**
+ * the main function of the server.
+ * @param argc : the number of the arguments
+ * @param argv : the arguments- the socket path, optionally the number of workers and optionally
+ * the snapshot directory (the working directory by default), and then the options of the writer
+ * @return 1 if the server could not start (otherwise it runs until it is killed)
+ */
+int main(int argc, char *argv[])
+{
+    int numOfWorkers = DEFAULT_WORKERS;
+    int numOfPositionals = 1;
+    while (numOfPositionals < argc && numOfPositionals < 4 &&
+           strncmp(argv[numOfPositionals], "--", 2) != 0)
+    {
+        numOfPositionals++;
+    }
+    if (numOfPositionals < 2 ||
+        (numOfPositionals >= 3 && sscanf(argv[2], "%d", &numOfWorkers) != 1) ||
+        numOfWorkers < 1 || numOfWorkers > MAX_WORKERS)
+    {
+        fprintf(stderr, SERVER_USAGE_MSG);
+        return 1;
+    }
+    if (numOfPositionals == 4)
+    {
+        snapshotDir = argv[3];
+    }
+    int writerFlag = startGroupWriter(argc, argv, numOfPositionals);
+    if (writerFlag != TRUE)
+    {
+        if (writerFlag == FALSE)
+        {
+            fprintf(stderr, SERVER_USAGE_MSG);
+        }
+        return 1;
+    }
+    static Worker workers[MAX_WORKERS];
+    int listener = openListener(argv[1]);
+    if (listener < 0 || startWorkers(workers, numOfWorkers) == FALSE)
+    {
+        perror(SERVER_START_ERROR_MSG);
+        return 1;
+    }
+    acceptPlayers(listener, workers, numOfWorkers);
+    return 0;
+}
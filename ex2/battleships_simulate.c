@@ -0,0 +1,529 @@
+// ------------------------------ includes ------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "battleships.h"
+#include "input.h"
+#include "stats.h"
+#include "pool.h"
+#include "selfplay.h"
+
+/**
+ * @file battleships_simulate.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the self play simulator. it plays a lot of complete games with a shot strategy and
+ * reports how many shots the strategy needs to win.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * the games are cut to chunks and every thread gets an even share of the chunks in its own deque.
+ * a thread takes its chunks from the bottom of its deque, and once it is empty it steals from the
+ * top of the deques of the other threads, so strategies with uneven game lengths still keep all
+ * the threads busy. the chunks are all known before the threads start, so the deques never grow
+ * and a chunk is just an index.
+ * every game has its own seed (the seed of the run plus the number of the game), so the results
+ * don't depend on which thread played which chunk. every thread keeps its own statistics and adds
+ * them to the totals with atomic adds when it is done.
+ * Input  : the options from the command line
+ * Process: plays the games
+ * Output : the statistics of the number of shots to win
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the number of games in a chunk- the unit of work that is stolen.
+ */
+#define CHUNK_GAMES 256
+
+/**
+ * the size of a cache line, the deques and the statistics of the threads are kept apart by it.
+ */
+#define CACHE_LINE 64
+
+/**
+ * the result of a steal that lost the race for the chunk to another thread.
+ */
+#define STEAL_RETRY (-2)
+
+/**
+ * the result of taking a chunk from an empty deque.
+ */
+#define NO_CHUNK (-1)
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the command line arguments are not valid
+ */
+const char *SIMULATE_USAGE_MSG =
+        "usage: ex2_simulate [--games <games per thread>] [--threads <number>] [--size <number>] "
+        "[--seed <number>] [--strategy ai|random|sweep] [--fleet <lengths>] "
+        "[--stats text|json]\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the threads can't start
+ */
+const char *SIMULATE_START_ERROR_MSG = "failed to start the threads";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the fleet could not be placed on the board
+ */
+const char *SIMULATE_PLACEMENT_ERROR_MSG = "the fleet could not be placed on a %d board\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the search for a layout of the fleet gave up
+ */
+const char *SIMULATE_TIMEOUT_ERROR_MSG =
+        "no layout of the fleet was found in time on a %d board, try another seed\n";
+
+/**
+ * the default options.
+ */
+const uint64_t DEFAULT_GAMES = 10000;
+const int DEFAULT_SIZE = 10;
+
+/**
+ * @brief a strategy that can be chosen from the command line.
+ * @name the name of the strategy
+ * @choose the strategy
+ */
+typedef struct NamedStrategy
+{
+    const char *name;
+    ShotStrategy choose;
+} NamedStrategy;
+
+/**
+ * @brief a work stealing deque of chunks. the chunks of the deque are first + [top, bottom), the
+ * owner takes from the bottom and the thieves from the top.
+ */
+typedef struct ChunkDeque
+{
+    long top;
+    char topPadding[CACHE_LINE - sizeof(long)];
+    long bottom;
+    long first;
+} __attribute__((aligned(CACHE_LINE))) ChunkDeque;
+
+/**
+ * @brief the statistics of the games.
+ * @tally the shots of the games
+ * @steals the number of chunks that were stolen
+ * @boardAllocations the board blocks that were allocated (see pool.h)
+ * @boardReuses the board blocks that were taken from the pools of the threads
+ */
+typedef struct Statistics
+{
+    ShotTally tally;
+    uint64_t steals;
+    uint64_t boardAllocations;
+    uint64_t boardReuses;
+} Statistics;
+
+/**
+ * @brief a simulation thread.
+ * @thread the thread
+ * @index the index of the thread
+ * @stats the statistics of the games of the thread
+ */
+typedef struct Player
+{
+    pthread_t thread;
+    int index;
+    Statistics stats;
+} __attribute__((aligned(CACHE_LINE))) Player;
+
+/**
+ * @brief the options of the simulation.
+ * @games the number of games per thread
+ * @numOfThreads the number of threads
+ * @size the size of the boards
+ * @seed the seed of the first game
+ * @strategy the shot strategy
+ * @fleet the fleet of the games, NULL for the standard fleet (points to fleetBuffer otherwise)
+ * @fleetBuffer the fleet from the command line
+ */
+typedef struct SimulateOptions
+{
+    uint64_t games;
+    int numOfThreads;
+    int size;
+    uint64_t seed;
+    ShotStrategy strategy;
+    const Fleet *fleet;
+    Fleet fleetBuffer;
+} SimulateOptions;
+
+/**
+ * the options, the deques of all the threads and the totals. they are set before the threads
+ * start (the totals are only changed with atomic adds).
+ */
+SimulateOptions options;
+ChunkDeque deques[MAX_THREADS];
+long numOfChunks;
+Statistics totals;
+int placementFlag = TRUE;
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * @brief the strategies that can be chosen from the command line.
+ */
+const NamedStrategy STRATEGIES[] = {
+        {"ai", aiStrategy},
+        {"random", randomStrategy},
+        {"sweep", sweepStrategy}
+};
+
+/**
+ * this function takes a chunk from the bottom of the deque of the thread. only the owner of the
+ * deque calls it.
+ * @param deque : the deque
+ * @return the chunk, or NO_CHUNK if the deque is empty
+ */
+long popChunk(ChunkDeque *deque)
+{
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&deque->bottom, bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+    if (top > bottom)
+    { // empty
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return NO_CHUNK;
+    }
+    if (top == bottom)
+    { // the last chunk, a thief may take it at the same time
+        int isTaken = __atomic_compare_exchange_n(&deque->top, &top, top + 1, 0,
+                                                  __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return isTaken ? deque->first + bottom : NO_CHUNK;
+    }
+    return deque->first + bottom;
+}
+
+/**
+ * this function steals a chunk from the top of the deque of another thread.
+ * @param deque : the deque
+ * @return the chunk, NO_CHUNK if the deque is empty or STEAL_RETRY if another thread took the
+ * chunk first
+ */
+long stealChunk(ChunkDeque *deque)
+{
+    long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+    if (top >= bottom)
+    {
+        return NO_CHUNK;
+    }
+    if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, 0, __ATOMIC_SEQ_CST,
+                                     __ATOMIC_RELAXED))
+    {
+        return STEAL_RETRY;
+    }
+    return deque->first + top;
+}
+
+/**
+ * this function finds the next chunk for a thread- from its own deque, or stolen from the others.
+ * @param player : the thread
+ * @param rng : picks the first thread to steal from
+ * @return the chunk, or NO_CHUNK if all the chunks were taken
+ */
+long nextChunk(Player *player, Rng *rng)
+{
+    long chunk = popChunk(&deques[player->index]);
+    if (chunk != NO_CHUNK)
+    {
+        return chunk;
+    }
+    int start = (int) rngBounded(rng, (uint32_t) options.numOfThreads);
+    int i;
+    for (i = 0 ; i < options.numOfThreads ; ++i)
+    {
+        int victim = (start + i) % options.numOfThreads;
+        if (victim == player->index)
+        {
+            continue;
+        }
+        do
+        {
+            chunk = stealChunk(&deques[victim]);
+        } while (chunk == STEAL_RETRY);
+        if (chunk != NO_CHUNK)
+        {
+            player->stats.steals++;
+            return chunk;
+        }
+    }
+    return NO_CHUNK;
+}
+
+/**
+ * this function plays a single complete game.
+ * @param seed : the seed of the game
+ * @param stats : the statistics to add the game to
+ * @return TRUE if the game was played, the flag of initGame if it could not start
+ */
+int playSimulatedGame(const uint64_t seed, Statistics *stats)
+{
+    Game game;
+    int initFlag = initGame(&game, options.size, options.fleet, seed);
+    if (initFlag != TRUE)
+    {
+        return initFlag;
+    }
+    Rng rng;
+    rngSeed(&rng, ~seed);
+    int row, column;
+    while (game.status != WIN_GAME && options.strategy(&game, &rng, &row, &column) == TRUE)
+    {
+        placeMove(row, column, &game);
+    }
+    tallyShots(&stats->tally, (uint64_t) game.numOfMoves);
+    freeGame(&game);
+    return TRUE;
+}
+
+/**
+ * this function adds the statistics of a thread to the totals.
+ * @param stats : the statistics of the thread
+ */
+void mergeStatistics(const Statistics *stats)
+{
+    int i;
+    __atomic_fetch_add(&totals.tally.games, stats->tally.games, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&totals.tally.shots, stats->tally.shots, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&totals.tally.shotsSquares, stats->tally.shotsSquares, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&totals.steals, stats->steals, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&totals.boardAllocations, stats->boardAllocations, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&totals.boardReuses, stats->boardReuses, __ATOMIC_RELAXED);
+    for (i = 0 ; i <= MAX_SHOTS ; ++i)
+    {
+        if (stats->tally.histogram[i] != 0)
+        {
+            __atomic_fetch_add(&totals.tally.histogram[i], stats->tally.histogram[i],
+                               __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/**
+ * this function is the main function of a simulation thread.
+ * @param arg : the Player of the thread
+ * @return NULL
+ */
+void *runPlayer(void *arg)
+{
+    Player *player = (Player *) arg;
+    Rng rng;
+    rngSeed(&rng, options.seed ^ (uint64_t) player->index);
+    uint64_t totalGames = options.games * (uint64_t) options.numOfThreads;
+    long chunk;
+    while (__atomic_load_n(&placementFlag, __ATOMIC_RELAXED) == TRUE &&
+           (chunk = nextChunk(player, &rng)) != NO_CHUNK)
+    {
+        uint64_t game = (uint64_t) chunk * CHUNK_GAMES;
+        uint64_t end = game + CHUNK_GAMES < totalGames ? game + CHUNK_GAMES : totalGames;
+        for ( ; game < end ; ++game)
+        {
+            int playFlag = playSimulatedGame(options.seed + game, &player->stats);
+            if (playFlag != TRUE)
+            {
+                __atomic_store_n(&placementFlag, playFlag, __ATOMIC_RELAXED);
+                break;
+            }
+        }
+    }
+    PoolStats poolStats = readBoardPoolStats();
+    player->stats.boardAllocations = poolStats.heapAllocations;
+    player->stats.boardReuses = poolStats.reuses;
+    drainBoardPool();
+    mergeStatistics(&player->stats);
+    return NULL;
+}
+
+/**
+ * this function deals the chunks evenly to the deques of the threads.
+ */
+void dealChunks(void)
+{
+    uint64_t totalGames = options.games * (uint64_t) options.numOfThreads;
+    numOfChunks = (long) ((totalGames + CHUNK_GAMES - 1) / CHUNK_GAMES);
+    int i;
+    for (i = 0 ; i < options.numOfThreads ; ++i)
+    {
+        long first = numOfChunks * i / options.numOfThreads;
+        long last = numOfChunks * (i + 1) / options.numOfThreads;
+        deques[i].first = first;
+        deques[i].top = 0;
+        deques[i].bottom = last - first;
+    }
+}
+
+/**
+ * this function prints the statistics of the simulation.
+ * @param seconds : the time the simulation took
+ * @param strategyName : the name of the strategy
+ */
+void printStatistics(const double seconds, const char *strategyName)
+{
+    const ShotTally *tally = &totals.tally;
+    double mean, deviation;
+    shotsMeanDeviation(tally, &mean, &deviation);
+    printf("strategy %s, size %d, %d threads\n", strategyName, options.size,
+           options.numOfThreads);
+    printf("games   %" PRIu64 " (%.0f games/s, %" PRIu64 " chunks stolen)\n", tally->games,
+           (double) tally->games / seconds, totals.steals);
+    printf("shots   mean %.3f, std %.3f\n", mean, deviation);
+    printf("shots   min %d, p50 %d, p90 %d, p99 %d, max %d\n", shotsPercentile(tally, 0),
+           shotsPercentile(tally, 0.5), shotsPercentile(tally, 0.9), shotsPercentile(tally, 0.99),
+           shotsPercentile(tally, 1));
+    printf("boards  %" PRIu64 " allocated, %" PRIu64 " reused\n", totals.boardAllocations,
+           totals.boardReuses);
+}
+
+/**
+ * this function reads the options of the simulation from the command line.
+ * @param argc : the number of the arguments
+ * @param argv : the arguments
+ * @param strategyName : will be set to the name of the strategy
+ * @return TRUE if the arguments are valid, FALSE otherwise
+ */
+int parseSimulateArguments(const int argc, char *argv[], const char **strategyName)
+{
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    options.games = DEFAULT_GAMES;
+    options.numOfThreads = (processors < 1) ? 1 : (processors > MAX_THREADS) ? MAX_THREADS :
+                                                 (int) processors;
+    options.size = DEFAULT_SIZE;
+    options.seed = (uint64_t) time(NULL) ^ ((uint64_t) getpid() << 32);
+    options.strategy = STRATEGIES[0].choose;
+    options.fleet = NULL;
+    *strategyName = STRATEGIES[0].name;
+    uint64_t number;
+    int i, j;
+    for (i = 1 ; i + 1 < argc ; i += 2)
+    {
+        const char *value = argv[i + 1];
+        if (strcmp(argv[i], "--strategy") == 0)
+        {
+            options.strategy = NULL;
+            for (j = 0 ; j < (int) (sizeof(STRATEGIES) / sizeof(STRATEGIES[0])) ; ++j)
+            {
+                if (strcmp(value, STRATEGIES[j].name) == 0)
+                {
+                    options.strategy = STRATEGIES[j].choose;
+                    *strategyName = STRATEGIES[j].name;
+                }
+            }
+            if (options.strategy == NULL)
+            {
+                return FALSE;
+            }
+        }
+        else if (strcmp(argv[i], "--fleet") == 0)
+        {
+            if (parseFleet(value, (int) strlen(value), &options.fleetBuffer) != PARSE_OK)
+            {
+                return FALSE;
+            }
+            options.fleet = &options.fleetBuffer;
+        }
+        else if (strcmp(argv[i], "--stats") == 0)
+        {
+            if (reportStatsAtExit(value) == FALSE)
+            {
+                return FALSE;
+            }
+        }
+        else if (parseCount(value, &number) == FALSE)
+        {
+            return FALSE;
+        }
+        else if (strcmp(argv[i], "--games") == 0 && number > 0)
+        {
+            options.games = number;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && number > 0 && number <= MAX_THREADS)
+        {
+            options.numOfThreads = (int) number;
+        }
+        else if (strcmp(argv[i], "--size") == 0 && isValidSize((int) number) == TRUE &&
+                 number <= BITBOARD_MAX_SIDE)
+        {
+            options.size = (int) number;
+        }
+        else if (strcmp(argv[i], "--seed") == 0)
+        {
+            options.seed = number;
+        }
+        else
+        {
+            return FALSE;
+        }
+    }
+    if (options.fleet != NULL && isValidFleet(options.fleet, options.size) == FALSE)
+    {
+        return FALSE;
+    }
+    return (i == argc) ? TRUE : FALSE;
+}
+
+/**
+ * the main function of the simulator.
+ * @param argc : the number of the arguments
+ * @param argv : the arguments (see SIMULATE_USAGE_MSG)
+ * @return 0 on success, 1 if the arguments are not valid or the simulation failed
+ */
+int main(int argc, char *argv[])
+{
+    const char *strategyName;
+    if (parseSimulateArguments(argc, argv, &strategyName) == FALSE)
+    {
+        fprintf(stderr, SIMULATE_USAGE_MSG);
+        return 1;
+    }
+    static Player players[MAX_THREADS];
+    dealChunks();
+    uint64_t start = statsNanos();
+    int i;
+    for (i = 0 ; i < options.numOfThreads ; ++i)
+    {
+        players[i].index = i;
+        if (pthread_create(&players[i].thread, NULL, runPlayer, &players[i]) != 0)
+        {
+            perror(SIMULATE_START_ERROR_MSG);
+            return 1;
+        }
+    }
+    for (i = 0 ; i < options.numOfThreads ; ++i)
+    {
+        pthread_join(players[i].thread, NULL);
+    }
+    double seconds = (double) (statsNanos() - start) / 1e9;
+    if (placementFlag != TRUE)
+    {
+        fprintf(stderr, (placementFlag == PLACEMENT_TIMEOUT) ? SIMULATE_TIMEOUT_ERROR_MSG :
+                        SIMULATE_PLACEMENT_ERROR_MSG, options.size);
+        return 1;
+    }
+    printStatistics(seconds, strategyName);
+    return 0;
+}
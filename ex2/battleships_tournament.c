@@ -0,0 +1,684 @@
+// ------------------------------ includes ------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "battleships.h"
+#include "input.h"
+#include "stats.h"
+#include "pool.h"
+#include "selfplay.h"
+#include "strategy.h"
+
+/**
+ * @file battleships_tournament.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the strategy tournament. every strategy plays the same layouts, on all the cores, and the
+ * tournament reports the shots to win and the decision latency of every strategy.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * the strategies are the ones built in (ai, random and sweep) and shared objects with the ABI of
+ * strategy.h, loaded with dlopen. layout number i is the layout placeShips gives for the seed of
+ * the run plus i, and every strategy plays it in turn (restartGame places it again for each one),
+ * so the strategies are compared on exactly the same boards no matter how many threads there are.
+ * the layouts are cut to chunks that the threads take with an atomic counter. every thread has its
+ * own game, its own view of it for the strategies and its own state of every strategy, and keeps
+ * its own results, which are summed when all the threads are done.
+ * a strategy that shoots more shots than there are cells, or has no shot, loses the game.
+ * Input  : the options from the command line
+ * Process: plays the games
+ * Output : the results of every strategy
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the number of layouts in a chunk- the unit of work of a thread.
+ */
+#define CHUNK_LAYOUTS 64
+
+/**
+ * the limit for the strategies.
+ */
+#define MAX_STRATEGIES 16
+
+/**
+ * the separator of the strategies on the command line.
+ */
+#define STRATEGY_SEPARATOR ','
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the command line arguments are not valid
+ */
+const char *TOURNAMENT_USAGE_MSG =
+        "usage: ex2_tournament [--strategies <name or path>,...] [--games <layouts>] "
+        "[--threads <number>] [--size <number>] [--seed <number>] [--fleet <lengths>]\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that a strategy can't be loaded
+ */
+const char *TOURNAMENT_LOAD_ERROR_MSG = "can't load the strategy %s: %s\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that a strategy was built for another ABI
+ */
+const char *TOURNAMENT_ABI_ERROR_MSG = "the strategy %s has ABI version %u, not %u\n";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the threads can't start
+ */
+const char *TOURNAMENT_START_ERROR_MSG = "failed to start the threads";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that a strategy could not start or the fleet could not be
+ * placed
+ */
+const char *TOURNAMENT_FAILED_MSG = "the tournament failed: %s\n";
+
+/**
+ * the default options.
+ */
+const uint64_t DEFAULT_LAYOUTS = 10000;
+const int DEFAULT_SIZE = 10;
+const char *DEFAULT_STRATEGIES = "ai,random,sweep";
+
+/**
+ * @brief the results of a strategy.
+ * @games the number of games
+ * @won the shots of the games that were won
+ * @decisions the latencies of chooseShot in nano seconds
+ */
+typedef struct Standing
+{
+    uint64_t games;
+    ShotTally won;
+    Histogram decisions;
+} Standing;
+
+/**
+ * @brief a thread of the tournament.
+ * @thread the thread
+ * @standings the results of the strategies in the games of the thread
+ */
+typedef struct Referee
+{
+    pthread_t thread;
+    Standing *standings;
+} Referee;
+
+/**
+ * @brief the options of the tournament.
+ * @layouts the number of layouts
+ * @numOfThreads the number of threads
+ * @size the size of the boards
+ * @seed the seed of the first layout
+ * @fleet the fleet of the games, NULL for the standard fleet (points to fleetBuffer otherwise)
+ * @fleetBuffer the fleet from the command line
+ * @numOfStrategies the number of strategies
+ * @strategies the strategies
+ */
+typedef struct TournamentOptions
+{
+    uint64_t layouts;
+    int numOfThreads;
+    int size;
+    uint64_t seed;
+    const Fleet *fleet;
+    Fleet fleetBuffer;
+    int numOfStrategies;
+    const StrategyPlugin *strategies[MAX_STRATEGIES];
+} TournamentOptions;
+
+/**
+ * the options and the next chunk. they are set before the threads start (the next chunk is only
+ * changed with atomic adds). failure is the reason the tournament stopped, NULL while it runs.
+ */
+TournamentOptions options;
+uint64_t nextChunk = 0;
+const char *failure = NULL;
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function starts the built in strategies that keep no state.
+ * @param game : not used
+ * @return a state that is not NULL
+ */
+void *initStateless(const StrategyGame *game)
+{
+    (void) game;
+    return &options;
+}
+
+/**
+ * this function is the strategy of the computer player (see ai.h), on the game of the engine.
+ * @param state : not used
+ * @param game : the game
+ * @param row : will be set to the row of the shot
+ * @param column : will be set to the column of the shot
+ * @return STRATEGY_OK, or STRATEGY_NO_SHOT if there is no cell left to shoot at
+ */
+int chooseAiShot(void *state, const StrategyGame *game, int *row, int *column)
+{
+    (void) state;
+    return (aiStrategy((const Game *) game->engine, NULL, row, column) == TRUE) ? STRATEGY_OK :
+           STRATEGY_NO_SHOT;
+}
+
+/**
+ * this function makes the rng of the random strategy.
+ * @param game : not used
+ * @return the rng, or NULL if out of memory
+ */
+void *initRandom(const StrategyGame *game)
+{
+    (void) game;
+    return malloc(sizeof(Rng));
+}
+
+/**
+ * this function is the random strategy (see selfplay.h), on the game of the engine. its rng is
+ * seeded with the seed of the game when the game starts.
+ * @param state : the rng
+ * @param game : the game
+ * @param row : will be set to the row of the shot
+ * @param column : will be set to the column of the shot
+ * @return STRATEGY_OK, or STRATEGY_NO_SHOT if there is no cell left to shoot at
+ */
+int chooseRandomShot(void *state, const StrategyGame *game, int *row, int *column)
+{
+    Rng *rng = (Rng *) state;
+    if (game->numOfMoves == 0)
+    {
+        rngSeed(rng, game->seed);
+    }
+    return (randomStrategy((const Game *) game->engine, rng, row, column) == TRUE) ?
+           STRATEGY_OK : STRATEGY_NO_SHOT;
+}
+
+/**
+ * this function is the sweep strategy (see selfplay.h), on the game of the engine.
+ * @param state : not used
+ * @param game : the game
+ * @param row : will be set to the row of the shot
+ * @param column : will be set to the column of the shot
+ * @return STRATEGY_OK, or STRATEGY_NO_SHOT if there is no cell left to shoot at
+ */
+int chooseSweepShot(void *state, const StrategyGame *game, int *row, int *column)
+{
+    (void) state;
+    return (sweepStrategy((const Game *) game->engine, NULL, row, column) == TRUE) ?
+           STRATEGY_OK : STRATEGY_NO_SHOT;
+}
+
+/**
+ * @brief the strategies that are built in.
+ */
+const StrategyPlugin BUILT_IN_STRATEGIES[] = {
+        {STRATEGY_ABI_VERSION, "ai", initStateless, chooseAiShot, NULL, NULL},
+        {STRATEGY_ABI_VERSION, "random", initRandom, chooseRandomShot, NULL, free},
+        {STRATEGY_ABI_VERSION, "sweep", initStateless, chooseSweepShot, NULL, NULL}
+};
+
+/**
+ * this function finds a built in strategy, or loads a strategy from a shared object.
+ * @param name : the name of the strategy, or the path of the shared object
+ * @return the strategy, or NULL if it can't be loaded (the reason is printed)
+ */
+const StrategyPlugin *loadStrategy(const char *name)
+{
+    int i;
+    for (i = 0 ; i < (int) (sizeof(BUILT_IN_STRATEGIES) / sizeof(BUILT_IN_STRATEGIES[0])) ; ++i)
+    {
+        if (strcmp(name, BUILT_IN_STRATEGIES[i].name) == 0)
+        {
+            return &BUILT_IN_STRATEGIES[i];
+        }
+    }
+    void *handle = dlopen(name, RTLD_NOW | RTLD_LOCAL); // never closed, it is used to the end
+    if (handle == NULL)
+    {
+        fprintf(stderr, TOURNAMENT_LOAD_ERROR_MSG, name, dlerror());
+        return NULL;
+    }
+    StrategyEntry entry;
+    *(void **) &entry = dlsym(handle, STRATEGY_ENTRY); // dlsym gives an object pointer
+    const StrategyPlugin *plugin = (entry != NULL) ? entry() : NULL;
+    if (plugin != NULL && plugin->abiVersion != STRATEGY_ABI_VERSION)
+    { // the other fields of another version may not be where this version has them
+        fprintf(stderr, TOURNAMENT_ABI_ERROR_MSG, name, plugin->abiVersion,
+                STRATEGY_ABI_VERSION);
+        return NULL;
+    }
+    if (plugin == NULL || plugin->init == NULL || plugin->chooseShot == NULL)
+    {
+        fprintf(stderr, TOURNAMENT_LOAD_ERROR_MSG, name, "no " STRATEGY_ENTRY " with callbacks");
+        return NULL;
+    }
+    return plugin;
+}
+
+/**
+ * this function gives the Game of the engine for the view of a strategy- only a built in strategy
+ * gets it, a plug-in doesn't.
+ * @param strategy : the strategy
+ * @param game : the game of the thread
+ * @return the game, or NULL for a plug-in
+ */
+const void *engineOfStrategy(const StrategyPlugin *strategy, const Game *game)
+{
+    int i;
+    for (i = 0 ; i < (int) (sizeof(BUILT_IN_STRATEGIES) / sizeof(BUILT_IN_STRATEGIES[0])) ; ++i)
+    {
+        if (strategy == &BUILT_IN_STRATEGIES[i])
+        {
+            return game;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * this function loads the strategies from their list on the command line.
+ * @param list : the names or the paths of the strategies, separated by STRATEGY_SEPARATOR
+ * @return TRUE if all of them were loaded, FALSE otherwise
+ */
+int loadStrategies(const char *list)
+{
+    char name[PATH_MAX];
+    options.numOfStrategies = 0;
+    while (*list != '\0')
+    {
+        const char *end = strchr(list, STRATEGY_SEPARATOR);
+        size_t length = (end != NULL) ? (size_t) (end - list) : strlen(list);
+        if (length == 0 || length >= sizeof(name) || options.numOfStrategies == MAX_STRATEGIES)
+        {
+            return FALSE;
+        }
+        memcpy(name, list, length);
+        name[length] = '\0';
+        const StrategyPlugin *plugin = loadStrategy(name);
+        if (plugin == NULL)
+        {
+            return FALSE;
+        }
+        options.strategies[options.numOfStrategies++] = plugin;
+        list += length + ((end != NULL) ? 1 : 0);
+    }
+    return (options.numOfStrategies > 0) ? TRUE : FALSE;
+}
+
+/**
+ * this function marks the cells of a ship that was sunk on the view of the game.
+ * @param game : the game
+ * @param shipIndex : the index of the ship
+ * @param cells : the view of the cells
+ * @param shipSunk : the sunk flags of the view
+ */
+void markSunkShip(const Game *game, const int shipIndex, unsigned char *cells,
+                  unsigned char *shipSunk)
+{
+    const ShipRegistry *ships = &game->ships;
+    const Direction *direction = &directions[ships->orientation[shipIndex]];
+    int i;
+    for (i = 0 ; i < ships->length[shipIndex] ; ++i)
+    {
+        int row = ships->row[shipIndex] + i * direction->addToRow;
+        int col = ships->column[shipIndex] + i * direction->addToColumn;
+        cells[row * game->gameBoard.size + col] = VIEW_SUNK;
+    }
+    shipSunk[shipIndex] = 1;
+}
+
+/**
+ * this function plays a single game of a strategy on the layout the game has.
+ * @param strategy : the strategy
+ * @param state : the state of the strategy in the thread
+ * @param game : the game, with a new layout
+ * @param view : the view of the game for the strategy
+ * @param standing : the results of the strategy
+ */
+void playStrategyGame(const StrategyPlugin *strategy, void *state, Game *game,
+                      StrategyGame *view, Standing *standing)
+{
+    unsigned char *cells = (unsigned char *) view->cells;
+    unsigned char *shipSunk = (unsigned char *) view->shipSunk;
+    int numOfCells = view->size * view->size;
+    memset(cells, VIEW_UNKNOWN, (size_t) numOfCells);
+    memset(shipSunk, 0, (size_t) view->numOfShips);
+    view->numOfMoves = 0;
+    StrategyResult result = RESULT_MISS;
+    int row, column;
+    while (result != RESULT_WIN && view->numOfMoves < numOfCells)
+    {
+        uint64_t start = statsNanos();
+        int chooseFlag = strategy->chooseShot(state, view, &row, &column);
+        addLatency(&standing->decisions, statsNanos() - start);
+        if (chooseFlag != STRATEGY_OK)
+        {
+            break;
+        }
+        MoveResult moveResult = stepGame(game, row, column); // a plug-in may shoot off the board
+        view->numOfMoves++;
+        int cell = row * view->size + column;
+        switch (moveResult)
+        {
+            case MOVE_MISS:
+                cells[cell] = VIEW_MISS;
+                result = RESULT_MISS;
+                break;
+            case MOVE_HIT:
+                cells[cell] = VIEW_HIT;
+                result = RESULT_HIT;
+                break;
+            case MOVE_SUNK:
+            case MOVE_WIN:
+                markSunkShip(game, CELL_SHIP(CELL_AT(&game->gameBoard, row, column)), cells,
+                             shipSunk);
+                result = (moveResult == MOVE_WIN) ? RESULT_WIN : RESULT_SUNK;
+                break;
+            default: // a repeated shot or a shot out of the board is a wasted shot
+                result = RESULT_MISS;
+                break;
+        }
+        if (strategy->observeResult != NULL)
+        {
+            strategy->observeResult(state, view, row, column, result);
+        }
+    }
+    standing->games++;
+    if (result == RESULT_WIN)
+    {
+        tallyShots(&standing->won, (uint64_t) view->numOfMoves);
+    }
+}
+
+/**
+ * this function gives the reason the tournament stopped for a layout that could not be placed.
+ * @param placeFlag : the flag of initGame or restartGame
+ * @return the reason
+ */
+const char *placementFailure(const int placeFlag)
+{
+    return (placeFlag == PLACEMENT_TIMEOUT) ? "no layout of the fleet was found in time" :
+           "the fleet could not be placed";
+}
+
+/**
+ * this function plays the games of the chunks a thread takes.
+ * @param referee : the thread
+ * @param game : the game of the thread
+ * @param view : the view of the game for the strategies
+ * @param states : the states of the strategies in the thread
+ */
+void playChunks(Referee *referee, Game *game, StrategyGame *view, void **states)
+{
+    uint64_t layout;
+    int i;
+    while (__atomic_load_n(&failure, __ATOMIC_RELAXED) == NULL &&
+           (layout = __atomic_fetch_add(&nextChunk, 1, __ATOMIC_RELAXED) * CHUNK_LAYOUTS) <
+           options.layouts)
+    {
+        uint64_t end = (layout + CHUNK_LAYOUTS < options.layouts) ? layout + CHUNK_LAYOUTS :
+                       options.layouts;
+        for ( ; layout < end ; ++layout)
+        {
+            for (i = 0 ; i < options.numOfStrategies ; ++i)
+            {
+                int placeFlag = restartGame(game, options.seed + layout);
+                if (placeFlag != TRUE)
+                {
+                    __atomic_store_n(&failure, placementFailure(placeFlag), __ATOMIC_RELAXED);
+                    return;
+                }
+                view->seed = ~(options.seed + layout);
+                view->engine = engineOfStrategy(options.strategies[i], game);
+                playStrategyGame(options.strategies[i], states[i], game, view,
+                                 &referee->standings[i]);
+            }
+        }
+    }
+}
+
+/**
+ * this function is the main function of a tournament thread.
+ * @param arg : the Referee of the thread
+ * @return NULL
+ */
+void *runReferee(void *arg)
+{
+    Referee *referee = (Referee *) arg;
+    unsigned char cells[MAX_SHOTS];
+    unsigned char shipSunk[MAX_FLEET_SHIPS];
+    void *states[MAX_STRATEGIES] = {NULL};
+    Game game;
+    int initFlag = initGame(&game, options.size, options.fleet, options.seed);
+    if (initFlag != TRUE)
+    {
+        __atomic_store_n(&failure, placementFailure(initFlag), __ATOMIC_RELAXED);
+        return NULL;
+    }
+    StrategyGame view;
+    view.size = options.size;
+    view.numOfShips = game.ships.numOfShips;
+    view.shipLengths = game.ships.length;
+    view.shipSunk = shipSunk;
+    view.cells = cells;
+    view.numOfMoves = 0;
+    view.seed = ~options.seed;
+    view.engine = NULL;
+    memset(cells, VIEW_UNKNOWN, sizeof(cells));
+    memset(shipSunk, 0, sizeof(shipSunk));
+    int i;
+    for (i = 0 ; i < options.numOfStrategies ; ++i)
+    {
+        view.engine = engineOfStrategy(options.strategies[i], &game);
+        states[i] = options.strategies[i]->init(&view);
+        if (states[i] == NULL)
+        {
+            __atomic_store_n(&failure, "a strategy failed to start", __ATOMIC_RELAXED);
+            break;
+        }
+    }
+    if (i == options.numOfStrategies)
+    {
+        playChunks(referee, &game, &view, states);
+    }
+    for (i = 0 ; i < options.numOfStrategies ; ++i)
+    {
+        if (states[i] != NULL && options.strategies[i]->release != NULL)
+        {
+            options.strategies[i]->release(states[i]);
+        }
+    }
+    freeGame(&game);
+    drainBoardPool();
+    return NULL;
+}
+
+/**
+ * this function adds the results of a strategy in a thread to its totals.
+ * @param total : the totals
+ * @param standing : the results in the thread
+ */
+void addStanding(Standing *total, const Standing *standing)
+{
+    int i;
+    total->games += standing->games;
+    addShotTally(&total->won, &standing->won);
+    total->decisions.count += standing->decisions.count;
+    total->decisions.sum += standing->decisions.sum;
+    if (standing->decisions.max > total->decisions.max)
+    {
+        total->decisions.max = standing->decisions.max;
+    }
+    for (i = 0 ; i < STAT_BUCKETS ; ++i)
+    {
+        total->decisions.buckets[i] += standing->decisions.buckets[i];
+    }
+}
+
+/**
+ * this function prints the results of a strategy.
+ * @param name : the name of the strategy
+ * @param standing : the results
+ */
+void printStanding(const char *name, const Standing *standing)
+{
+    const Histogram *decisions = &standing->decisions;
+    const ShotTally *won = &standing->won;
+    printf("%-16s won %" PRIu64 "/%" PRIu64, name, won->games, standing->games);
+    if (won->games > 0)
+    {
+        double mean, deviation;
+        shotsMeanDeviation(won, &mean, &deviation);
+        printf(", shots mean %.3f, std %.3f, min %d, p50 %d, p90 %d, p99 %d, max %d", mean,
+               deviation, shotsPercentile(won, 0), shotsPercentile(won, 0.5),
+               shotsPercentile(won, 0.9), shotsPercentile(won, 0.99), shotsPercentile(won, 1));
+    }
+    printf("\n");
+    if (decisions->count > 0)
+    {
+        printf("%-16s decision mean %.1f ns, p50 %" PRIu64 " ns, p99 %" PRIu64 " ns, max %"
+               PRIu64 " ns\n", "", (double) decisions->sum / (double) decisions->count,
+               histogramPercentile(decisions, 0.5), histogramPercentile(decisions, 0.99),
+               decisions->max);
+    }
+}
+
+/**
+ * this function reads the options of the tournament from the command line.
+ * @param argc : the number of the arguments
+ * @param argv : the arguments
+ * @return TRUE if the arguments are valid, FALSE otherwise
+ */
+int parseTournamentArguments(const int argc, char *argv[])
+{
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    options.layouts = DEFAULT_LAYOUTS;
+    options.numOfThreads = (processors < 1) ? 1 : (processors > MAX_THREADS) ? MAX_THREADS :
+                                                 (int) processors;
+    options.size = DEFAULT_SIZE;
+    options.seed = (uint64_t) time(NULL) ^ ((uint64_t) getpid() << 32);
+    options.fleet = NULL;
+    const char *strategies = DEFAULT_STRATEGIES;
+    uint64_t number;
+    int i;
+    for (i = 1 ; i + 1 < argc ; i += 2)
+    {
+        const char *value = argv[i + 1];
+        if (strcmp(argv[i], "--strategies") == 0)
+        {
+            strategies = value;
+        }
+        else if (strcmp(argv[i], "--fleet") == 0)
+        {
+            if (parseFleet(value, (int) strlen(value), &options.fleetBuffer) != PARSE_OK)
+            {
+                return FALSE;
+            }
+            options.fleet = &options.fleetBuffer;
+        }
+        else if (parseCount(value, &number) == FALSE)
+        {
+            return FALSE;
+        }
+        else if (strcmp(argv[i], "--games") == 0 && number > 0)
+        {
+            options.layouts = number;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && number > 0 && number <= MAX_THREADS)
+        {
+            options.numOfThreads = (int) number;
+        }
+        else if (strcmp(argv[i], "--size") == 0 && isValidSize((int) number) == TRUE)
+        {
+            options.size = (int) number;
+        }
+        else if (strcmp(argv[i], "--seed") == 0)
+        {
+            options.seed = number;
+        }
+        else
+        {
+            return FALSE;
+        }
+    }
+    if (i != argc || (options.fleet != NULL && isValidFleet(options.fleet, options.size) == FALSE))
+    {
+        return FALSE;
+    }
+    return loadStrategies(strategies);
+}
+
+/**
+ * the main function of the tournament.
+ * @param argc : the number of the arguments
+ * @param argv : the arguments (see TOURNAMENT_USAGE_MSG)
+ * @return 0 on success, 1 if the arguments are not valid or the tournament failed
+ */
+int main(int argc, char *argv[])
+{
+    if (parseTournamentArguments(argc, argv) == FALSE)
+    {
+        fprintf(stderr, TOURNAMENT_USAGE_MSG);
+        return 1;
+    }
+    static Referee referees[MAX_THREADS];
+    static Standing totals[MAX_STRATEGIES];
+    uint64_t start = statsNanos();
+    int i, j;
+    for (i = 0 ; i < options.numOfThreads ; ++i)
+    {
+        referees[i].standings = (Standing *) calloc((size_t) options.numOfStrategies,
+                                                    sizeof(Standing));
+        if (referees[i].standings == NULL ||
+            pthread_create(&referees[i].thread, NULL, runReferee, &referees[i]) != 0)
+        {
+            perror(TOURNAMENT_START_ERROR_MSG);
+            return 1;
+        }
+    }
+    for (i = 0 ; i < options.numOfThreads ; ++i)
+    {
+        pthread_join(referees[i].thread, NULL);
+        for (j = 0 ; j < options.numOfStrategies ; ++j)
+        {
+            addStanding(&totals[j], &referees[i].standings[j]);
+        }
+        free(referees[i].standings);
+    }
+    double seconds = (double) (statsNanos() - start) / 1e9;
+    if (failure != NULL)
+    {
+        fprintf(stderr, TOURNAMENT_FAILED_MSG, failure);
+        return 1;
+    }
+    printf("tournament of %d strategies, size %d, %" PRIu64 " layouts, %d threads, %.3f s\n",
+           options.numOfStrategies, options.size, options.layouts, options.numOfThreads,
+           seconds);
+    for (j = 0 ; j < options.numOfStrategies ; ++j)
+    {
+        printStanding(options.strategies[j]->name, &totals[j]);
+    }
+    return 0;
+}
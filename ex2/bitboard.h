@@ -0,0 +1,158 @@
+/**
+ * @file bitboard.h
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief a fixed size bitset of the cells of the game board. the cell in (row, col) is the bit
+ * number row * size + col. a full board of BITBOARD_MAX_SIDE x BITBOARD_MAX_SIDE cells fits in
+ * BITBOARD_WORDS 64 bit words, so every set operation is a short loop of word wide AND/OR.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * the occupancy of every ship and the hits and misses of the user are kept as bitboards.
+ * the functions here are small and used in the hot path of the game so they are all inline.
+ * note that the queries return counts of bits (0 means none) and not the TRUE/FALSE flags.
+ */
+
+#ifndef EX2_BITBOARD_H
+#define EX2_BITBOARD_H
+
+#include <stdint.h>
+#include <string.h>
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the largest side of a board that the bitboard can hold, and the number of words it takes.
+ */
+#define BITBOARD_MAX_SIDE 26
+#define BITBOARD_WORD_BITS 64
+#define BITBOARD_WORDS ((BITBOARD_MAX_SIDE * BITBOARD_MAX_SIDE + BITBOARD_WORD_BITS - 1) / \
+                        BITBOARD_WORD_BITS)
+
+/**
+ * @brief a set of cells on the board, one bit per cell.
+ * @words the bits of the cells, cell number i is bit (i % 64) of words[i / 64]
+ */
+typedef struct BitBoard
+{
+    uint64_t words[BITBOARD_WORDS];
+} BitBoard;
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function empties the bitboard.
+ * @param bitBoard : the bitboard to clear
+ */
+static inline void bitBoardClear(BitBoard *bitBoard)
+{
+    memset(bitBoard->words, 0, sizeof(bitBoard->words));
+}
+
+/**
+ * this function adds a cell to the bitboard.
+ * @param bitBoard : the bitboard
+ * @param index : the number of the cell (row * size + col)
+ */
+static inline void bitBoardSet(BitBoard *bitBoard, const int index)
+{
+    bitBoard->words[index / BITBOARD_WORD_BITS] |= (uint64_t) 1 << (index % BITBOARD_WORD_BITS);
+}
+
+/**
+ * this function checks if a cell is in the bitboard.
+ * @param bitBoard : the bitboard
+ * @param index : the number of the cell (row * size + col)
+ * @return 1 if the cell is in the bitboard, 0 otherwise
+ */
+static inline int bitBoardTest(const BitBoard *bitBoard, const int index)
+{
+    return (int) ((bitBoard->words[index / BITBOARD_WORD_BITS] >> (index % BITBOARD_WORD_BITS)) & 1);
+}
+
+/**
+ * this function builds the bitboard of a single ship segment. the bitboard is cleared first.
+ * @param bitBoard : the bitboard to write the segment into
+ * @param start : the number of the first cell of the segment
+ * @param step : the distance between two following cells (1 for a row, the board size for a
+ * column)
+ * @param length : the number of cells in the segment
+ */
+static inline void bitBoardSegment(BitBoard *bitBoard, int start, const int step,
+                                   const int length)
+{
+    int i;
+    bitBoardClear(bitBoard);
+    for (i = 0 ; i < length ; ++i, start += step)
+    {
+        bitBoardSet(bitBoard, start);
+    }
+}
+
+/**
+ * this function adds all the cells of one bitboard to another.
+ * @param dest : the bitboard we add to
+ * @param src : the bitboard we add
+ */
+static inline void bitBoardOr(BitBoard *dest, const BitBoard *src)
+{
+    int i;
+    for (i = 0 ; i < BITBOARD_WORDS ; ++i)
+    {
+        dest->words[i] |= src->words[i];
+    }
+}
+
+/**
+ * this function counts the cells in the bitboard.
+ * @param bitBoard : the bitboard
+ * @return the number of cells in it
+ */
+static inline int bitBoardCount(const BitBoard *bitBoard)
+{
+    int i, count = 0;
+    for (i = 0 ; i < BITBOARD_WORDS ; ++i)
+    {
+        count += __builtin_popcountll(bitBoard->words[i]);
+    }
+    return count;
+}
+
+/**
+ * this function counts the cells that are in both bitboards.
+ * @param first : the first bitboard
+ * @param second : the second bitboard
+ * @return the number of common cells, 0 if they don't overlap
+ */
+static inline int bitBoardOverlap(const BitBoard *first, const BitBoard *second)
+{
+    int i, count = 0;
+    for (i = 0 ; i < BITBOARD_WORDS ; ++i)
+    {
+        count += __builtin_popcountll(first->words[i] & second->words[i]);
+    }
+    return count;
+}
+
+/**
+ * this function counts the cells of the first bitboard that are missing in the second one.
+ * @param first : the bitboard we check
+ * @param second : the bitboard that should cover it
+ * @return the number of cells of first that are not in second, 0 if second covers first
+ */
+static inline int bitBoardMissing(const BitBoard *first, const BitBoard *second)
+{
+    int i, count = 0;
+    for (i = 0 ; i < BITBOARD_WORDS ; ++i)
+    {
+        count += __builtin_popcountll(first->words[i] & ~second->words[i]);
+    }
+    return count;
+}
+
+#endif //EX2_BITBOARD_H
@@ -0,0 +1,462 @@
+// ------------------------------ includes ------------------------------
+
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <unistd.h>
+#include "battleships.h"
+#include "input.h"
+#include "stats.h"
+
+/**
+ * @file input.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief this is the implementation file for the input of the game.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * this is the implementation file for the line reader and the move parser.
+ * Input  : the lines of a file descriptor
+ * Process: implementation for the functions in input.h
+ * Output : none
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * @var constant for identify user input.
+ * @brief if the user asks to exit the program before the game was finished it will write this word
+ */
+const char EXIT_WORD[] = "exit";
+
+/**
+ * the largest column number we keep parsing. any bigger number is out of the board anyway.
+ */
+const int MAX_PARSED_NUMBER = 1 << 24;
+
+/**
+ * the result of fillReader when the deadline of the reader passed.
+ */
+#define READ_TIMEOUT (-1)
+
+/**
+ * @brief the explanations of the parse results, indexed by the ParseResult.
+ */
+const char *PARSE_RESULT_MESSAGES[] = {
+        "ok",
+        "exit",
+        "end of input",
+        "the line is empty",
+        "the line is too long",
+        "the row must be small letters or a number",
+        "the row must be followed by a column number",
+        "a number was expected",
+        "unexpected text after the move or the number",
+        "the coordinate is out of the board",
+        "the fleet must be ship lengths like 5,4,3,3,2 or 2x4",
+        "the time is over"
+};
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function sets a new line reader.
+ * @param reader : the reader
+ * @param fd : the file descriptor to read from
+ */
+void initLineReader(LineReader *reader, const int fd)
+{
+    reader->fd = fd;
+    reader->start = 0;
+    reader->end = 0;
+    reader->isEof = FALSE;
+    reader->deadline = 0;
+}
+
+/**
+ * this function sets the deadline of a reader. readLine gives up when it passes.
+ * @param reader : the reader
+ * @param deadline : the time (of statsNanos) to read the lines by, 0 for no deadline
+ */
+void setReaderDeadline(LineReader *reader, const uint64_t deadline)
+{
+    reader->deadline = deadline;
+}
+
+/**
+ * this function waits with poll() until the file descriptor of the reader can be read (has data,
+ * reached its end or failed) or the deadline of the reader passes.
+ * @param reader : the reader
+ * @return TRUE if the file descriptor can be read, FALSE if the deadline passed
+ */
+int waitForReader(const LineReader *reader)
+{
+    while (1)
+    {
+        int timeoutMillis = -1;
+        if (reader->deadline != 0)
+        {
+            uint64_t now = statsNanos();
+            if (now >= reader->deadline)
+            {
+                return FALSE;
+            }
+            uint64_t left = (reader->deadline - now + 999999) / 1000000; // round up, don't spin
+            timeoutMillis = (left > INT_MAX) ? INT_MAX : (int) left;
+        }
+        struct pollfd pollFd = {reader->fd, POLLIN, 0};
+        int numReady = poll(&pollFd, 1, timeoutMillis);
+        if (numReady > 0 || (numReady < 0 && errno != EINTR))
+        { // a failure of poll is left for read to report
+            return TRUE;
+        }
+    }
+}
+
+/**
+ * this function reads more data into the buffer of the reader. the data that was not handed out
+ * yet is moved to the start of the buffer first. with a deadline it only reads after poll() found
+ * data, so it doesn't block past the deadline (a non blocking file descriptor works as well).
+ * @param reader : the reader
+ * @return the number of bytes read, 0 at the end of the input and READ_TIMEOUT if the deadline
+ * passed
+ */
+int fillReader(LineReader *reader)
+{
+    if (reader->start > 0)
+    {
+        reader->end -= reader->start;
+        memmove(reader->buffer, reader->buffer + reader->start, (size_t) reader->end);
+        reader->start = 0;
+    }
+    while (reader->isEof == FALSE && reader->end < READER_CAPACITY)
+    {
+        if (reader->deadline != 0 && waitForReader(reader) == FALSE)
+        {
+            return READ_TIMEOUT;
+        }
+        ssize_t numRead = read(reader->fd, reader->buffer + reader->end,
+                               (size_t) (READER_CAPACITY - reader->end));
+        if (numRead < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (numRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        { // a non blocking file descriptor with no data yet
+            if (waitForReader(reader) == FALSE)
+            {
+                return READ_TIMEOUT;
+            }
+            continue;
+        }
+        if (numRead <= 0)
+        {
+            reader->isEof = TRUE;
+            return 0;
+        }
+        reader->end += (int) numRead;
+        return (int) numRead;
+    }
+    return 0;
+}
+
+/**
+ * this function reads the next line. the line stays valid until the next call.
+ * @param reader : the reader
+ * @param line : will point to the start of the line (not null terminated)
+ * @param length : will be set to the length of the line (with no new line)
+ * @return PARSE_OK for a line, PARSE_END_OF_INPUT at the end of the input,
+ * PARSE_LINE_TOO_LONG for a line that is too long (it is skipped) and PARSE_TIMEOUT if the
+ * deadline passed (the part of the line that was typed is dropped)
+ */
+ParseResult readLine(LineReader *reader, const char **line, int *length)
+{
+    int searched = reader->start;
+    int isTooLong = FALSE;
+    while (1)
+    {
+        char *newLine = memchr(reader->buffer + searched, '\n', (size_t) (reader->end - searched));
+        if (newLine != NULL)
+        {
+            int lineEnd = (int) (newLine - reader->buffer);
+            *line = reader->buffer + reader->start;
+            *length = lineEnd - reader->start;
+            reader->start = lineEnd + 1;
+            if (isTooLong == TRUE || *length > MAX_LINE_LENGTH)
+            {
+                return PARSE_LINE_TOO_LONG;
+            }
+            if (*length > 0 && (*line)[*length - 1] == '\r')
+            {
+                (*length)--;
+            }
+            return PARSE_OK;
+        }
+        if (reader->end - reader->start > MAX_LINE_LENGTH)
+        { // drop the start of a line that is too long, we only need to find its end
+            isTooLong = TRUE;
+            reader->start = reader->end;
+        }
+        searched = reader->end - reader->start;
+        int numRead = fillReader(reader);
+        if (numRead == READ_TIMEOUT)
+        {
+            reader->start = reader->end;
+            return PARSE_TIMEOUT;
+        }
+        if (numRead == 0)
+        {
+            break;
+        }
+    }
+    if (reader->end > reader->start)
+    { // the last line has no new line
+        *line = reader->buffer + reader->start;
+        *length = reader->end - reader->start;
+        reader->start = reader->end;
+        return (isTooLong == TRUE) ? PARSE_LINE_TOO_LONG : PARSE_OK;
+    }
+    return (isTooLong == TRUE) ? PARSE_LINE_TOO_LONG : PARSE_END_OF_INPUT;
+}
+
+/**
+ * this function skips the spaces in a line.
+ * @param line : the line
+ * @param position : the position to start from
+ * @param length : the length of the line
+ * @return the position of the first char that is not a space (or the length)
+ */
+int skipSpaces(const char *line, int position, const int length)
+{
+    while (position < length && (line[position] == ' ' || line[position] == '\t'))
+    {
+        position++;
+    }
+    return position;
+}
+
+/**
+ * this function parses the digits of a number.
+ * @param line : the line
+ * @param position : the position of the first digit, will be set to the position after the number
+ * @param length : the length of the line
+ * @param number : will be set to the number
+ * @return PARSE_OK if there was at least one digit, PARSE_BAD_NUMBER otherwise
+ */
+ParseResult parseDigits(const char *line, int *position, const int length, int *number)
+{
+    int i = *position;
+    int value = 0;
+    while (i < length && line[i] >= '0' && line[i] <= '9')
+    {
+        if (value < MAX_PARSED_NUMBER)
+        {
+            value = value * 10 + (line[i] - '0');
+        }
+        i++;
+    }
+    if (i == *position)
+    {
+        return PARSE_BAD_NUMBER;
+    }
+    *position = i;
+    *number = value;
+    return PARSE_OK;
+}
+
+/**
+ * this function parses the letters of a row label- a, b, ..., z, aa, ab, ... (like the columns
+ * of a spreadsheet).
+ * @param line : the line
+ * @param position : the position of the first letter, will be set to the position after the label
+ * @param length : the length of the line
+ * @return the row index (from 0)
+ */
+int parseRowLetters(const char *line, int *position, const int length)
+{
+    int i = *position;
+    int value = 0;
+    while (i < length && line[i] >= 'a' && line[i] <= 'z')
+    {
+        if (value < MAX_PARSED_NUMBER)
+        {
+            value = value * ('z' - 'a' + 1) + (line[i] - 'a' + 1);
+        }
+        i++;
+    }
+    *position = i;
+    return value - 1;
+}
+
+/**
+ * this function parses the text of a move (see parseMove).
+ * @param line : the line
+ * @param length : the length of the line
+ * @param row : will be set to the row index (from 0)
+ * @param column : will be set to the column index (from 0)
+ * @return PARSE_OK for a move, PARSE_EXIT for exit, or the reason the line is not valid
+ */
+ParseResult parseMoveText(const char *line, const int length, int *row, int *column)
+{
+    int position = skipSpaces(line, 0, length);
+    if (position == length)
+    {
+        return PARSE_EMPTY;
+    }
+    int exitLength = (int) sizeof(EXIT_WORD) - 1;
+    if (length - position >= exitLength && memcmp(line + position, EXIT_WORD, exitLength) == 0 &&
+        skipSpaces(line, position + exitLength, length) == length)
+    {
+        return PARSE_EXIT;
+    }
+    int number;
+    if (line[position] >= 'a' && line[position] <= 'z')
+    {
+        *row = parseRowLetters(line, &position, length);
+    }
+    else if (parseDigits(line, &position, length, &number) == PARSE_OK)
+    { // a numeric row, the column comes after spaces or a comma
+        *row = number - 1;
+        position = skipSpaces(line, position, length);
+        if (position < length && line[position] == ',')
+        {
+            position++;
+        }
+    }
+    else
+    {
+        return PARSE_BAD_ROW;
+    }
+    position = skipSpaces(line, position, length);
+    if (parseDigits(line, &position, length, &number) != PARSE_OK)
+    {
+        return PARSE_BAD_COLUMN;
+    }
+    if (skipSpaces(line, position, length) != length)
+    {
+        return PARSE_TRAILING;
+    }
+    *column = number - 1;
+    return PARSE_OK;
+}
+
+/**
+ * this function parses a move from a line: the row and then a number for the column, or the exit
+ * word. the row is small letters ("c 12", "c12", or "ab 12" for the row after "z") or a number
+ * from 1 ("3 12" or "3,12"). spaces around them are allowed.
+ * @param line : the line
+ * @param length : the length of the line
+ * @param row : will be set to the row index (from 0)
+ * @param column : will be set to the column index (from 0)
+ * @return PARSE_OK for a move, PARSE_EXIT for exit, or the reason the line is not valid
+ */
+ParseResult parseMove(const char *line, const int length, int *row, int *column)
+{
+    STAT_TIMER_START(start);
+    ParseResult result = parseMoveText(line, length, row, column);
+    STAT_TIMER_STOP(TIMER_PARSE, start);
+    STAT_ADD(COUNTER_PARSES, 1);
+    return result;
+}
+
+/**
+ * this function parses a positive number from a line.
+ * @param line : the line
+ * @param length : the length of the line
+ * @param number : will be set to the number
+ * @return PARSE_OK for a number, PARSE_EMPTY for an empty line, PARSE_BAD_NUMBER if it doesn't
+ * start with a digit and PARSE_TRAILING if there is more text after the number
+ */
+ParseResult parseNumber(const char *line, const int length, int *number)
+{
+    int position = skipSpaces(line, 0, length);
+    if (position == length)
+    {
+        return PARSE_EMPTY;
+    }
+    if (parseDigits(line, &position, length, number) != PARSE_OK)
+    {
+        return PARSE_BAD_NUMBER;
+    }
+    if (skipSpaces(line, position, length) != length)
+    {
+        return PARSE_TRAILING;
+    }
+    return PARSE_OK;
+}
+
+/**
+ * this function parses a fleet: a list of ship lengths separated by commas, spaces or new lines,
+ * where "<count>x<length>" is count ships of that length ("5,4,3,3,2" or "2x4 3x2"). a "#" starts
+ * a comment to the end of the line, so the text can be a whole fleet file. it doesn't check the
+ * lengths against a board (see isValidFleet).
+ * @param text : the text
+ * @param length : the length of the text
+ * @param fleet : will be set to the fleet
+ * @return PARSE_OK for a fleet, PARSE_EMPTY if there are no ships and PARSE_BAD_FLEET if the text
+ * is not a list of ship lengths or has more than MAX_FLEET_SHIPS ships
+ */
+ParseResult parseFleet(const char *text, const int length, Fleet *fleet)
+{
+    int position = 0;
+    fleet->numOfShips = 0;
+    while (position < length)
+    {
+        char current = text[position];
+        if (current == ' ' || current == '\t' || current == '\n' || current == '\r' ||
+            current == ',')
+        {
+            position++;
+            continue;
+        }
+        if (current == '#')
+        { // a comment, to the end of the line
+            while (position < length && text[position] != '\n')
+            {
+                position++;
+            }
+            continue;
+        }
+        int count = 1, shipLength, i;
+        if (parseDigits(text, &position, length, &shipLength) != PARSE_OK)
+        {
+            return PARSE_BAD_FLEET;
+        }
+        if (position < length && text[position] == 'x')
+        { // the number was the count of the ships
+            position++;
+            count = shipLength;
+            if (parseDigits(text, &position, length, &shipLength) != PARSE_OK)
+            {
+                return PARSE_BAD_FLEET;
+            }
+        }
+        if (count < 1 || shipLength < 1 || count > MAX_FLEET_SHIPS - fleet->numOfShips)
+        {
+            return PARSE_BAD_FLEET;
+        }
+        for (i = 0 ; i < count ; ++i)
+        {
+            fleet->ships[fleet->numOfShips++].length = shipLength;
+        }
+    }
+    return (fleet->numOfShips == 0) ? PARSE_EMPTY : PARSE_OK;
+}
+
+/**
+ * this function gives a short explanation for a parse result.
+ * @param result : the result
+ * @return the explanation
+ */
+const char *parseResultMessage(const ParseResult result)
+{
+    return PARSE_RESULT_MESSAGES[result];
+}
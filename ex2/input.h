@@ -0,0 +1,146 @@
+/**
+ * @file input.h
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the input of the game- a buffered line reader over read() and a parser of the moves.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * the reader reads big blocks from a file descriptor and hands out the lines as pointers into its
+ * buffer, so nothing is copied. the parser reads a move ("c 12", "c12", "ab 12", "3,12" or
+ * "exit") or a number from such a line in place, and tells exactly what is wrong with a line that
+ * is not valid.
+ * a reader can be given a deadline: then it waits for its file descriptor with poll() and never
+ * blocks past the deadline, so an idle player can't hold the game forever.
+ */
+
+#ifndef EX2_INPUT_H
+#define EX2_INPUT_H
+
+#include "battleships.h"
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the size of the buffer of the reader. a line longer than that is not valid input anyway.
+ */
+#define READER_CAPACITY (1 << 16)
+
+/**
+ * the longest line the reader hands out.
+ */
+#define MAX_LINE_LENGTH 256
+
+/**
+ * @brief a buffered line reader.
+ * @fd the file descriptor it reads from
+ * @start the start of the next line in the buffer
+ * @end the end of the data in the buffer
+ * @isEof TRUE once the file descriptor reached its end
+ * @deadline the time (of statsNanos) the next line must be read by, 0 for no deadline
+ * @buffer the data that was read
+ */
+typedef struct LineReader
+{
+    int fd;
+    int start;
+    int end;
+    int isEof;
+    uint64_t deadline;
+    char buffer[READER_CAPACITY];
+} LineReader;
+
+/**
+ * @brief the results of reading a line and of parsing it.
+ */
+typedef enum ParseResult
+{
+    PARSE_OK, // a valid move (or number)
+    PARSE_EXIT, // the exit word
+    PARSE_END_OF_INPUT, // there are no more lines
+    PARSE_EMPTY, // an empty line
+    PARSE_LINE_TOO_LONG, // the line is longer than MAX_LINE_LENGTH
+    PARSE_BAD_ROW, // the move doesn't start with a small letter or a number
+    PARSE_BAD_COLUMN, // the letter is not followed by a number
+    PARSE_BAD_NUMBER, // a number was expected and the text is not one
+    PARSE_TRAILING, // there is more text after the move (or the number)
+    PARSE_OUT_OF_BOARD, // the coordinate is not on the board (set by the caller)
+    PARSE_BAD_FLEET, // the fleet is not a list of ship lengths
+    PARSE_TIMEOUT // the deadline of the reader passed before a whole line was read
+} ParseResult;
+
+
+// ------------------------------ function declarations -----------------------------
+
+/**
+ * this function sets a new line reader.
+ * @param reader : the reader
+ * @param fd : the file descriptor to read from
+ */
+void initLineReader(LineReader *reader, int fd);
+
+/**
+ * this function sets the deadline of a reader. readLine gives up when it passes.
+ * @param reader : the reader
+ * @param deadline : the time (of statsNanos) to read the lines by, 0 for no deadline
+ */
+void setReaderDeadline(LineReader *reader, uint64_t deadline);
+
+/**
+ * this function reads the next line. the line stays valid until the next call.
+ * @param reader : the reader
+ * @param line : will point to the start of the line (not null terminated)
+ * @param length : will be set to the length of the line (with no new line)
+ * @return PARSE_OK for a line, PARSE_END_OF_INPUT at the end of the input,
+ * PARSE_LINE_TOO_LONG for a line that is too long (it is skipped) and PARSE_TIMEOUT if the
+ * deadline passed (the part of the line that was typed is dropped)
+ */
+ParseResult readLine(LineReader *reader, const char **line, int *length);
+
+/**
+ * this function parses a move from a line: the row and then a number for the column, or the exit
+ * word. the row is small letters ("c 12", "c12", or "ab 12" for the row after "z") or a number
+ * from 1 ("3 12" or "3,12"). spaces around them are allowed.
+ * @param line : the line
+ * @param length : the length of the line
+ * @param row : will be set to the row index (from 0)
+ * @param column : will be set to the column index (from 0)
+ * @return PARSE_OK for a move, PARSE_EXIT for exit, or the reason the line is not valid
+ */
+ParseResult parseMove(const char *line, int length, int *row, int *column);
+
+/**
+ * this function parses a positive number from a line.
+ * @param line : the line
+ * @param length : the length of the line
+ * @param number : will be set to the number
+ * @return PARSE_OK for a number, PARSE_EMPTY for an empty line, PARSE_BAD_NUMBER if it doesn't
+ * start with a digit and PARSE_TRAILING if there is more text after the number
+ */
+ParseResult parseNumber(const char *line, int length, int *number);
+
+/**
+ * this function parses a fleet: a list of ship lengths separated by commas, spaces or new lines,
+ * where "<count>x<length>" is count ships of that length ("5,4,3,3,2" or "2x4 3x2"). a "#" starts
+ * a comment to the end of the line, so the text can be a whole fleet file. it doesn't check the
+ * lengths against a board (see isValidFleet).
+ * @param text : the text
+ * @param length : the length of the text
+ * @param fleet : will be set to the fleet
+ * @return PARSE_OK for a fleet, PARSE_EMPTY if there are no ships and PARSE_BAD_FLEET if the text
+ * is not a list of ship lengths or has more than MAX_FLEET_SHIPS ships
+ */
+ParseResult parseFleet(const char *text, int length, Fleet *fleet);
+
+/**
+ * this function gives a short explanation for a parse result.
+ * @param result : the result
+ * @return the explanation
+ */
+const char *parseResultMessage(ParseResult result);
+
+#endif //EX2_INPUT_H
@@ -0,0 +1,267 @@
+// ------------------------------ includes ------------------------------
+
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include "journal.h"
+
+/**
+ * @file journal.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief this is the implementation file for the move journal.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * this is the implementation file for writing and reading the move journal.
+ * Input  : a journal
+ * Process: implementation for the functions in journal.h
+ * Output : a journal
+ */
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function writes a whole buffer to a file, even if it takes a few writes.
+ * @param fd : the file
+ * @param data : the buffer
+ * @param length : the length of the buffer
+ * @return TRUE on success, FALSE if a write failed
+ */
+int writeJournalBytes(const int fd, const unsigned char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(fd, data, length);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            return FALSE;
+        }
+        data += written;
+        length -= (size_t) written;
+    }
+    return TRUE;
+}
+
+/**
+ * this function writes all the buffered records of the journal to its file.
+ * @param journal : the journal
+ * @return TRUE on success, FALSE if the write failed or a write failed before (errno is set to
+ * the error of the first failure)
+ */
+int flushJournal(MoveJournal *journal)
+{
+    if (journal->error == 0)
+    {
+        errno = 0;
+        if (writeJournalBytes(journal->fd, journal->buffer, (size_t) journal->length) == FALSE)
+        {
+            journal->error = (errno != 0) ? errno : EIO; // a write of 0 bytes sets no errno
+        }
+    }
+    journal->length = 0;
+    if (journal->error != 0)
+    {
+        errno = journal->error;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * this function encodes the header of the journal of a game that was just started.
+ * @param out : the buffer (at least JOURNAL_MAX_HEADER bytes)
+ * @param game : the game, before its first move
+ * @param seed : the seed the game was started with
+ * @return the number of bytes of the header
+ */
+int encodeJournalHeader(unsigned char *out, const Game *game, const uint64_t seed)
+{
+    JournalHeader header;
+    memset(&header, 0, sizeof(JournalHeader));
+    header.magic = JOURNAL_MAGIC;
+    header.version = JOURNAL_VERSION;
+    header.size = (uint8_t) game->gameBoard.size;
+    header.numOfShips = (uint8_t) game->ships.numOfShips;
+    header.seed = seed;
+    memcpy(out, &header, sizeof(JournalHeader));
+    memcpy(out + sizeof(JournalHeader), game->ships.length, (size_t) game->ships.numOfShips);
+    return (int) sizeof(JournalHeader) + game->ships.numOfShips;
+}
+
+/**
+ * this function encodes the record of a move.
+ * @param out : the buffer (at least JOURNAL_MAX_RECORD bytes)
+ * @param lastCell : the cell of the move before it, will be set to the cell of this move
+ * @param size : the size of the board
+ * @param row : the row of the move
+ * @param column : the column of the move
+ * @param result : the result of the move
+ * @return the number of bytes of the record
+ */
+int encodeJournalRecord(unsigned char *out, int *lastCell, const int size, const int row,
+                        const int column, const MoveResult result)
+{
+    int cell = row * size + column;
+    int32_t delta = cell - *lastCell;
+    uint32_t zigZag = ((uint32_t) delta << 1) ^ (uint32_t) (delta >> 31);
+    uint32_t value = (zigZag << JOURNAL_RESULT_BITS) | (uint32_t) result;
+    int length = 0;
+    *lastCell = cell;
+    while (value >= 0x80)
+    {
+        out[length++] = (unsigned char) (value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (unsigned char) value;
+    return length;
+}
+
+/**
+ * this function starts the journal of a game that was just started with initGame. it writes the
+ * header and the fleet of the game.
+ * @param journal : the journal
+ * @param fd : the file of the journal
+ * @param game : the game, before its first move
+ * @param seed : the seed the game was started with
+ * @return TRUE if the header was written, FALSE otherwise
+ */
+int openJournal(MoveJournal *journal, const int fd, const Game *game, const uint64_t seed)
+{
+    journal->fd = fd;
+    journal->size = game->gameBoard.size;
+    journal->lastCell = 0;
+    journal->error = 0;
+    journal->length = encodeJournalHeader(journal->buffer, game, seed);
+    return flushJournal(journal);
+}
+
+/**
+ * this function adds a move to the journal. it only writes to the file when the buffer is full.
+ * @param journal : the journal
+ * @param row : the row of the move
+ * @param column : the column of the move
+ * @param result : the result of the move
+ * @return TRUE on success, FALSE if the buffer had to be written and that failed
+ */
+int journalMove(MoveJournal *journal, const int row, const int column, const MoveResult result)
+{
+    if (journal->error != 0 ||
+        (journal->length + JOURNAL_MAX_RECORD > JOURNAL_BUFFER && flushJournal(journal) == FALSE))
+    {
+        return FALSE;
+    }
+    journal->length += encodeJournalRecord(journal->buffer + journal->length, &journal->lastCell,
+                                           journal->size, row, column, result);
+    return TRUE;
+}
+
+/**
+ * this function makes a move in a game and adds it to the journal (a move out of the board or on
+ * a game that is over doesn't get to the engine, so it is not added). if the move can't be
+ * written the error of the journal is set, check it (or the result of flushJournal).
+ * @param game : the game
+ * @param journal : the journal of the game, NULL for no journal
+ * @param row : the row of the move
+ * @param column : the column of the move
+ * @return the result of the move (see stepGame)
+ */
+MoveResult stepJournaledGame(Game *game, MoveJournal *journal, const int row, const int column)
+{
+    MoveResult result = stepGame(game, row, column);
+    if (journal != NULL && result != MOVE_INVALID)
+    {
+        journalMove(journal, row, column, result);
+    }
+    return result;
+}
+
+/**
+ * this function starts reading a journal from memory.
+ * @param reader : the reader
+ * @param data : the whole journal
+ * @param length : the length of the journal
+ * @return TRUE if the journal starts with a valid header, FALSE otherwise
+ */
+int openJournalReader(JournalReader *reader, const unsigned char *data, const size_t length)
+{
+    if (length < sizeof(JournalHeader))
+    {
+        return FALSE;
+    }
+    memcpy(&reader->header, data, sizeof(JournalHeader));
+    const JournalHeader *header = &reader->header;
+    if (header->magic != JOURNAL_MAGIC || header->version != JOURNAL_VERSION ||
+        header->numOfShips < 1 || header->numOfShips > MAX_FLEET_SHIPS ||
+        length < sizeof(JournalHeader) + header->numOfShips)
+    {
+        return FALSE;
+    }
+    int i;
+    reader->fleet.numOfShips = header->numOfShips;
+    for (i = 0 ; i < header->numOfShips ; ++i)
+    {
+        reader->fleet.ships[i].length = data[sizeof(JournalHeader) + i];
+    }
+    reader->data = data;
+    reader->length = length;
+    reader->position = sizeof(JournalHeader) + header->numOfShips;
+    reader->lastCell = 0;
+    return TRUE;
+}
+
+/**
+ * this function reads the next record of a journal.
+ * @param reader : the reader
+ * @param row : will be set to the row of the move
+ * @param column : will be set to the column of the move
+ * @param result : will be set to the result of the move
+ * @return RECORD_OK for a record, or why there is none
+ */
+JournalRecord readJournalRecord(JournalReader *reader, int *row, int *column,
+                                MoveResult *result)
+{
+    if (reader->position == reader->length)
+    {
+        return RECORD_END;
+    }
+    uint32_t value = 0;
+    int shift = 0;
+    unsigned char byte;
+    do
+    {
+        if (reader->position == reader->length)
+        {
+            return RECORD_TRUNCATED;
+        }
+        if (shift >= 7 * JOURNAL_MAX_RECORD)
+        {
+            return RECORD_BAD;
+        }
+        byte = reader->data[reader->position++];
+        value |= (uint32_t) (byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    uint32_t zigZag = value >> JOURNAL_RESULT_BITS;
+    int32_t delta = (int32_t) (zigZag >> 1) ^ -(int32_t) (zigZag & 1);
+    int size = reader->header.size;
+    int cell = reader->lastCell + delta;
+    if (cell < 0 || cell >= size * size || (value & JOURNAL_RESULT_MASK) >= MOVE_INVALID)
+    {
+        return RECORD_BAD;
+    }
+    reader->lastCell = cell;
+    *row = cell / size;
+    *column = cell % size;
+    *result = (MoveResult) (value & JOURNAL_RESULT_MASK);
+    return RECORD_OK;
+}
@@ -0,0 +1,212 @@
+/**
+ * @file journal.h
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the move journal- an append only record of the moves of a game and their results.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * a journal starts with a JournalHeader (the size of the board and the seed of the game) and the
+ * lengths of the ships of its fleet, one byte each. so initGame with the same size, fleet and seed
+ * gives the same game again. after that comes one record for every move: the cell of the move
+ * minus the cell of the move before it (zig zag coded, so a small step back is small too), shifted
+ * by 4 bits with the MoveResult of the move in the low nibble, written as a varint (7 bits per
+ * byte, the high bit marks that more bytes follow). a sweep or a move next to the last hit costs a
+ * single byte. a record that was cut in the middle (a crash) is the end of the journal.
+ */
+
+#ifndef EX2_JOURNAL_H
+#define EX2_JOURNAL_H
+
+#include <stddef.h>
+#include "battleships.h"
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the first bytes of every journal ("BSJN" in the file) and the version of the layout.
+ */
+#define JOURNAL_MAGIC 0x4E4A5342u
+#define JOURNAL_VERSION 1
+
+/**
+ * the size of the buffer of a journal. the records are written once it is full (or flushed).
+ */
+#define JOURNAL_BUFFER (1 << 16)
+
+/**
+ * the longest record- a varint of a 32 bit number.
+ */
+#define JOURNAL_MAX_RECORD 5
+
+/**
+ * the longest header- the fixed head and the largest fleet.
+ */
+#define JOURNAL_MAX_HEADER ((int) sizeof(JournalHeader) + MAX_FLEET_SHIPS)
+
+/**
+ * the bits of the result in a record.
+ */
+#define JOURNAL_RESULT_BITS 4
+#define JOURNAL_RESULT_MASK ((1u << JOURNAL_RESULT_BITS) - 1)
+
+/**
+ * @brief the fixed head of a journal. the lengths of the ships (numOfShips bytes) come right
+ * after it.
+ * @magic JOURNAL_MAGIC
+ * @version JOURNAL_VERSION
+ * @size the size of the board
+ * @numOfShips the number of ships in the fleet
+ * @seed the seed of the game
+ */
+typedef struct JournalHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint8_t size;
+    uint8_t numOfShips;
+    uint64_t seed;
+} JournalHeader;
+
+/**
+ * @brief a journal that is being written.
+ * @fd the file of the journal
+ * @size the size of the board of the game
+ * @lastCell the cell of the last move (0 before the first move)
+ * @length the number of bytes in the buffer
+ * @error the errno of the first write that failed, 0 while all the writes succeeded. once a write
+ * failed nothing more is written (the records after a gap can't be decoded)
+ * @buffer the bytes that were not written yet
+ */
+typedef struct MoveJournal
+{
+    int fd;
+    int size;
+    int lastCell;
+    int length;
+    int error;
+    unsigned char buffer[JOURNAL_BUFFER];
+} MoveJournal;
+
+/**
+ * @brief a journal that is being read.
+ * @header the header of the journal
+ * @fleet the fleet of the game
+ * @data the records
+ * @length the number of bytes of the records
+ * @position the position of the next record
+ * @lastCell the cell of the last record that was read
+ */
+typedef struct JournalReader
+{
+    JournalHeader header;
+    Fleet fleet;
+    const unsigned char *data;
+    size_t length;
+    size_t position;
+    int lastCell;
+} JournalReader;
+
+/**
+ * @brief the results of reading a record.
+ */
+typedef enum JournalRecord
+{
+    RECORD_OK, // a record was read
+    RECORD_END, // there are no more records
+    RECORD_TRUNCATED, // the last record was cut in the middle
+    RECORD_BAD // the record is not a valid move
+} JournalRecord;
+
+
+// ------------------------------ function declarations -----------------------------
+
+/**
+ * this function encodes the header of the journal of a game that was just started.
+ * @param out : the buffer (at least JOURNAL_MAX_HEADER bytes)
+ * @param game : the game, before its first move
+ * @param seed : the seed the game was started with
+ * @return the number of bytes of the header
+ */
+int encodeJournalHeader(unsigned char *out, const Game *game, uint64_t seed);
+
+/**
+ * this function encodes the record of a move.
+ * @param out : the buffer (at least JOURNAL_MAX_RECORD bytes)
+ * @param lastCell : the cell of the move before it, will be set to the cell of this move
+ * @param size : the size of the board
+ * @param row : the row of the move
+ * @param column : the column of the move
+ * @param result : the result of the move
+ * @return the number of bytes of the record
+ */
+int encodeJournalRecord(unsigned char *out, int *lastCell, int size, int row, int column,
+                        MoveResult result);
+
+/**
+ * this function starts the journal of a game that was just started with initGame. it writes the
+ * header and the fleet of the game.
+ * @param journal : the journal
+ * @param fd : the file of the journal
+ * @param game : the game, before its first move
+ * @param seed : the seed the game was started with
+ * @return TRUE if the header was written, FALSE otherwise
+ */
+int openJournal(MoveJournal *journal, int fd, const Game *game, uint64_t seed);
+
+/**
+ * this function adds a move to the journal. it only writes to the file when the buffer is full.
+ * @param journal : the journal
+ * @param row : the row of the move
+ * @param column : the column of the move
+ * @param result : the result of the move
+ * @return TRUE on success, FALSE if the buffer had to be written and that failed (or a write
+ * failed before)
+ */
+int journalMove(MoveJournal *journal, int row, int column, MoveResult result);
+
+/**
+ * this function writes all the buffered records of the journal to its file.
+ * @param journal : the journal
+ * @return TRUE on success, FALSE if the write failed or a write failed before (errno is set to
+ * the error of the first failure)
+ */
+int flushJournal(MoveJournal *journal);
+
+/**
+ * this function makes a move in a game and adds it to the journal (a move out of the board or on
+ * a game that is over doesn't get to the engine, so it is not added). if the move can't be
+ * written the error of the journal is set, check it (or the result of flushJournal).
+ * @param game : the game
+ * @param journal : the journal of the game, NULL for no journal
+ * @param row : the row of the move
+ * @param column : the column of the move
+ * @return the result of the move (see stepGame)
+ */
+MoveResult stepJournaledGame(Game *game, MoveJournal *journal, int row, int column);
+
+/**
+ * this function starts reading a journal from memory.
+ * @param reader : the reader
+ * @param data : the whole journal
+ * @param length : the length of the journal
+ * @return TRUE if the journal starts with a valid header, FALSE otherwise
+ */
+int openJournalReader(JournalReader *reader, const unsigned char *data, size_t length);
+
+/**
+ * this function reads the next record of a journal.
+ * @param reader : the reader
+ * @param row : will be set to the row of the move
+ * @param column : will be set to the column of the move
+ * @param result : will be set to the result of the move
+ * @return RECORD_OK for a record, or why there is none
+ */
+JournalRecord readJournalRecord(JournalReader *reader, int *row, int *column,
+                                MoveResult *result);
+
+#endif //EX2_JOURNAL_H
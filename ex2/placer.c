@@ -0,0 +1,412 @@
+// ------------------------------ includes ------------------------------
+
+#include <stdlib.h>
+#include <limits.h>
+#include "placer.h"
+#include "stats.h"
+
+/**
+ * @file placer.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief this is the implementation file for the fleet placement solver.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * this is the implementation file for the backtracking search of a fleet layout.
+ * Input  : a game with its fleet
+ * Process: implementation for the functions in placer.h
+ * Output : the fleet on the board of the game
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * @brief the ships of the same length.
+ * @length the length of the ships
+ * @numOfShips the number of ships
+ * @numLeft the number of ships that were not placed yet
+ * @ships the indexes of the ships in the registry
+ * @numOfPlacements the number of placements of a ship of the group on the board
+ * @cells the placements (cell number * NUM_OF_ORIENTATIONS + orientation), in a random order
+ * @masks the cells of every placement
+ * @starts the placement that starts at every cell in every orientation (cell number *
+ * NUM_OF_ORIENTATIONS + orientation), -1 for none
+ * @last the placement of the last ship of the group that was placed, -1 for none
+ */
+typedef struct PlacerGroup
+{
+    int length;
+    int numOfShips;
+    int numLeft;
+    int *ships;
+    int numOfPlacements;
+    int *cells;
+    BitBoard *masks;
+    int *starts;
+    int last;
+} PlacerGroup;
+
+/**
+ * @brief the state of a search.
+ * @game the game
+ * @numOfWords the number of words of a bitboard the board uses
+ * @numOfGroups the number of groups
+ * @groups the groups
+ * @ships the indexes of the ships in the registry, by their group
+ * @placedGroup the group of the ship that was placed at every depth
+ * @placed the placement of the ship that was placed at every depth
+ * @steps the number of placement checks so far
+ */
+typedef struct FleetPlacer
+{
+    Game *game;
+    int numOfWords;
+    int numOfGroups;
+    PlacerGroup groups[MAX_SHIP_LENGTH];
+    int ships[MAX_FLEET_SHIPS];
+    int placedGroup[MAX_FLEET_SHIPS];
+    int placed[MAX_FLEET_SHIPS];
+    long steps;
+} FleetPlacer;
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function checks if a placement collides with the ships on the board.
+ * @param placer : the search
+ * @param mask : the cells of the placement
+ * @param occupied : the cells of the ships on the board
+ * @return TRUE if they have a common cell, FALSE otherwise
+ */
+int placementCollides(FleetPlacer *placer, const BitBoard *mask, const BitBoard *occupied)
+{
+    int i;
+    placer->steps++;
+    for (i = 0 ; i < placer->numOfWords ; ++i)
+    {
+        if (mask->words[i] & occupied->words[i])
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * this function splits the ships of the registry to groups by their length.
+ * @param placer : the search
+ * @return the number of the cells of all the ships
+ */
+int groupShips(FleetPlacer *placer)
+{
+    const ShipRegistry *registry = &placer->game->ships;
+    int numOfShipsAt[MAX_SHIP_LENGTH + 1] = {0};
+    int groupOf[MAX_SHIP_LENGTH + 1];
+    int i, length, numOfCells = 0;
+    for (i = 0 ; i < registry->numOfShips ; ++i)
+    {
+        numOfShipsAt[registry->length[i]]++;
+        numOfCells += registry->length[i];
+    }
+    int numOfGrouped = 0;
+    placer->numOfGroups = 0;
+    for (length = MAX_SHIP_LENGTH ; length >= 1 ; --length)
+    {
+        if (numOfShipsAt[length] == 0)
+        {
+            continue;
+        }
+        PlacerGroup *group = &placer->groups[placer->numOfGroups];
+        group->length = length;
+        group->numOfShips = 0;
+        group->numLeft = numOfShipsAt[length];
+        group->ships = placer->ships + numOfGrouped;
+        group->last = -1;
+        group->cells = NULL;
+        group->masks = NULL;
+        group->starts = NULL;
+        numOfGrouped += numOfShipsAt[length];
+        groupOf[length] = placer->numOfGroups++;
+    }
+    for (i = 0 ; i < registry->numOfShips ; ++i)
+    {
+        PlacerGroup *group = &placer->groups[groupOf[registry->length[i]]];
+        group->ships[group->numOfShips++] = i;
+    }
+    return numOfCells;
+}
+
+/**
+ * this function makes the placements of every group, in a random order, and the table of the
+ * placement that starts at every cell.
+ * @param placer : the search
+ * @return TRUE on success, FALSE if out of memory (free the placements with freePlacements)
+ */
+int buildPlacements(FleetPlacer *placer)
+{
+    int size = placer->game->gameBoard.size;
+    int g, row, col, direction, i;
+    for (g = 0 ; g < placer->numOfGroups ; ++g)
+    {
+        PlacerGroup *group = &placer->groups[g];
+        int numOfDirections = (group->length == 1) ? 1 : NUM_OF_ORIENTATIONS; // a cell is a cell
+        int maxPlacements = numOfDirections * size * (size - group->length + 1);
+        group->numOfPlacements = 0;
+        group->cells = (int *) malloc(sizeof(int) * maxPlacements);
+        group->masks = (BitBoard *) malloc(sizeof(BitBoard) * maxPlacements);
+        group->starts = (int *) malloc(sizeof(int) * size * size * NUM_OF_ORIENTATIONS);
+        if (group->cells == NULL || group->masks == NULL || group->starts == NULL)
+        {
+            return FALSE;
+        }
+        for (direction = 0 ; direction < numOfDirections ; ++direction)
+        {
+            int lastRow = (direction == 0) ? size : size - group->length + 1;
+            int lastCol = (direction == 0) ? size - group->length + 1 : size;
+            for (row = 0 ; row < lastRow ; ++row)
+            {
+                for (col = 0 ; col < lastCol ; ++col)
+                {
+                    int cell = row * size + col;
+                    bitBoardSegment(&group->masks[group->numOfPlacements], cell,
+                                    (direction == 0) ? 1 : size, group->length);
+                    group->cells[group->numOfPlacements++] =
+                            cell * NUM_OF_ORIENTATIONS + direction;
+                }
+            }
+        }
+        for (i = group->numOfPlacements - 1 ; i > 0 ; --i)
+        { // shuffle them (fisher yates)
+            int j = (int) rngBounded(&placer->game->rng, (uint32_t) i + 1);
+            int cell = group->cells[i];
+            BitBoard mask = group->masks[i];
+            group->cells[i] = group->cells[j];
+            group->masks[i] = group->masks[j];
+            group->cells[j] = cell;
+            group->masks[j] = mask;
+        }
+        for (i = 0 ; i < size * size * NUM_OF_ORIENTATIONS ; ++i)
+        {
+            group->starts[i] = -1;
+        }
+        for (i = 0 ; i < group->numOfPlacements ; ++i)
+        {
+            group->starts[group->cells[i]] = i;
+        }
+    }
+    return TRUE;
+}
+
+/**
+ * this function frees the placements of the groups.
+ * @param placer : the search
+ */
+void freePlacements(FleetPlacer *placer)
+{
+    int g;
+    for (g = 0 ; g < placer->numOfGroups ; ++g)
+    {
+        free(placer->groups[g].cells);
+        free(placer->groups[g].masks);
+        free(placer->groups[g].starts);
+    }
+}
+
+/**
+ * this function searches for a layout of the ships that were not placed yet.
+ * @param placer : the search
+ * @param depth : the number of ships that were placed
+ * @param occupied : the cells of the ships that were placed
+ * @param numOfFree : the number of free cells on the board
+ * @param numOfCells : the number of cells of the ships that were not placed yet
+ * @return TRUE if a layout was found, FALSE if there is none or the search ran out of steps
+ */
+int searchLayout(FleetPlacer *placer, const int depth, const BitBoard *occupied,
+                 const int numOfFree, const int numOfCells)
+{
+    if (depth == placer->game->ships.numOfShips)
+    {
+        return TRUE;
+    }
+    if (numOfCells > numOfFree || placer->steps > PLACER_MAX_STEPS)
+    {
+        return FALSE;
+    }
+    int best = -1, bestCount = INT_MAX;
+    int g, i;
+    for (g = 0 ; g < placer->numOfGroups ; ++g)
+    { // find the most constrained group
+        const PlacerGroup *group = &placer->groups[g];
+        if (group->numLeft == 0)
+        {
+            continue;
+        }
+        int count = 0;
+        int enough = (bestCount > group->numLeft) ? bestCount : group->numLeft;
+        for (i = group->last + 1 ; i < group->numOfPlacements && count < enough ; ++i)
+        {
+            count += (placementCollides(placer, &group->masks[i], occupied) == FALSE) ? 1 : 0;
+        }
+        if (count < group->numLeft)
+        { // not enough room for the ships of the group
+            return FALSE;
+        }
+        if (count < bestCount)
+        {
+            best = g;
+            bestCount = count;
+        }
+    }
+    PlacerGroup *group = &placer->groups[best];
+    int last = group->last;
+    for (i = last + 1 ; i < group->numOfPlacements && placer->steps <= PLACER_MAX_STEPS ; ++i)
+    {
+        if (placementCollides(placer, &group->masks[i], occupied) == TRUE)
+        {
+            continue;
+        }
+        BitBoard next = *occupied;
+        bitBoardOr(&next, &group->masks[i]);
+        group->last = i;
+        group->numLeft--;
+        placer->placedGroup[depth] = best;
+        placer->placed[depth] = i;
+        if (searchLayout(placer, depth + 1, &next, numOfFree - group->length,
+                         numOfCells - group->length) == TRUE)
+        {
+            return TRUE;
+        }
+        group->numLeft++;
+    }
+    group->last = last;
+    return FALSE;
+}
+
+/**
+ * this function searches for a layout of the ships that were not placed yet, when they cover all
+ * the free cells. the first free cell must be covered, and all the cells before it are taken, so
+ * the ship that covers it starts at it- the search only tries the ships that start there (at
+ * most two placements of every group).
+ * @param placer : the search
+ * @param depth : the number of ships that were placed
+ * @param occupied : the cells of the ships that were placed
+ * @param cell : a cell with no free cells before it
+ * @return TRUE if a layout was found, FALSE if there is none or the search ran out of steps
+ */
+int coverLayout(FleetPlacer *placer, const int depth, const BitBoard *occupied, int cell)
+{
+    if (depth == placer->game->ships.numOfShips)
+    {
+        return TRUE;
+    }
+    if (placer->steps > PLACER_MAX_STEPS)
+    {
+        return FALSE;
+    }
+    while (bitBoardTest(occupied, cell))
+    { // a ship is left, so a free cell is left
+        cell++;
+    }
+    int groups[MAX_SHIP_LENGTH * NUM_OF_ORIENTATIONS];
+    int placements[MAX_SHIP_LENGTH * NUM_OF_ORIENTATIONS];
+    int numOfCandidates = 0;
+    int g, direction, i;
+    for (g = 0 ; g < placer->numOfGroups ; ++g)
+    {
+        const PlacerGroup *group = &placer->groups[g];
+        for (direction = 0 ; direction < NUM_OF_ORIENTATIONS && group->numLeft > 0 ; ++direction)
+        {
+            int placement = group->starts[cell * NUM_OF_ORIENTATIONS + direction];
+            if (placement < 0)
+            {
+                continue;
+            }
+            for (i = numOfCandidates ; i > 0 && placements[i - 1] > placement ; --i)
+            { // in the random order of the placements
+                groups[i] = groups[i - 1];
+                placements[i] = placements[i - 1];
+            }
+            groups[i] = g;
+            placements[i] = placement;
+            numOfCandidates++;
+        }
+    }
+    for (i = 0 ; i < numOfCandidates && placer->steps <= PLACER_MAX_STEPS ; ++i)
+    {
+        PlacerGroup *group = &placer->groups[groups[i]];
+        if (placementCollides(placer, &group->masks[placements[i]], occupied) == TRUE)
+        {
+            continue;
+        }
+        BitBoard next = *occupied;
+        bitBoardOr(&next, &group->masks[placements[i]]);
+        group->numLeft--;
+        placer->placedGroup[depth] = groups[i];
+        placer->placed[depth] = placements[i];
+        if (coverLayout(placer, depth + 1, &next, cell + 1) == TRUE)
+        {
+            return TRUE;
+        }
+        group->numLeft++;
+    }
+    return FALSE;
+}
+
+/**
+ * this function places all the ships of the registry of the game with the backtracking search.
+ * @param game : the game, with its board and its registry built
+ * @return TRUE if the fleet was placed, NO_PLACEMENT if it has no layout on the board (the whole
+ * search found none), PLACEMENT_TIMEOUT if the search ran out of steps before it found one, FALSE
+ * if out of memory
+ */
+int solveFleetPlacement(Game *game)
+{
+    FleetPlacer placer;
+    int size = game->gameBoard.size;
+    placer.game = game;
+    placer.numOfWords = (size * size + BITBOARD_WORD_BITS - 1) / BITBOARD_WORD_BITS;
+    placer.steps = 0;
+    int numOfCells = groupShips(&placer);
+    if (numOfCells > size * size)
+    { // the fleet is bigger than the board
+        return NO_PLACEMENT;
+    }
+    if (buildPlacements(&placer) == FALSE)
+    {
+        freePlacements(&placer);
+        return FALSE;
+    }
+    BitBoard occupied;
+    bitBoardClear(&occupied);
+    int searchFlag = (numOfCells == size * size) ? coverLayout(&placer, 0, &occupied, 0) :
+                     searchLayout(&placer, 0, &occupied, size * size, numOfCells);
+    STAT_ADD(COUNTER_PLACER_STEPS, placer.steps);
+    if (searchFlag == TRUE)
+    {
+        int placedOfGroup[MAX_SHIP_LENGTH] = {0};
+        int depth;
+        initBoard(&game->gameBoard);
+        for (depth = 0 ; depth < game->ships.numOfShips ; ++depth)
+        {
+            int g = placer.placedGroup[depth];
+            PlacerGroup *group = &placer.groups[g];
+            int chosen = group->cells[placer.placed[depth]];
+            int cell = chosen / NUM_OF_ORIENTATIONS;
+            placeShipAt(group->ships[placedOfGroup[g]++], cell / size, cell % size,
+                        chosen % NUM_OF_ORIENTATIONS, game);
+        }
+    }
+    freePlacements(&placer);
+    if (searchFlag == TRUE)
+    {
+        return TRUE;
+    }
+    return (placer.steps > PLACER_MAX_STEPS) ? PLACEMENT_TIMEOUT : NO_PLACEMENT;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file placer.h
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the fleet placement solver- a backtracking search for a layout of a fleet that the fleet
+ * kernels can't place (a heavy fleet on a small board).
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * the fleet kernels place the ships one after the other, and a ship that was placed early can
+ * leave no room for the ships after it. on a dense board every pass of the kernel fails, even if
+ * the fleet has a layout. the solver finds a layout with a depth first search:
+ * - the ships of the same length are a group. all the placements of the group (the bitboards of
+ *   the cells of its ship in every place and orientation on the board) are made once, in a random
+ *   order from the rng of the game.
+ * - at every step the solver counts the placements of every group that don't collide with the
+ *   ships already placed (a bitboard overlap check), and places a ship of the group with the
+ *   fewest- the most constrained ship first. a group with no placement left, or less free cells
+ *   than the cells of the ships left, is a dead end and the search backtracks.
+ * - the ships of a group are the same, so a ship of a group only takes a placement that comes
+ *   after the placement of the ship of the group before it in the random order. a layout is never
+ *   visited twice under a different order of its same ships.
+ * - a fleet that covers the whole board is an exact cover, so the solver branches on the first
+ *   free cell instead- the ship that covers it must start at it, so there are at most two
+ *   placements of every group to try.
+ * every check of a placement is a step, and the search stops after PLACER_MAX_STEPS steps. so the
+ * time to place a fleet has a hard bound: the passes of the kernel and then at most
+ * PLACER_MAX_STEPS checks. a search that stops there gives PLACEMENT_TIMEOUT, not NO_PLACEMENT-
+ * the fleet may still have a layout. the layout is random (the random order of the placements), but not
+ * uniform over all the layouts of the fleet.
+ */
+
+#ifndef EX2_PLACER_H
+#define EX2_PLACER_H
+
+#include "battleships.h"
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the largest number of placement checks of a single search.
+ */
+#define PLACER_MAX_STEPS (1L << 22)
+
+
+// ------------------------------ function declarations -----------------------------
+
+/**
+ * this function places all the ships of the registry of the game with the backtracking search.
+ * @param game : the game, with its board and its registry built
+ * @return TRUE if the fleet was placed, NO_PLACEMENT if it has no layout on the board (the whole
+ * search found none), PLACEMENT_TIMEOUT if the search ran out of steps before it found one, FALSE
+ * if out of memory
+ */
+int solveFleetPlacement(Game *game);
+
+#endif //EX2_PLACER_H
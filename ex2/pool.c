@@ -0,0 +1,173 @@
+// ------------------------------ includes ------------------------------
+
+#include <stdlib.h>
+#include <string.h>
+#include "pool.h"
+
+/**
+ * @file pool.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief this is the implementation file for the board pool.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * this is the implementation file for the per thread free lists of the board blocks.
+ * Input  : the blocks that are taken and given back
+ * Process: implementation for the functions in pool.h
+ * Output : the blocks
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * @brief the header line before a block.
+ * @bytes the size of the block (rounded up to POOL_ALIGNMENT)
+ * @next the next free block of the same size, while the block is in the pool
+ */
+typedef struct PoolBlock
+{
+    size_t bytes;
+    struct PoolBlock *next;
+} __attribute__((aligned(POOL_ALIGNMENT))) PoolBlock;
+
+/**
+ * @brief the free blocks of a single size.
+ * @bytes the size of the blocks
+ * @numOfFree the number of free blocks
+ * @free the first free block
+ */
+typedef struct PoolClass
+{
+    size_t bytes;
+    int numOfFree;
+    PoolBlock *free;
+} PoolClass;
+
+/**
+ * the pool of the thread- its sizes and its counters.
+ */
+__thread PoolClass poolClasses[POOL_CLASSES];
+__thread int numOfPoolClasses = 0;
+__thread PoolStats poolStats;
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function finds the free list of a size in the pool of the thread, and adds one if there is
+ * room for it.
+ * @param bytes : the size (rounded up to POOL_ALIGNMENT)
+ * @return the free list, or NULL if the pool has no room for another size
+ */
+PoolClass *findPoolClass(const size_t bytes)
+{
+    int i;
+    for (i = 0 ; i < numOfPoolClasses ; ++i)
+    {
+        if (poolClasses[i].bytes == bytes)
+        {
+            return &poolClasses[i];
+        }
+    }
+    if (numOfPoolClasses == POOL_CLASSES)
+    {
+        return NULL;
+    }
+    PoolClass *poolClass = &poolClasses[numOfPoolClasses++];
+    poolClass->bytes = bytes;
+    poolClass->numOfFree = 0;
+    poolClass->free = NULL;
+    return poolClass;
+}
+
+/**
+ * this function takes a zeroed block from the pool of the thread. (allocates one if the pool has
+ * no free block of the size! give it back with releaseBoardBlock)
+ * @param bytes : the size of the block
+ * @return the block (aligned to POOL_ALIGNMENT), or NULL if out of memory
+ */
+void *acquireBoardBlock(size_t bytes)
+{
+    bytes = (bytes + POOL_ALIGNMENT - 1) & ~(size_t) (POOL_ALIGNMENT - 1);
+    PoolClass *poolClass = findPoolClass(bytes);
+    PoolBlock *block;
+    if (poolClass != NULL && poolClass->free != NULL)
+    {
+        block = poolClass->free;
+        poolClass->free = block->next;
+        poolClass->numOfFree--;
+        poolStats.numOfFree--;
+        poolStats.reuses++;
+    }
+    else
+    {
+        void *memory;
+        if (posix_memalign(&memory, POOL_ALIGNMENT, sizeof(PoolBlock) + bytes) != 0)
+        { // out of memory
+            return NULL;
+        }
+        block = (PoolBlock *) memory;
+        block->bytes = bytes;
+        poolStats.heapAllocations++;
+    }
+    memset(block + 1, 0, bytes);
+    return block + 1;
+}
+
+/**
+ * this function gives a block back to the pool of the thread.
+ * @param block : a block from acquireBoardBlock (may be NULL)
+ */
+void releaseBoardBlock(void *block)
+{
+    if (block == NULL)
+    {
+        return;
+    }
+    PoolBlock *header = (PoolBlock *) block - 1;
+    PoolClass *poolClass = findPoolClass(header->bytes);
+    if (poolClass == NULL || poolClass->numOfFree == POOL_MAX_FREE)
+    { // no room in the pool
+        free(header);
+        return;
+    }
+    header->next = poolClass->free;
+    poolClass->free = header;
+    poolClass->numOfFree++;
+    poolStats.numOfFree++;
+}
+
+/**
+ * this function frees all the free blocks of the pool of the thread (call it before the thread
+ * exits).
+ */
+void drainBoardPool(void)
+{
+    int i;
+    for (i = 0 ; i < numOfPoolClasses ; ++i)
+    {
+        while (poolClasses[i].free != NULL)
+        {
+            PoolBlock *block = poolClasses[i].free;
+            poolClasses[i].free = block->next;
+            free(block);
+        }
+        poolClasses[i].numOfFree = 0;
+    }
+    poolStats.numOfFree = 0;
+}
+
+/**
+ * this function gives the counters of the pool of the thread.
+ * @return the counters
+ */
+PoolStats readBoardPoolStats(void)
+{
+    return poolStats;
+}
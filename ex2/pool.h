@@ -0,0 +1,88 @@
+/**
+ * @file pool.h
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the board pool- a per thread cache of the board blocks, so a game that ends gives its
+ * block to the next game of the thread instead of back to malloc.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * the block of a board (its cells and its ship registry, see buildGameBoard) is taken with
+ * acquireBoardBlock and given back with releaseBoardBlock. every thread has its own pool with a
+ * free list for every block size it used (a size of the board and a number of ships), so taking
+ * and giving a block back is a push or a pop with no lock and no atomics. a block is aligned to
+ * a cache line (a header line before it keeps its size and its link in the free list), and is
+ * zeroed with a single memset when it is taken. only a thread that has no free block of the
+ * size calls malloc, so a thread that plays one game after the other allocates once and then
+ * never again- the heapAllocations of its PoolStats stay fixed.
+ * a block may be given back on another thread, it just goes to the pool of that thread. the free
+ * blocks of a thread stay in its pool until it calls drainBoardPool.
+ */
+
+#ifndef EX2_POOL_H
+#define EX2_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the alignment of a block (a cache line).
+ */
+#define POOL_ALIGNMENT 64
+
+/**
+ * the number of block sizes a pool keeps, and the number of free blocks it keeps of every size
+ * (a block over them goes back to free).
+ */
+#define POOL_CLASSES 8
+#define POOL_MAX_FREE 32
+
+/**
+ * @brief the counters of the pool of a thread.
+ * @heapAllocations the blocks that were allocated with malloc
+ * @reuses the blocks that were taken from the pool
+ * @numOfFree the blocks in the pool now
+ */
+typedef struct PoolStats
+{
+    uint64_t heapAllocations;
+    uint64_t reuses;
+    uint64_t numOfFree;
+} PoolStats;
+
+
+// ------------------------------ function declarations -----------------------------
+
+/**
+ * this function takes a zeroed block from the pool of the thread. (allocates one if the pool has
+ * no free block of the size! give it back with releaseBoardBlock)
+ * @param bytes : the size of the block
+ * @return the block (aligned to POOL_ALIGNMENT), or NULL if out of memory
+ */
+void *acquireBoardBlock(size_t bytes);
+
+/**
+ * this function gives a block back to the pool of the thread.
+ * @param block : a block from acquireBoardBlock (may be NULL)
+ */
+void releaseBoardBlock(void *block);
+
+/**
+ * this function frees all the free blocks of the pool of the thread (call it before the thread
+ * exits).
+ */
+void drainBoardPool(void);
+
+/**
+ * this function gives the counters of the pool of the thread.
+ * @return the counters
+ */
+PoolStats readBoardPoolStats(void);
+
+#endif //EX2_POOL_H
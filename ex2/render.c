@@ -0,0 +1,407 @@
+// ------------------------------ includes ------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include "render.h"
+#include "stats.h"
+
+/**
+ * @file render.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief this is the implementation file for the board renderer.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * this is the implementation file for the board renderer.
+ * Input  : none
+ * Process: implementation for the functions in render.h
+ * Output : the frames of the board
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * @brief the symbols of the cell statuses on the printed board, indexed by the status bits of the
+ * packed cell- unreached (_), miss (o) and hit (x).
+ */
+const char STATUS_SYMBOLS[] = {'_', 'o', 'x'};
+
+/**
+ * @brief the ANSI escape that clears the screen and moves the cursor to its top.
+ */
+const char *CLEAR_SCREEN = "\033[2J\033[H";
+
+/**
+ * the marks of a block of the overview.
+ */
+#define OVERVIEW_MISS 1
+#define OVERVIEW_HIT 2
+
+/**
+ * @brief the symbols of the blocks of the overview, indexed by their marks- no shot (_), only
+ * misses (o) and a hit (x).
+ */
+const char OVERVIEW_SYMBOLS[] = {'_', 'o', 'x', 'x'};
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function writes a whole buffer to a file descriptor (write may write only a part of it).
+ * @param fd : the file descriptor
+ * @param buffer : the buffer
+ * @param length : the length of the buffer
+ */
+void writeAll(const int fd, const char *buffer, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(fd, buffer, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;
+        }
+        buffer += written;
+        length -= (size_t) written;
+    }
+}
+
+/**
+ * this function sets a new renderer.
+ * @param renderer : the renderer
+ * @param fd : the file descriptor to write the frames to
+ * @param isIncremental : TRUE for the incremental mode, FALSE for full frames
+ */
+void initRenderer(Renderer *renderer, const int fd, const int isIncremental)
+{
+    renderer->fd = fd;
+    renderer->isIncremental = isIncremental;
+    renderer->isDrawn = FALSE;
+    renderer->size = 0;
+    renderer->viewportSide = 0;
+    renderer->focusRow = -1;
+    renderer->focusCol = -1;
+    renderer->hasNewShot = FALSE;
+    renderer->overviewBoard = NULL;
+}
+
+/**
+ * this function builds the layout of the frame for a board size- the header with the column
+ * numbers, the row letters and the spaces between the cells. the cells are filled on render.
+ * @param renderer : the renderer
+ * @param size : the size of the board
+ */
+void buildLayout(Renderer *renderer, const int size)
+{
+    char *frame = renderer->frame;
+    int length = 0;
+    int row, col;
+    frame[length++] = ' ';
+    for (col = 1 ; col <= size ; ++col) // the col numbers
+    {
+        length += sprintf(frame + length, " %d", col);
+    }
+    frame[length++] = '\n';
+    renderer->headerLength = length;
+    renderer->rowLength = 2 * size + 2;
+    for (row = 0 ; row < size ; ++row)
+    {
+        frame[length++] = (char) ('a' + row); // the row letters
+        for (col = 0 ; col < size ; ++col)
+        {
+            frame[length++] = ' ';
+            frame[length++] = STATUS_SYMBOLS[0];
+        }
+        frame[length++] = '\n';
+    }
+    renderer->frameLength = length;
+    renderer->size = size;
+    renderer->isDrawn = FALSE;
+}
+
+/**
+ * this function writes the escape that moves the cursor to a place on the screen.
+ * @param buffer : the buffer to write to
+ * @param line : the line on the screen (from 1)
+ * @param column : the column on the screen (from 1)
+ * @return the number of chars written
+ */
+int moveCursor(char *buffer, const int line, const int column)
+{
+    return sprintf(buffer, "\033[%d;%dH", line, column);
+}
+
+/**
+ * this function renders the board. the standard output is flushed first, so the frame comes
+ * after everything that was printed before it.
+ * @param renderer : the renderer
+ * @param gameBoard : the board to render
+ */
+void renderBoard(Renderer *renderer, const GameBoard *gameBoard)
+{
+    if (renderer->viewportSide > 0)
+    {
+        BoardView view;
+        viewGameBoard(gameBoard, &view);
+        renderView(renderer, &view);
+        return;
+    }
+    STAT_TIMER_START(start);
+    int size = gameBoard->size;
+    if (renderer->size != size)
+    {
+        buildLayout(renderer, size);
+    }
+    fflush(stdout);
+    char *update = renderer->update;
+    int updateLength = 0;
+    int isFullFrame = (renderer->isIncremental == FALSE || renderer->isDrawn == FALSE) ? TRUE :
+                      FALSE;
+    const Cell *cell = gameBoard->board;
+    int row, col;
+    for (row = 0 ; row < size ; ++row)
+    {
+        char *symbol = renderer->frame + renderer->headerLength + row * renderer->rowLength + 2;
+        for (col = 0 ; col < size ; ++col, symbol += 2)
+        {
+            char newSymbol = STATUS_SYMBOLS[CELL_STATUS(*cell++) >> CELL_SHIP_BITS];
+            if (*symbol != newSymbol && isFullFrame == FALSE)
+            { // the frame line of the row is line row + 2 on the screen
+                updateLength += moveCursor(update + updateLength, row + 2, 2 * col + 3);
+                update[updateLength++] = newSymbol;
+            }
+            *symbol = newSymbol;
+        }
+    }
+    if (renderer->isIncremental == FALSE)
+    {
+        writeAll(renderer->fd, renderer->frame, (size_t) renderer->frameLength);
+    }
+    else
+    {
+        if (isFullFrame == TRUE)
+        {
+            updateLength = sprintf(update, "%s", CLEAR_SCREEN);
+            memcpy(update + updateLength, renderer->frame, (size_t) renderer->frameLength);
+            updateLength += renderer->frameLength;
+            renderer->isDrawn = TRUE;
+        }
+        // go to the input line (under the message line) and clear everything from it down
+        updateLength += moveCursor(update + updateLength, size + 3, 1);
+        updateLength += sprintf(update + updateLength, "\033[J");
+        writeAll(renderer->fd, update, (size_t) updateLength);
+    }
+    STAT_TIMER_STOP(TIMER_RENDER, start);
+    STAT_ADD(COUNTER_RENDERS, 1);
+}
+
+/**
+ * this function shows a message to the user. in the incremental mode the message is written to
+ * the message line under the board, otherwise it is just printed.
+ * @param renderer : the renderer
+ * @param message : the message (ends with a new line)
+ */
+void renderMessage(Renderer *renderer, const char *message)
+{
+    if (renderer->isIncremental == TRUE && renderer->isDrawn == TRUE)
+    { // the message line is the line right after the frame, clear it first
+        printf("\033[%d;1H\033[2K", renderer->size + 2);
+    }
+    printf("%s", message);
+}
+
+/**
+ * this function sets the viewport mode of a renderer. the frames of the viewport mode are always
+ * full frames (with no incremental updates).
+ * @param renderer : the renderer
+ * @param side : the side of the window (up to RENDER_MAX_VIEWPORT), 0 to render the whole board
+ */
+void setViewport(Renderer *renderer, const int side)
+{
+    renderer->viewportSide = side;
+    renderer->overviewBoard = NULL;
+}
+
+/**
+ * this function centers the window of the viewport mode on the last shot. every shot after the
+ * first window of a board must be given here before the next window, so the overview has it.
+ * @param renderer : the renderer
+ * @param row : the row of the shot
+ * @param col : the column of the shot
+ */
+void focusViewport(Renderer *renderer, const int row, const int col)
+{
+    renderer->focusRow = row;
+    renderer->focusCol = col;
+    renderer->hasNewShot = TRUE;
+}
+
+/**
+ * this function gives the status of a cell of a packed board (for a BoardView).
+ * @param board : the board (a GameBoard)
+ * @param row : the row of the cell
+ * @param col : the column of the cell
+ * @return STATUS_UNREACHED, STATUS_MISS or STATUS_HIT
+ */
+int gameBoardStatusAt(const void *board, const int row, const int col)
+{
+    return CELL_STATUS(CELL_AT((const GameBoard *) board, row, col));
+}
+
+/**
+ * this function gives all the shots of a packed board to a visitor (for a BoardView).
+ * @param board : the board (a GameBoard)
+ * @param visit : the visitor
+ * @param context : the context of the visitor
+ */
+void forEachGameBoardShot(const void *board, const ShotVisitor visit, void *context)
+{
+    forEachShot((const GameBoard *) board, visit, context);
+}
+
+/**
+ * this function sets a BoardView of a packed board.
+ * @param gameBoard : the board
+ * @param view : will be set to the view
+ */
+void viewGameBoard(const GameBoard *gameBoard, BoardView *view)
+{
+    view->board = gameBoard;
+    view->size = gameBoard->size;
+    view->statusAt = gameBoardStatusAt;
+    view->forEachShot = forEachGameBoardShot;
+}
+
+/**
+ * this function adds a shot to the marks of its block in the overview (a ShotVisitor).
+ * @param context : the renderer
+ * @param row : the row of the shot
+ * @param col : the column of the shot
+ * @param status : the status of the cell
+ */
+void markOverview(void *context, const int row, const int col, const int status)
+{
+    Renderer *renderer = (Renderer *) context;
+    int block = (row / renderer->blockSide) * RENDER_OVERVIEW_SIDE + col / renderer->blockSide;
+    renderer->overviewMarks[block] |= (status == STATUS_HIT) ? OVERVIEW_HIT :
+                                      (status == STATUS_MISS) ? OVERVIEW_MISS : 0;
+}
+
+/**
+ * this function builds the overview of a board from all of its shots.
+ * @param renderer : the renderer
+ * @param view : the board
+ */
+void buildOverview(Renderer *renderer, const BoardView *view)
+{
+    renderer->blockSide = (view->size + RENDER_OVERVIEW_SIDE - 1) / RENDER_OVERVIEW_SIDE;
+    renderer->overviewSide = (view->size + renderer->blockSide - 1) / renderer->blockSide;
+    memset(renderer->overviewMarks, 0, sizeof(renderer->overviewMarks));
+    view->forEachShot(view->board, markOverview, renderer);
+    renderer->overviewBoard = view->board;
+    renderer->overviewSize = view->size;
+    renderer->hasNewShot = FALSE;
+}
+
+/**
+ * this function gives the first line (or column) of the window on a board.
+ * @param focus : the line the window is centered on, -1 for the center of the board
+ * @param side : the side of the window
+ * @param size : the size of the board
+ * @return the first line, so the window is inside the board
+ */
+int windowStart(const int focus, const int side, const int size)
+{
+    int start = ((focus < 0) ? size / 2 : focus) - side / 2;
+    if (start > size - side)
+    {
+        start = size - side;
+    }
+    return (start < 0) ? 0 : start;
+}
+
+/**
+ * this function renders the window of a board around the focus and the overview of the board.
+ * the standard output is flushed first, so the frame comes after everything that was printed
+ * before it.
+ * @param renderer : the renderer (in the viewport mode)
+ * @param view : the board
+ */
+void renderView(Renderer *renderer, const BoardView *view)
+{
+    STAT_TIMER_START(start);
+    int size = view->size;
+    if (renderer->overviewBoard != view->board || renderer->overviewSize != size)
+    {
+        buildOverview(renderer, view);
+    }
+    else if (renderer->hasNewShot == TRUE &&
+             isIndexInBoard(renderer->focusRow, renderer->focusCol, size) == TRUE)
+    { // only the last shot changed the board since the last window
+        markOverview(renderer, renderer->focusRow, renderer->focusCol,
+                     view->statusAt(view->board, renderer->focusRow, renderer->focusCol));
+    }
+    renderer->hasNewShot = FALSE;
+    int side = (renderer->viewportSide < size) ? renderer->viewportSide : size;
+    int top = windowStart(renderer->focusRow, side, size);
+    int left = windowStart(renderer->focusCol, side, size);
+    int isLettered = (size <= 'z' - 'a' + 1) ? TRUE : FALSE; // the rows are letters like the frame
+    int labelWidth = (isLettered == TRUE) ? 1 : sprintf(renderer->window, "%d", size);
+    fflush(stdout);
+    char *window = renderer->window;
+    int length = sprintf(window, "rows %d-%d, columns %d-%d of %d\n", top + 1, top + side,
+                         left + 1, left + side, size);
+    int row, col;
+    length += sprintf(window + length, "%*s", labelWidth, "");
+    for (col = left ; col < left + side ; ++col) // the last digits of the column numbers
+    {
+        window[length++] = ' ';
+        window[length++] = (char) ('0' + (col + 1) % 10);
+    }
+    window[length++] = '\n';
+    for (row = top ; row < top + side ; ++row)
+    {
+        if (isLettered == TRUE)
+        {
+            window[length++] = (char) ('a' + row);
+        }
+        else
+        {
+            length += sprintf(window + length, "%*d", labelWidth, row + 1);
+        }
+        for (col = left ; col < left + side ; ++col)
+        {
+            window[length++] = ' ';
+            window[length++] = STATUS_SYMBOLS[view->statusAt(view->board, row, col) >>
+                                              CELL_SHIP_BITS];
+        }
+        window[length++] = '\n';
+    }
+    length += sprintf(window + length, "overview, a char for every %dx%d cells:\n",
+                      renderer->blockSide, renderer->blockSide);
+    const unsigned char *marks = renderer->overviewMarks;
+    for (row = 0 ; row < renderer->overviewSide ; ++row)
+    {
+        for (col = 0 ; col < renderer->overviewSide ; ++col)
+        {
+            window[length++] = OVERVIEW_SYMBOLS[*marks++];
+        }
+        marks += RENDER_OVERVIEW_SIDE - renderer->overviewSide;
+        window[length++] = '\n';
+    }
+    writeAll(renderer->fd, window, (size_t) length);
+    STAT_TIMER_STOP(TIMER_RENDER, start);
+    STAT_ADD(COUNTER_RENDERS, 1);
+}
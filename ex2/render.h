@@ -0,0 +1,187 @@
+/**
+ * @file render.h
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the board renderer. the whole frame of the board is composed in one buffer and written
+ * to the screen with a single write.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * the frame has a fixed layout for a given board size- the header line with the column numbers
+ * and one line per row where the symbol of every cell is in a known place. the layout is built
+ * once per board size, and every render only writes the cell symbols into it.
+ * in the incremental mode (for slow terminals) the frame is drawn once, and then every render
+ * only moves the cursor to the cells that changed (with ANSI escapes) and writes them.
+ * the screen layout of the incremental mode is: the frame from the first line, a line for the
+ * messages right under it, and the input line under that.
+ * in the viewport mode (for big boards, or spectators) a frame is only a window of the board
+ * around the last shot and an overview map under it, where every char sums up a square block of
+ * cells (x if a cell of the block was hit, o if only misses, _ if none was shot). the board is
+ * read through a BoardView, so the same renderer shows a packed board and a sparse one. a window
+ * reads only its own cells and the overview keeps the marks of its blocks and adds the last shot
+ * to them, so the cost of a frame depends on the viewport and not on the size of the board (only
+ * the first frame of a board walks all of its shots, with forEachShot of the view).
+ */
+
+#ifndef EX2_RENDER_H
+#define EX2_RENDER_H
+
+#include "battleships.h"
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the sizes of the buffers of the renderer, for the largest board:
+ * the header is a space and up to 3 chars for every column, every row is the letter, a space and
+ * a symbol for every column and the new line. an incremental update takes up to
+ * RENDER_ESCAPE_CAPACITY chars for every cell, plus the escapes of the input line.
+ */
+#define RENDER_ESCAPE_CAPACITY 16
+#define RENDER_HEADER_CAPACITY (1 + 3 * BITBOARD_MAX_SIDE + 1)
+#define RENDER_FRAME_CAPACITY (RENDER_HEADER_CAPACITY + \
+                               BITBOARD_MAX_SIDE * (2 * BITBOARD_MAX_SIDE + 2))
+#define RENDER_UPDATE_CAPACITY ((BITBOARD_MAX_SIDE * BITBOARD_MAX_SIDE + 2) * \
+                                RENDER_ESCAPE_CAPACITY)
+
+/**
+ * the limits of the viewport mode: the largest window (its side in cells), the side of the
+ * overview (in blocks) and the widest row label. a window frame has a title line, a header line,
+ * a line for every row (the label, a space and a symbol for every column and the new line), the
+ * title of the overview and its lines.
+ */
+#define RENDER_MAX_VIEWPORT 64
+#define RENDER_OVERVIEW_SIDE 32
+#define RENDER_LABEL_CAPACITY 8
+#define RENDER_TITLE_CAPACITY 128
+#define RENDER_WINDOW_LINE (RENDER_LABEL_CAPACITY + 2 * RENDER_MAX_VIEWPORT + 2)
+#define RENDER_WINDOW_CAPACITY (2 * RENDER_TITLE_CAPACITY + \
+                                (RENDER_MAX_VIEWPORT + 1) * RENDER_WINDOW_LINE + \
+                                RENDER_OVERVIEW_SIDE * (RENDER_OVERVIEW_SIDE + 1))
+
+/**
+ * @brief a board as the viewport renderer reads it.
+ * @board the board (a GameBoard for viewGameBoard, a SparseBoard for viewSparseBoard)
+ * @size the number of rows (and columns) of the board
+ * @statusAt gives the status of a cell (STATUS_UNREACHED, STATUS_MISS or STATUS_HIT)
+ * @forEachShot gives all the shots of the board to a visitor
+ */
+typedef struct BoardView
+{
+    const void *board;
+    int size;
+    int (*statusAt)(const void *board, int row, int col);
+    void (*forEachShot)(const void *board, ShotVisitor visit, void *context);
+} BoardView;
+
+/**
+ * @brief the renderer of a board.
+ * @fd the file descriptor the frames are written to
+ * @isIncremental TRUE for the incremental mode, FALSE to write the full frame every time
+ * @isDrawn TRUE once a full frame is on the screen (in the incremental mode)
+ * @size the board size the layout of the frame was built for (0 before the first render)
+ * @headerLength the length of the header line in the frame
+ * @rowLength the length of every row line in the frame
+ * @frameLength the length of the whole frame
+ * @frame the last frame
+ * @update the buffer of the incremental updates
+ * @viewportSide the side of the window in the viewport mode, 0 to render the whole board
+ * @focusRow the row of the cell the window is centered on (-1 for the center of the board)
+ * @focusCol the column of the cell the window is centered on
+ * @hasNewShot TRUE if the focus is a shot that the overview has no mark of yet
+ * @overviewBoard the board the marks of the overview belong to, NULL before the first window
+ * @overviewSize the size of that board
+ * @blockSide the side of the block of cells of a char of the overview
+ * @overviewSide the number of rows (and columns) of the overview
+ * @overviewMarks the marks of the blocks of the overview, row by row with rows of
+ * RENDER_OVERVIEW_SIDE marks (a bit for a miss in the block and a bit for a hit)
+ * @window the buffer of the window frames
+ */
+typedef struct Renderer
+{
+    int fd;
+    int isIncremental;
+    int isDrawn;
+    int size;
+    int headerLength;
+    int rowLength;
+    int frameLength;
+    char frame[RENDER_FRAME_CAPACITY];
+    char update[RENDER_UPDATE_CAPACITY];
+    int viewportSide;
+    int focusRow;
+    int focusCol;
+    int hasNewShot;
+    const void *overviewBoard;
+    int overviewSize;
+    int blockSide;
+    int overviewSide;
+    unsigned char overviewMarks[RENDER_OVERVIEW_SIDE * RENDER_OVERVIEW_SIDE];
+    char window[RENDER_WINDOW_CAPACITY];
+} Renderer;
+
+
+// ------------------------------ function declarations -----------------------------
+
+/**
+ * this function sets a new renderer.
+ * @param renderer : the renderer
+ * @param fd : the file descriptor to write the frames to
+ * @param isIncremental : TRUE for the incremental mode, FALSE for full frames
+ */
+void initRenderer(Renderer *renderer, int fd, int isIncremental);
+
+/**
+ * this function renders the board. the standard output is flushed first, so the frame comes
+ * after everything that was printed before it. in the viewport mode it renders the window of the
+ * board (see renderView).
+ * @param renderer : the renderer
+ * @param gameBoard : the board to render
+ */
+void renderBoard(Renderer *renderer, const GameBoard *gameBoard);
+
+/**
+ * this function sets the viewport mode of a renderer. the frames of the viewport mode are always
+ * full frames (with no incremental updates).
+ * @param renderer : the renderer
+ * @param side : the side of the window (up to RENDER_MAX_VIEWPORT), 0 to render the whole board
+ */
+void setViewport(Renderer *renderer, int side);
+
+/**
+ * this function centers the window of the viewport mode on the last shot. every shot after the
+ * first window of a board must be given here before the next window, so the overview has it.
+ * @param renderer : the renderer
+ * @param row : the row of the shot
+ * @param col : the column of the shot
+ */
+void focusViewport(Renderer *renderer, int row, int col);
+
+/**
+ * this function sets a BoardView of a packed board.
+ * @param gameBoard : the board
+ * @param view : will be set to the view
+ */
+void viewGameBoard(const GameBoard *gameBoard, BoardView *view);
+
+/**
+ * this function renders the window of a board around the focus and the overview of the board.
+ * the standard output is flushed first, so the frame comes after everything that was printed
+ * before it.
+ * @param renderer : the renderer (in the viewport mode)
+ * @param view : the board
+ */
+void renderView(Renderer *renderer, const BoardView *view);
+
+/**
+ * this function shows a message to the user. in the incremental mode the message is written to
+ * the message line under the board, otherwise it is just printed.
+ * @param renderer : the renderer
+ * @param message : the message (ends with a new line)
+ */
+void renderMessage(Renderer *renderer, const char *message);
+
+#endif //EX2_RENDER_H
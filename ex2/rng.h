@@ -0,0 +1,105 @@
+/**
+ * @file rng.h
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief a small and fast pseudo random generator (xoshiro256**) with its whole state in a
+ * struct, so every game carries its own generator instead of sharing the global rand().
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * the generator is seeded from a single 64 bit seed (expanded with splitmix64), so the same seed
+ * always gives the same sequence. bounded numbers are drawn with no modulo bias.
+ */
+
+#ifndef EX2_RNG_H
+#define EX2_RNG_H
+
+#include <stdint.h>
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * @brief the state of the generator. never all zero after rngSeed.
+ * @state the four words of the xoshiro256** state
+ */
+typedef struct Rng
+{
+    uint64_t state[4];
+} Rng;
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function rotates a word to the left.
+ * @param word : the word to rotate
+ * @param shift : the number of bits to rotate by (1 - 63)
+ * @return the rotated word
+ */
+static inline uint64_t rngRotate(const uint64_t word, const int shift)
+{
+    return (word << shift) | (word >> (64 - shift));
+}
+
+/**
+ * this function seeds the generator. the seed is expanded to the whole state with splitmix64.
+ * @param rng : the generator
+ * @param seed : any 64 bit seed
+ */
+static inline void rngSeed(Rng *rng, uint64_t seed)
+{
+    int i;
+    for (i = 0 ; i < 4 ; ++i)
+    {
+        uint64_t mixed = (seed += 0x9E3779B97F4A7C15ULL);
+        mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+        rng->state[i] = mixed ^ (mixed >> 31);
+    }
+}
+
+/**
+ * this function draws the next 64 bit number from the generator.
+ * @param rng : the generator
+ * @return a uniform 64 bit number
+ */
+static inline uint64_t rngNext(Rng *rng)
+{
+    uint64_t *s = rng->state;
+    uint64_t result = rngRotate(s[1] * 5, 7) * 9;
+    uint64_t shifted = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= shifted;
+    s[3] = rngRotate(s[3], 45);
+    return result;
+}
+
+/**
+ * this function draws a uniform number in [0, bound) with no modulo bias (multiply and reject
+ * the few low results that would make some numbers more likely).
+ * @param rng : the generator
+ * @param bound : the upper bound, must be positive
+ * @return a uniform number in [0, bound)
+ */
+static inline uint32_t rngBounded(Rng *rng, const uint32_t bound)
+{
+    uint64_t product = (rngNext(rng) >> 32) * bound;
+    if ((uint32_t) product < bound)
+    {
+        uint32_t threshold = (uint32_t) -bound % bound;
+        while ((uint32_t) product < threshold)
+        {
+            product = (rngNext(rng) >> 32) * bound;
+        }
+    }
+    return (uint32_t) (product >> 32);
+}
+
+#endif //EX2_RNG_H
@@ -0,0 +1,173 @@
+// ------------------------------ includes ------------------------------
+
+#include <stdlib.h>
+#include <math.h>
+#include "selfplay.h"
+#include "ai.h"
+
+/**
+ * @file selfplay.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief this is the implementation file for what the self play tools share.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * this is the implementation file for the shot strategies, the shot tally and the numbers of the
+ * command line.
+ * Input  : the games and the command line of the tools
+ * Process: implementation for the functions in selfplay.h
+ * Output : the shots and the statistics of the games
+ */
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function is the strategy of the computer player (see ai.h).
+ * @param game : the game
+ * @param rng : not used
+ * @param row : will be set to the row of the shot
+ * @param column : will be set to the column of the shot
+ * @return TRUE if a shot was chosen, FALSE if there is no cell left to shoot at
+ */
+int aiStrategy(const Game *game, Rng *rng, int *row, int *column)
+{
+    (void) rng;
+    return chooseShot(game, row, column);
+}
+
+/**
+ * this function shoots at a random cell that was not shot yet.
+ * @param game : the game
+ * @param rng : the random generator
+ * @param row : will be set to the row of the shot
+ * @param column : will be set to the column of the shot
+ * @return TRUE if a shot was chosen, FALSE if there is no cell left to shoot at
+ */
+int randomStrategy(const Game *game, Rng *rng, int *row, int *column)
+{
+    const GameBoard *gameBoard = &game->gameBoard;
+    int numOfCells = gameBoard->size * gameBoard->size;
+    if (bitBoardCount(&gameBoard->hits) + bitBoardCount(&gameBoard->misses) >= numOfCells)
+    {
+        return FALSE;
+    }
+    int cell;
+    do
+    {
+        cell = (int) rngBounded(rng, (uint32_t) numOfCells);
+    } while (CELL_STATUS(gameBoard->board[cell]) != STATUS_UNREACHED);
+    *row = cell / gameBoard->size;
+    *column = cell % gameBoard->size;
+    return TRUE;
+}
+
+/**
+ * this function shoots at the first cell that was not shot yet, row by row.
+ * @param game : the game
+ * @param rng : not used
+ * @param row : will be set to the row of the shot
+ * @param column : will be set to the column of the shot
+ * @return TRUE if a shot was chosen, FALSE if there is no cell left to shoot at
+ */
+int sweepStrategy(const Game *game, Rng *rng, int *row, int *column)
+{
+    (void) rng;
+    const GameBoard *gameBoard = &game->gameBoard;
+    int cell;
+    for (cell = 0 ; cell < gameBoard->size * gameBoard->size ; ++cell)
+    {
+        if (CELL_STATUS(gameBoard->board[cell]) == STATUS_UNREACHED)
+        {
+            *row = cell / gameBoard->size;
+            *column = cell % gameBoard->size;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * this function adds a won game to a tally.
+ * @param tally : the tally
+ * @param shots : the number of shots the game took (up to MAX_SHOTS)
+ */
+void tallyShots(ShotTally *tally, const uint64_t shots)
+{
+    tally->games++;
+    tally->shots += shots;
+    tally->shotsSquares += shots * shots;
+    tally->histogram[shots]++;
+}
+
+/**
+ * this function adds a tally to another one.
+ * @param total : the tally to add to
+ * @param tally : the tally to add
+ */
+void addShotTally(ShotTally *total, const ShotTally *tally)
+{
+    int i;
+    total->games += tally->games;
+    total->shots += tally->shots;
+    total->shotsSquares += tally->shotsSquares;
+    for (i = 0 ; i <= MAX_SHOTS ; ++i)
+    {
+        total->histogram[i] += tally->histogram[i];
+    }
+}
+
+/**
+ * this function gives the mean and the standard deviation of the shots of a tally.
+ * @param tally : the tally (with at least one game)
+ * @param mean : will be set to the mean
+ * @param deviation : will be set to the standard deviation
+ */
+void shotsMeanDeviation(const ShotTally *tally, double *mean, double *deviation)
+{
+    double games = (double) tally->games;
+    *mean = (double) tally->shots / games;
+    double variance = (double) tally->shotsSquares / games - *mean * *mean;
+    *deviation = (variance > 0) ? sqrt(variance) : 0.0;
+}
+
+/**
+ * this function finds the smallest number of shots that at least a part of the games of a tally
+ * took.
+ * @param tally : the tally
+ * @param part : the part of the games (between 0 and 1)
+ * @return the number of shots
+ */
+int shotsPercentile(const ShotTally *tally, const double part)
+{
+    uint64_t needed = (uint64_t) ceil(part * (double) tally->games);
+    uint64_t counted = 0;
+    int shots;
+    for (shots = 0 ; shots < MAX_SHOTS ; ++shots)
+    {
+        counted += tally->histogram[shots];
+        if (counted >= needed && counted > 0)
+        {
+            break;
+        }
+    }
+    return shots;
+}
+
+/**
+ * this function reads a number from the command line (with the prefixes of C, like 0x for hex).
+ * @param arg : the argument
+ * @param number : will be set to the number
+ * @return TRUE for a number, FALSE otherwise
+ */
+int parseCount(const char *arg, uint64_t *number)
+{
+    char *end;
+    *number = strtoull(arg, &end, 0);
+    return (*arg == '\0' || *end != '\0') ? FALSE : TRUE;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file selfplay.h
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief what the self play tools share- the shot strategies, the tally of the shots to win and
+ * the numbers of the command line.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * the simulator (ex2_simulate) and the tournament (ex2_tournament) play complete games with the
+ * same built in strategies and report the shots to win the same way, and they and the board
+ * generator (ex2_genboards) read the same kind of options. a strategy only looks at what a player
+ * can know (the shots and their results), and a ShotTally keeps the sums and the histogram of the
+ * shots of the won games, so the mean, the standard deviation and the percentiles come out of it.
+ */
+
+#ifndef EX2_SELFPLAY_H
+#define EX2_SELFPLAY_H
+
+#include "battleships.h"
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the largest number of shots a game can take.
+ */
+#define MAX_SHOTS (BITBOARD_MAX_SIDE * BITBOARD_MAX_SIDE)
+
+/**
+ * the limit for the threads of a tool.
+ */
+#define MAX_THREADS 256
+
+/**
+ * @brief a shot strategy.
+ * @param game : the game (a strategy only looks at what a player can know)
+ * @param rng : a random generator for the strategy
+ * @param row : will be set to the row of the shot
+ * @param column : will be set to the column of the shot
+ * @return TRUE if a shot was chosen, FALSE if there is no cell left to shoot at
+ */
+typedef int (*ShotStrategy)(const Game *game, Rng *rng, int *row, int *column);
+
+/**
+ * @brief the shots of the won games.
+ * @games the number of games
+ * @shots the sum of the shots of all the games
+ * @shotsSquares the sum of the squares of the shots (for the standard deviation)
+ * @histogram the number of games by the number of shots they took
+ */
+typedef struct ShotTally
+{
+    uint64_t games;
+    uint64_t shots;
+    uint64_t shotsSquares;
+    uint64_t histogram[MAX_SHOTS + 1];
+} ShotTally;
+
+
+// ------------------------------ function declarations -----------------------------
+
+/**
+ * this function is the strategy of the computer player (see ai.h).
+ * @param game : the game
+ * @param rng : not used
+ * @param row : will be set to the row of the shot
+ * @param column : will be set to the column of the shot
+ * @return TRUE if a shot was chosen, FALSE if there is no cell left to shoot at
+ */
+int aiStrategy(const Game *game, Rng *rng, int *row, int *column);
+
+/**
+ * this function shoots at a random cell that was not shot yet.
+ * @param game : the game
+ * @param rng : the random generator
+ * @param row : will be set to the row of the shot
+ * @param column : will be set to the column of the shot
+ * @return TRUE if a shot was chosen, FALSE if there is no cell left to shoot at
+ */
+int randomStrategy(const Game *game, Rng *rng, int *row, int *column);
+
+/**
+ * this function shoots at the first cell that was not shot yet, row by row.
+ * @param game : the game
+ * @param rng : not used
+ * @param row : will be set to the row of the shot
+ * @param column : will be set to the column of the shot
+ * @return TRUE if a shot was chosen, FALSE if there is no cell left to shoot at
+ */
+int sweepStrategy(const Game *game, Rng *rng, int *row, int *column);
+
+/**
+ * this function adds a won game to a tally.
+ * @param tally : the tally
+ * @param shots : the number of shots the game took (up to MAX_SHOTS)
+ */
+void tallyShots(ShotTally *tally, uint64_t shots);
+
+/**
+ * this function adds a tally to another one.
+ * @param total : the tally to add to
+ * @param tally : the tally to add
+ */
+void addShotTally(ShotTally *total, const ShotTally *tally);
+
+/**
+ * this function gives the mean and the standard deviation of the shots of a tally.
+ * @param tally : the tally (with at least one game)
+ * @param mean : will be set to the mean
+ * @param deviation : will be set to the standard deviation
+ */
+void shotsMeanDeviation(const ShotTally *tally, double *mean, double *deviation);
+
+/**
+ * this function finds the smallest number of shots that at least a part of the games of a tally
+ * took.
+ * @param tally : the tally
+ * @param part : the part of the games (between 0 and 1)
+ * @return the number of shots
+ */
+int shotsPercentile(const ShotTally *tally, double part);
+
+/**
+ * this function reads a number from the command line (with the prefixes of C, like 0x for hex).
+ * @param arg : the argument
+ * @param number : will be set to the number
+ * @return TRUE for a number, FALSE otherwise
+ */
+int parseCount(const char *arg, uint64_t *number);
+
+#endif //EX2_SELFPLAY_H
@@ -0,0 +1,389 @@
+// ------------------------------ includes ------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include "snapshot.h"
+#include "pool.h"
+
+/**
+ * @file snapshot.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief this is the implementation file for the game snapshot.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * this is the implementation file for saving and resuming a game.
+ * Input  : a snapshot file
+ * Process: implementation for the functions in snapshot.h
+ * Output : a snapshot file
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the suffix of the temporary file a snapshot is written to before it is renamed over its path.
+ */
+const char SNAPSHOT_TEMP_SUFFIX[] = ".tmp";
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function gives the size of the snapshot of a game.
+ * @param game : the game
+ * @return the number of bytes of the snapshot
+ */
+size_t snapshotBytes(const Game *game)
+{
+    return sizeof(SnapshotHeader) + boardCellBytes(game->gameBoard.size) +
+           shipRegistryBytes(game->ships.numOfShips);
+}
+
+/**
+ * this function fills the header of the snapshot of a game.
+ * @param header : the header
+ * @param game : the game
+ */
+void fillSnapshotHeader(SnapshotHeader *header, const Game *game)
+{
+    memset(header, 0, sizeof(SnapshotHeader));
+    header->magic = SNAPSHOT_MAGIC;
+    header->version = SNAPSHOT_VERSION;
+    header->headerBytes = (uint16_t) sizeof(SnapshotHeader);
+    header->totalBytes = (uint32_t) snapshotBytes(game);
+    header->size = game->gameBoard.size;
+    header->numOfShips = game->ships.numOfShips;
+    header->numOfSunk = game->ships.numOfSunk;
+    header->numOfMoves = game->numOfMoves;
+    header->status = game->status;
+    memcpy(header->rng, game->rng.state, sizeof(header->rng));
+    header->occupied = game->gameBoard.occupied;
+    header->hits = game->gameBoard.hits;
+    header->misses = game->gameBoard.misses;
+}
+
+/**
+ * this function writes the snapshot of a game to memory.
+ * @param game : the game
+ * @param out : the buffer (at least snapshotBytes(game) bytes)
+ */
+void encodeSnapshot(const Game *game, unsigned char *out)
+{
+    SnapshotHeader *header = (SnapshotHeader *) out;
+    fillSnapshotHeader(header, game);
+    memcpy(out + sizeof(SnapshotHeader), game->gameBoard.board,
+           header->totalBytes - sizeof(SnapshotHeader));
+}
+
+/**
+ * this function saves a snapshot of a game to a file, with a single writev.
+ * @param game : the game
+ * @param fd : the file, from its current offset
+ * @return TRUE if the whole snapshot was written, FALSE otherwise
+ */
+int saveSnapshot(const Game *game, const int fd)
+{
+    SnapshotHeader header;
+    fillSnapshotHeader(&header, game);
+
+    struct iovec parts[2];
+    parts[0].iov_base = &header;
+    parts[0].iov_len = sizeof(SnapshotHeader);
+    parts[1].iov_base = game->gameBoard.board; // the cells and the registry are one block
+    parts[1].iov_len = header.totalBytes - sizeof(SnapshotHeader);
+    if (writev(fd, parts, 2) != (ssize_t) header.totalBytes)
+    {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * this function checks that a ship of the registry of a snapshot is on the board, that its cells
+ * hold its index and that its hits are the hit cells among them.
+ * @param ships : the registry
+ * @param shipIndex : the index of the ship
+ * @param cells : the cells of the board
+ * @param size : the size of the board
+ * @return TRUE for a valid ship, FALSE otherwise
+ */
+int isValidSnapshotShip(const ShipRegistry *ships, const int shipIndex, const Cell *cells,
+                        const int size)
+{
+    int length = ships->length[shipIndex];
+    int maxLength = (size < MAX_SHIP_LENGTH) ? size : MAX_SHIP_LENGTH;
+    if (length < 1 || length > maxLength || ships->orientation[shipIndex] >= NUM_OF_ORIENTATIONS ||
+        (ships->isSunk[shipIndex] != TRUE && ships->isSunk[shipIndex] != FALSE))
+    {
+        return FALSE;
+    }
+    Direction direction = directions[ships->orientation[shipIndex]];
+    int row = ships->row[shipIndex], col = ships->column[shipIndex];
+    if (isIndexInBoard(row, col, size) == FALSE ||
+        isIndexInBoard(row + (length - 1) * direction.addToRow,
+                       col + (length - 1) * direction.addToColumn, size) == FALSE)
+    {
+        return FALSE;
+    }
+    uint32_t hitMask = 0;
+    int i;
+    for (i = 0 ; i < length ; ++i)
+    {
+        Cell cell = cells[(row + i * direction.addToRow) * size + col + i * direction.addToColumn];
+        if (CELL_SHIP(cell) != shipIndex)
+        {
+            return FALSE;
+        }
+        hitMask |= (CELL_STATUS(cell) == STATUS_HIT) ? (uint32_t) 1 << i : 0;
+    }
+    uint32_t allCells = (uint32_t) (((uint64_t) 1 << length) - 1);
+    int isSunk = (hitMask == allCells) ? TRUE : FALSE;
+    return (ships->hitMask[shipIndex] == hitMask && ships->isSunk[shipIndex] == isSunk) ? TRUE :
+           FALSE;
+}
+
+/**
+ * this function checks the board block of a snapshot against its header: every cell holds a known
+ * status and a ship of the fleet, the shot planes are exactly the cells with those statuses, and
+ * every ship of the registry is on the board and covers exactly the cells with its index. a
+ * snapshot that passes can't make the game read or write out of its board.
+ * @param header : the header (its size and its number of ships are already checked)
+ * @return TRUE for a valid board, FALSE otherwise
+ */
+int isValidSnapshotBoard(const SnapshotHeader *header)
+{
+    const Cell *cells = (const Cell *) (header + 1);
+    int numOfCells = header->size * header->size;
+    BitBoard occupied, hits, misses;
+    bitBoardClear(&occupied);
+    bitBoardClear(&hits);
+    bitBoardClear(&misses);
+    int i, numOfShipCells = 0;
+    for (i = 0 ; i < numOfCells ; ++i)
+    {
+        int ship = CELL_SHIP(cells[i]);
+        int status = CELL_STATUS(cells[i]);
+        if (ship >= header->numOfShips || (status != STATUS_UNREACHED && status != STATUS_MISS &&
+                                           status != STATUS_HIT) ||
+            (status == STATUS_HIT && ship == NO_SHIP) || (status == STATUS_MISS && ship != NO_SHIP))
+        {
+            return FALSE;
+        }
+        if (ship != NO_SHIP)
+        {
+            bitBoardSet(&occupied, i);
+            numOfShipCells++;
+        }
+        if (status == STATUS_HIT)
+        {
+            bitBoardSet(&hits, i);
+        }
+        else if (status == STATUS_MISS)
+        {
+            bitBoardSet(&misses, i);
+        }
+    }
+    if (memcmp(&occupied, &header->occupied, sizeof(BitBoard)) != 0 ||
+        memcmp(&hits, &header->hits, sizeof(BitBoard)) != 0 ||
+        memcmp(&misses, &header->misses, sizeof(BitBoard)) != 0)
+    {
+        return FALSE;
+    }
+    ShipRegistry ships;
+    mapShipRegistry(&ships, (char *) cells + boardCellBytes(header->size), header->numOfShips);
+    int numOfSunk = 0;
+    for (i = 0 ; i < header->numOfShips ; ++i)
+    {
+        if (isValidSnapshotShip(&ships, i, cells, header->size) == FALSE)
+        {
+            return FALSE;
+        }
+        numOfShipCells -= ships.length[i];
+        numOfSunk += (ships.isSunk[i] == TRUE) ? 1 : 0;
+    }
+    int isWon = (numOfSunk == header->numOfShips) ? WIN_GAME : TRUE;
+    return (numOfShipCells == 0 && numOfSunk == header->numOfSunk && isWon == header->status) ?
+           TRUE : FALSE;
+}
+
+/**
+ * this function checks the header of a snapshot against the length of its file, and then its
+ * board block (see isValidSnapshotBoard).
+ * @param header : the header
+ * @param length : the length of the file
+ * @return TRUE for a valid snapshot, FALSE otherwise
+ */
+int isValidSnapshot(const SnapshotHeader *header, const size_t length)
+{
+    if (header->magic != SNAPSHOT_MAGIC || header->version != SNAPSHOT_VERSION ||
+        header->headerBytes != sizeof(SnapshotHeader) || header->totalBytes != length)
+    {
+        return FALSE;
+    }
+    if (isValidSize(header->size) == FALSE || header->numOfShips < 1 ||
+        header->numOfShips > MAX_FLEET_SHIPS || header->numOfSunk < 0 ||
+        header->numOfSunk > header->numOfShips || header->numOfMoves < 0 ||
+        (header->status != TRUE && header->status != WIN_GAME))
+    {
+        return FALSE;
+    }
+    size_t expected = sizeof(SnapshotHeader) + boardCellBytes(header->size) +
+                      shipRegistryBytes(header->numOfShips);
+    if (expected != length)
+    {
+        return FALSE;
+    }
+    return isValidSnapshotBoard(header);
+}
+
+/**
+ * this function maps a snapshot file to memory and checks its header and size.
+ * @param view : will be set to the mapped snapshot (free it with unmapSnapshot)
+ * @param fd : the file (it can be closed once it is mapped)
+ * @return TRUE for a valid snapshot, FALSE if the file can't be mapped or is not a valid snapshot
+ * (nothing is left mapped in that case)
+ */
+int mapSnapshot(SnapshotView *view, const int fd)
+{
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size < (off_t) sizeof(SnapshotHeader))
+    {
+        return FALSE;
+    }
+    size_t length = (size_t) status.st_size;
+    void *mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED)
+    {
+        return FALSE;
+    }
+    if (isValidSnapshot((const SnapshotHeader *) mapped, length) == FALSE)
+    {
+        munmap(mapped, length);
+        return FALSE;
+    }
+    view->header = (const SnapshotHeader *) mapped;
+    view->length = length;
+    return TRUE;
+}
+
+/**
+ * this function unmaps a snapshot.
+ * @param view : the snapshot
+ */
+void unmapSnapshot(SnapshotView *view)
+{
+    munmap((void *) view->header, view->length);
+    view->header = NULL;
+    view->length = 0;
+}
+
+/**
+ * this function resumes a game from a valid snapshot. the board block is copied as it is, so the
+ * game goes on exactly where it was saved (with the same rng). (takes a block from the board
+ * pool! free the game with freeGame)
+ * @param game : the game to resume
+ * @param header : the snapshot (checked by mapSnapshot)
+ * @return TRUE on success, FALSE if out of memory
+ */
+int resumeGame(Game *game, const SnapshotHeader *header)
+{
+    size_t cellBytes = boardCellBytes(header->size);
+    size_t blockBytes = header->totalBytes - sizeof(SnapshotHeader);
+    GameBoard *gameBoard = &game->gameBoard;
+    gameBoard->board = (Cell *) acquireBoardBlock(blockBytes);
+    if (gameBoard->board == NULL)
+    {
+        return FALSE;
+    }
+    initShipRegistry(&game->ships, (char *) gameBoard->board + cellBytes, header->numOfShips);
+    memcpy(gameBoard->board, header + 1, blockBytes); // over the registry too, with its hits
+    game->ships.numOfSunk = header->numOfSunk;
+    gameBoard->size = header->size;
+    gameBoard->occupied = header->occupied;
+    gameBoard->hits = header->hits;
+    gameBoard->misses = header->misses;
+    memcpy(game->rng.state, header->rng, sizeof(header->rng));
+    game->numOfMoves = header->numOfMoves;
+    game->status = header->status;
+    return TRUE;
+}
+
+/**
+ * this function resumes a game from a snapshot file- maps it, resumes the game and unmaps it.
+ * @param game : the game to resume (free it with freeGame)
+ * @param fd : the snapshot file
+ * @return TRUE on success, INVALID_SNAPSHOT if the file is not a valid snapshot, FALSE if out
+ * of memory
+ */
+int loadSnapshot(Game *game, const int fd)
+{
+    SnapshotView view;
+    if (mapSnapshot(&view, fd) == FALSE)
+    {
+        return INVALID_SNAPSHOT;
+    }
+    int resumeFlag = resumeGame(game, view.header);
+    unmapSnapshot(&view);
+    return resumeFlag;
+}
+
+/**
+ * this function saves a snapshot of a game to a path. the snapshot is written to a temporary file
+ * next to it and renamed over the path, so the path always holds a whole snapshot.
+ * @param game : the game
+ * @param path : the path of the snapshot
+ * @return TRUE if the snapshot was saved, FALSE otherwise (errno tells why)
+ */
+int saveSnapshotFile(const Game *game, const char *path)
+{
+    char tempPath[PATH_MAX];
+    if (snprintf(tempPath, sizeof(tempPath), "%s%s", path, SNAPSHOT_TEMP_SUFFIX) >=
+        (int) sizeof(tempPath))
+    {
+        return FALSE;
+    }
+    int fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return FALSE;
+    }
+    int saveFlag = saveSnapshot(game, fd);
+    if (close(fd) != 0 || saveFlag == FALSE || rename(tempPath, path) != 0)
+    {
+        unlink(tempPath);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * this function resumes a game from the snapshot in a path.
+ * @param game : the game to resume (free it with freeGame)
+ * @param path : the path of the snapshot
+ * @return TRUE on success, INVALID_SNAPSHOT if the file can't be opened or is not a valid
+ * snapshot, FALSE if out of memory
+ */
+int loadSnapshotFile(Game *game, const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return INVALID_SNAPSHOT;
+    }
+    int loadFlag = loadSnapshot(game, fd);
+    close(fd);
+    return loadFlag;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file snapshot.h
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the game snapshot- a binary image of a game that can be saved and resumed later.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * a snapshot is a fixed layout: a SnapshotHeader (the size, the counters, the rng state and the
+ * shot planes) and right after it the block of the board exactly like it is in memory (the
+ * cells, rounded up to 8 bytes, and then the arrays of the ship registry). so a game is saved
+ * with a single writev from where it already is, and it is resumed by mapping the file and
+ * copying the block back, with no parsing. the numbers are in the byte order of the machine, so
+ * a snapshot is only resumed on the kind of machine that saved it.
+ */
+
+#ifndef EX2_SNAPSHOT_H
+#define EX2_SNAPSHOT_H
+
+#include <stddef.h>
+#include "battleships.h"
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the first bytes of every snapshot ("BSSN" in the file) and the version of the layout. a change
+ * in the layout of the header or of the board block needs a new version.
+ */
+#define SNAPSHOT_MAGIC 0x4E535342u
+#define SNAPSHOT_VERSION 1
+
+/**
+ * a flag for a file that is not a valid snapshot.
+ */
+#define INVALID_SNAPSHOT 6
+
+/**
+ * @brief the header of a snapshot. all its fields have fixed sizes and it is a multiple of 8
+ * bytes, so the board block right after it is aligned.
+ * @magic SNAPSHOT_MAGIC
+ * @version SNAPSHOT_VERSION
+ * @headerBytes the size of the header
+ * @totalBytes the size of the whole snapshot (the header and the board block)
+ * @size the size of the board
+ * @numOfShips the number of ships in the registry
+ * @numOfSunk the number of sunk ships
+ * @numOfMoves the number of moves
+ * @status the status of the game
+ * @rng the state of the rng of the game
+ * @occupied the cells with ships
+ * @hits the cells that were hit
+ * @misses the cells that were missed
+ */
+typedef struct SnapshotHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerBytes;
+    uint32_t totalBytes;
+    int32_t size;
+    int32_t numOfShips;
+    int32_t numOfSunk;
+    int32_t numOfMoves;
+    int32_t status;
+    uint64_t rng[4];
+    BitBoard occupied;
+    BitBoard hits;
+    BitBoard misses;
+} SnapshotHeader;
+
+/**
+ * @brief a snapshot file mapped to memory.
+ * @header the header of the snapshot, the board block comes right after it
+ * @length the length of the mapping
+ */
+typedef struct SnapshotView
+{
+    const SnapshotHeader *header;
+    size_t length;
+} SnapshotView;
+
+
+// ------------------------------ function declarations -----------------------------
+
+/**
+ * this function gives the size of the snapshot of a game.
+ * @param game : the game
+ * @return the number of bytes of the snapshot
+ */
+size_t snapshotBytes(const Game *game);
+
+/**
+ * this function writes the snapshot of a game to memory.
+ * @param game : the game
+ * @param out : the buffer (at least snapshotBytes(game) bytes, aligned to 8)
+ */
+void encodeSnapshot(const Game *game, unsigned char *out);
+
+/**
+ * this function saves a snapshot of a game to a file, with a single writev.
+ * @param game : the game
+ * @param fd : the file, from its current offset
+ * @return TRUE if the whole snapshot was written, FALSE otherwise
+ */
+int saveSnapshot(const Game *game, int fd);
+
+/**
+ * this function maps a snapshot file to memory and checks its header, its size and its board
+ * block (the cells, the shot planes and the ship registry agree with each other).
+ * @param view : will be set to the mapped snapshot (free it with unmapSnapshot)
+ * @param fd : the file (it can be closed once it is mapped)
+ * @return TRUE for a valid snapshot, FALSE if the file can't be mapped or is not a valid snapshot
+ * (nothing is left mapped in that case)
+ */
+int mapSnapshot(SnapshotView *view, int fd);
+
+/**
+ * this function unmaps a snapshot.
+ * @param view : the snapshot
+ */
+void unmapSnapshot(SnapshotView *view);
+
+/**
+ * this function resumes a game from a valid snapshot. the board block is copied as it is, so the
+ * game goes on exactly where it was saved (with the same rng). (takes a block from the board
+ * pool of the thread! free the game with freeGame, it gives the block back to the pool)
+ * @param game : the game to resume
+ * @param header : the snapshot (checked by mapSnapshot)
+ * @return TRUE on success, FALSE if out of memory
+ */
+int resumeGame(Game *game, const SnapshotHeader *header);
+
+/**
+ * this function resumes a game from a snapshot file- maps it, resumes the game and unmaps it.
+ * @param game : the game to resume (free it with freeGame)
+ * @param fd : the snapshot file
+ * @return TRUE on success, INVALID_SNAPSHOT if the file is not a valid snapshot, FALSE if out
+ * of memory
+ */
+int loadSnapshot(Game *game, int fd);
+
+/**
+ * this function saves a snapshot of a game to a path. the snapshot is written to a temporary file
+ * next to it and renamed over the path, so the path always holds a whole snapshot.
+ * @param game : the game
+ * @param path : the path of the snapshot
+ * @return TRUE if the snapshot was saved, FALSE otherwise (errno tells why)
+ */
+int saveSnapshotFile(const Game *game, const char *path);
+
+/**
+ * this function resumes a game from the snapshot in a path.
+ * @param game : the game to resume (free it with freeGame)
+ * @param path : the path of the snapshot
+ * @return TRUE on success, INVALID_SNAPSHOT if the file can't be opened or is not a valid
+ * snapshot, FALSE if out of memory
+ */
+int loadSnapshotFile(Game *game, const char *path);
+
+#endif //EX2_SNAPSHOT_H
@@ -0,0 +1,537 @@
+// ------------------------------ includes ------------------------------
+
+#include <stdlib.h>
+#include <string.h>
+#include "sparse.h"
+#include "render.h"
+#include "stats.h"
+
+/**
+ * @file sparse.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief this is the implementation file for the sparse board.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * this is the implementation file for the sparse board and its game.
+ * Input  : none
+ * Process: implementation for the functions in sparse.h
+ * Output : none
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the number of slots of a new index and a new set of misses (as log2). they double once they are
+ * half full.
+ */
+const int SPARSE_INITIAL_INDEX_BITS = 10;
+
+/**
+ * the number of random places we try for a ship before we give up on the fleet.
+ */
+const int SPARSE_PLACEMENT_ATTEMPTS = 1000;
+
+/**
+ * the multiplier of the hash of the tile keys (the 64 bit golden ratio).
+ */
+const uint64_t SPARSE_HASH_MULTIPLIER = 0x9E3779B97F4A7C15u;
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function finds the slot of a tile in the index: the slot that holds it, or the empty slot
+ * where it should be added.
+ * @param board : the board
+ * @param key : the key of the tile
+ * @return the slot
+ */
+SparseTile **findSlot(const SparseBoard *board, const uint64_t key)
+{
+    size_t mask = ((size_t) 1 << board->indexBits) - 1;
+    size_t slot = (size_t) ((key * SPARSE_HASH_MULTIPLIER) >> (64 - board->indexBits));
+    while (board->index[slot] != NULL && board->index[slot]->key != key)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return &board->index[slot];
+}
+
+/**
+ * this function doubles the index of a board.
+ * @param board : the board
+ * @return TRUE on success, FALSE if out of memory (the board is not changed)
+ */
+int growIndex(SparseBoard *board)
+{
+    size_t oldSlots = (size_t) 1 << board->indexBits;
+    SparseTile **oldIndex = board->index;
+    SparseTile **newIndex = (SparseTile **) calloc(oldSlots * 2, sizeof(SparseTile *));
+    if (newIndex == NULL)
+    {
+        return FALSE;
+    }
+    board->index = newIndex;
+    board->indexBits++;
+    size_t i;
+    for (i = 0 ; i < oldSlots ; ++i)
+    {
+        if (oldIndex[i] != NULL)
+        {
+            *findSlot(board, oldIndex[i]->key) = oldIndex[i];
+        }
+    }
+    free(oldIndex);
+    return TRUE;
+}
+
+/**
+ * this function gives the key of the tile of a cell.
+ * @param row : the row of the cell
+ * @param col : the column of the cell
+ * @return the key
+ */
+uint64_t tileKey(const int row, const int col)
+{
+    return ((uint64_t) (row >> SPARSE_TILE_BITS) << 32) | (uint64_t) (col >> SPARSE_TILE_BITS);
+}
+
+/**
+ * this function gives the place of a cell in its tile.
+ * @param row : the row of the cell
+ * @param col : the column of the cell
+ * @return the index of the cell in the tile
+ */
+int tileOffset(const int row, const int col)
+{
+    return ((row & (SPARSE_TILE_SIDE - 1)) << SPARSE_TILE_BITS) | (col & (SPARSE_TILE_SIDE - 1));
+}
+
+/**
+ * this function gives the key of a cell in the set of the misses.
+ * @param row : the row of the cell
+ * @param col : the column of the cell
+ * @return the key (never 0)
+ */
+uint64_t missKey(const int row, const int col)
+{
+    return (((uint64_t) row << 32) | (uint64_t) col) + 1;
+}
+
+/**
+ * this function finds the slot of a cell in the set of the misses: the slot that holds it, or
+ * the empty slot where it should be added.
+ * @param board : the board
+ * @param key : the key of the cell
+ * @return the slot
+ */
+uint64_t *findMissSlot(const SparseBoard *board, const uint64_t key)
+{
+    size_t mask = ((size_t) 1 << board->missBits) - 1;
+    size_t slot = (size_t) ((key * SPARSE_HASH_MULTIPLIER) >> (64 - board->missBits));
+    while (board->misses[slot] != 0 && board->misses[slot] != key)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return &board->misses[slot];
+}
+
+/**
+ * this function doubles the set of the misses of a board.
+ * @param board : the board
+ * @return TRUE on success, FALSE if out of memory (the board is not changed)
+ */
+int growMisses(SparseBoard *board)
+{
+    size_t oldSlots = (size_t) 1 << board->missBits;
+    uint64_t *oldMisses = board->misses;
+    uint64_t *newMisses = (uint64_t *) calloc(oldSlots * 2, sizeof(uint64_t));
+    if (newMisses == NULL)
+    {
+        return FALSE;
+    }
+    board->misses = newMisses;
+    board->missBits++;
+    size_t i;
+    for (i = 0 ; i < oldSlots ; ++i)
+    {
+        if (oldMisses[i] != 0)
+        {
+            *findMissSlot(board, oldMisses[i]) = oldMisses[i];
+        }
+    }
+    free(oldMisses);
+    return TRUE;
+}
+
+/**
+ * this function finds a cell of a sparse board.
+ * @param board : the board
+ * @param row : the row of the cell
+ * @param col : the column of the cell
+ * @return the cell (a cell with no tile is empty, so it is 0 or SPARSE_STATUS_MISS)
+ */
+SparseCell sparseCellAt(const SparseBoard *board, const int row, const int col)
+{
+    SparseTile *tile = *findSlot(board, tileKey(row, col));
+    if (tile != NULL)
+    {
+        return tile->cells[tileOffset(row, col)];
+    }
+    return (*findMissSlot(board, missKey(row, col)) != 0) ? SPARSE_STATUS_MISS : 0;
+}
+
+/**
+ * this function gives the status of a cell of a sparse board as the status of a packed Cell (for
+ * a BoardView).
+ * @param board : the board (a SparseBoard)
+ * @param row : the row of the cell
+ * @param col : the column of the cell
+ * @return STATUS_UNREACHED, STATUS_MISS or STATUS_HIT
+ */
+int sparseStatusAt(const void *board, const int row, const int col)
+{
+    SparseCell cell = sparseCellAt((const SparseBoard *) board, row, col);
+    return (int) (SPARSE_CELL_STATUS(cell) >> SPARSE_SHIP_BITS) << CELL_SHIP_BITS;
+}
+
+/**
+ * this function gives all the shots of a sparse board to a visitor- the shots on the tiles and the
+ * misses out of them (the cost is the number of tiles and misses, not the size of the board).
+ * @param board : the board (a SparseBoard)
+ * @param visit : the visitor
+ * @param context : the context of the visitor
+ */
+void forEachSparseShot(const void *board, const ShotVisitor visit, void *context)
+{
+    const SparseBoard *sparseBoard = (const SparseBoard *) board;
+    size_t slot;
+    int i;
+    for (slot = 0 ; slot < ((size_t) 1 << sparseBoard->indexBits) ; ++slot)
+    {
+        const SparseTile *tile = sparseBoard->index[slot];
+        if (tile == NULL)
+        {
+            continue;
+        }
+        int firstRow = (int) (tile->key >> 32) << SPARSE_TILE_BITS;
+        int firstCol = (int) (tile->key & 0xFFFFFFFFu) << SPARSE_TILE_BITS;
+        for (i = 0 ; i < SPARSE_TILE_SIDE * SPARSE_TILE_SIDE ; ++i)
+        {
+            SparseCell status = SPARSE_CELL_STATUS(tile->cells[i]);
+            if (status != 0)
+            {
+                visit(context, firstRow + (i >> SPARSE_TILE_BITS),
+                      firstCol + (i & (SPARSE_TILE_SIDE - 1)),
+                      (int) (status >> SPARSE_SHIP_BITS) << CELL_SHIP_BITS);
+            }
+        }
+    }
+    for (slot = 0 ; slot < ((size_t) 1 << sparseBoard->missBits) ; ++slot)
+    {
+        uint64_t key = sparseBoard->misses[slot];
+        if (key != 0)
+        { // the key of a cell is its coordinate plus one (see missKey)
+            visit(context, (int) ((key - 1) >> 32), (int) ((key - 1) & 0xFFFFFFFFu), STATUS_MISS);
+        }
+    }
+}
+
+/**
+ * this function sets a BoardView of a sparse board, for the viewport renderer (see render.h).
+ * @param board : the board
+ * @param view : will be set to the view
+ */
+void viewSparseBoard(const SparseBoard *board, BoardView *view)
+{
+    view->board = board;
+    view->size = board->size;
+    view->statusAt = sparseStatusAt;
+    view->forEachShot = forEachSparseShot;
+}
+
+/**
+ * this function finds a cell of a sparse board to place a ship on it. its tile is allocated if it
+ * doesn't exist yet.
+ * @param board : the board
+ * @param row : the row of the cell
+ * @param col : the column of the cell
+ * @return the cell, NULL if out of memory
+ */
+SparseCell *touchCell(SparseBoard *board, const int row, const int col)
+{
+    uint64_t key = tileKey(row, col);
+    SparseTile **slot = findSlot(board, key);
+    if (*slot == NULL)
+    {
+        if ((board->numOfTiles + 1) * 2 > ((size_t) 1 << board->indexBits))
+        { // keep the index at most half full
+            if (growIndex(board) == FALSE)
+            {
+                return NULL;
+            }
+            slot = findSlot(board, key);
+        }
+        *slot = (SparseTile *) calloc(1, sizeof(SparseTile));
+        if (*slot == NULL)
+        {
+            return NULL;
+        }
+        (*slot)->key = key;
+        board->numOfTiles++;
+    }
+    return &(*slot)->cells[tileOffset(row, col)];
+}
+
+/**
+ * this function frees the tiles, the index and the set of the misses of a board.
+ * @param board : the board
+ */
+void freeSparseBoard(SparseBoard *board)
+{
+    size_t i;
+    for (i = 0 ; board->index != NULL && i < ((size_t) 1 << board->indexBits) ; ++i)
+    {
+        free(board->index[i]);
+    }
+    free(board->index);
+    free(board->misses);
+    board->index = NULL;
+    board->misses = NULL;
+    board->numOfTiles = 0;
+    board->numOfMisses = 0;
+}
+
+/**
+ * this function places a single ship on a random free place of the board.
+ * @param shipIndex : the index of the ship in the fleet
+ * @param game : the game
+ * @return TRUE if the ship was placed, NO_PLACEMENT if no free place was found and FALSE if out
+ * of memory
+ */
+int placeSparseShip(const int shipIndex, SparseGame *game)
+{
+    int length = game->ships.length[shipIndex];
+    int attempt, i;
+    for (attempt = 0 ; attempt < SPARSE_PLACEMENT_ATTEMPTS ; ++attempt)
+    {
+        int orientation = (int) rngBounded(&game->rng, NUM_OF_ORIENTATIONS);
+        Direction direction = directions[orientation];
+        int row = (int) rngBounded(&game->rng, (uint32_t) (game->board.size -
+                                                           (length - 1) * direction.addToRow));
+        int col = (int) rngBounded(&game->rng, (uint32_t) (game->board.size -
+                                                           (length - 1) * direction.addToColumn));
+        for (i = 0 ; i < length ; ++i)
+        {
+            if (sparseCellAt(&game->board, row + i * direction.addToRow,
+                             col + i * direction.addToColumn) != 0)
+            {
+                break;
+            }
+        }
+        if (i < length)
+        { // collision
+            STAT_ADD(COUNTER_RETRIES, 1);
+            continue;
+        }
+        registerShip(&game->ships, shipIndex, row, col, orientation);
+        for (i = 0 ; i < length ; ++i)
+        {
+            SparseCell *cell = touchCell(&game->board, row + i * direction.addToRow,
+                                         col + i * direction.addToColumn);
+            if (cell == NULL)
+            {
+                return FALSE;
+            }
+            *cell = (SparseCell) shipIndex + 1;
+        }
+        return TRUE;
+    }
+    return NO_PLACEMENT;
+}
+
+/**
+ * this function starts a new sparse game and places its fleet. (uses malloc! free the game with
+ * freeSparseGame)
+ * @param game : the game to init
+ * @param size : the size of the board (bigger than MAX_SIZE, up to SPARSE_MAX_SIZE)
+ * @param numOfShips : the number of ships (up to SPARSE_MAX_SHIPS)
+ * @param fleet : the fleet of the game, NULL for the standard fleet. the ships of the game are
+ * the ships of the fleet again and again
+ * @param seed : the seed of the game
+ * @return TRUE on success, INVALID_SIZE if the size or the number of ships is not valid,
+ * INVALID_FLEET if the fleet is not valid, NO_PLACEMENT if the fleet can't be placed and FALSE
+ * if out of memory (nothing is left allocated unless it is TRUE)
+ */
+int initSparseGame(SparseGame *game, const int size, const int numOfShips, const Fleet *fleet,
+                   const uint64_t seed)
+{
+    if (size <= MAX_SIZE || size > SPARSE_MAX_SIZE || numOfShips < 1 ||
+        numOfShips > SPARSE_MAX_SHIPS)
+    {
+        return INVALID_SIZE;
+    }
+    if (fleet == NULL)
+    {
+        fleet = &standardFleet;
+    }
+    if (isValidFleet(fleet, size) == FALSE)
+    {
+        return INVALID_FLEET;
+    }
+    memset(game, 0, sizeof(SparseGame));
+    game->board.size = size;
+    game->board.indexBits = SPARSE_INITIAL_INDEX_BITS;
+    game->board.index = (SparseTile **) calloc((size_t) 1 << SPARSE_INITIAL_INDEX_BITS,
+                                               sizeof(SparseTile *));
+    game->board.missBits = SPARSE_INITIAL_INDEX_BITS;
+    game->board.misses = (uint64_t *) calloc((size_t) 1 << SPARSE_INITIAL_INDEX_BITS,
+                                             sizeof(uint64_t));
+    void *shipBlock = malloc(shipRegistryBytes(numOfShips));
+    if (game->board.index == NULL || game->board.misses == NULL || shipBlock == NULL)
+    {
+        free(shipBlock);
+        freeSparseGame(game);
+        return FALSE;
+    }
+    initShipRegistry(&game->ships, shipBlock, numOfShips);
+    game->status = TRUE;
+    rngSeed(&game->rng, seed);
+    STAT_TIMER_START(start);
+    int i;
+    for (i = 0 ; i < numOfShips ; ++i)
+    {
+        game->ships.length[i] = (unsigned char) fleet->ships[i % fleet->numOfShips].length;
+        int placeFlag = placeSparseShip(i, game);
+        if (placeFlag != TRUE)
+        {
+            freeSparseGame(game);
+            return placeFlag;
+        }
+    }
+    STAT_TIMER_STOP(TIMER_PLACEMENT, start);
+    STAT_ADD(COUNTER_FLEETS, 1);
+    return TRUE;
+}
+
+/**
+ * this function makes a move on a cell that has no tile- an empty cell, so it is a miss unless
+ * it is already in the set of the misses.
+ * @param game : the game
+ * @param row : the row of the move
+ * @param col : the column of the move
+ * @return MOVE_MISS, MOVE_REPEATED or MOVE_INVALID if out of memory
+ */
+MoveResult missOutOfTiles(SparseGame *game, const int row, const int col)
+{
+    SparseBoard *board = &game->board;
+    uint64_t key = missKey(row, col);
+    uint64_t *slot = findMissSlot(board, key);
+    if (*slot != 0)
+    {
+        return MOVE_REPEATED;
+    }
+    if ((board->numOfMisses + 1) * 2 > ((size_t) 1 << board->missBits))
+    { // keep the set at most half full
+        if (growMisses(board) == FALSE)
+        {
+            return MOVE_INVALID;
+        }
+        slot = findMissSlot(board, key);
+    }
+    *slot = key;
+    board->numOfMisses++;
+    game->numOfMoves++;
+    return MOVE_MISS;
+}
+
+/**
+ * this function makes a single move in a sparse game.
+ * @param game : the game
+ * @param row : the row of the move
+ * @param col : the column of the move
+ * @return the result of the move, MOVE_INVALID if the cell is out of the board, the game was
+ * already won or out of memory
+ */
+MoveResult stepSparseGame(SparseGame *game, const int row, const int col)
+{
+    if (game->status == WIN_GAME || isIndexInBoard(row, col, game->board.size) == FALSE)
+    {
+        return MOVE_INVALID;
+    }
+    SparseTile *tile = *findSlot(&game->board, tileKey(row, col));
+    if (tile == NULL)
+    {
+        return missOutOfTiles(game, row, col);
+    }
+    SparseCell *cell = &tile->cells[tileOffset(row, col)];
+    if (SPARSE_CELL_STATUS(*cell) != 0)
+    { // the move was already made
+        return MOVE_REPEATED;
+    }
+    game->numOfMoves++;
+    int shipIndex = SPARSE_CELL_SHIP(*cell);
+    if (shipIndex == NO_SHIP)
+    {
+        *cell |= SPARSE_STATUS_MISS;
+        return MOVE_MISS;
+    }
+    *cell |= SPARSE_STATUS_HIT;
+    game->numOfHits++;
+    if (hitShip(&game->ships, shipIndex, row, col) == FALSE)
+    {
+        return MOVE_HIT;
+    }
+    if (remainingShips(&game->ships) > 0)
+    {
+        return MOVE_SUNK;
+    }
+    game->status = WIN_GAME;
+    return MOVE_WIN;
+}
+
+/**
+ * this function gives the summary of a sparse game.
+ * @param game : the game
+ * @return the summary
+ */
+GameResult sparseGameResult(const SparseGame *game)
+{
+    GameResult result;
+    result.status = game->status;
+    result.numOfMoves = game->numOfMoves;
+    result.numOfHits = game->numOfHits;
+    result.sunkShips = game->ships.numOfSunk;
+    return result;
+}
+
+/**
+ * this function gives the memory a sparse game uses.
+ * @param game : the game
+ * @return the number of bytes of the tiles, the index, the set of the misses and the ship registry
+ */
+size_t sparseGameMemory(const SparseGame *game)
+{
+    return game->board.numOfTiles * sizeof(SparseTile) +
+           ((size_t) 1 << game->board.indexBits) * sizeof(SparseTile *) +
+           ((size_t) 1 << game->board.missBits) * sizeof(uint64_t) +
+           shipRegistryBytes(game->ships.numOfShips);
+}
+
+/**
+ * this function frees all the memory of a sparse game.
+ * @param game : the game
+ */
+void freeSparseGame(SparseGame *game)
+{
+    freeSparseBoard(&game->board);
+    free(game->ships.row); // the start of the block of the registry
+    game->ships.row = NULL;
+}
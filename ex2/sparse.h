@@ -0,0 +1,185 @@
+/**
+ * @file sparse.h
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the sparse board- a game engine for boards much bigger than MAX_SIZE (up to
+ * SPARSE_MAX_SIZE rows and columns) with any number of ships.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * the board is cut to square tiles of SPARSE_TILE_SIDE * SPARSE_TILE_SIDE cells. a tile is only
+ * allocated the first time a ship is placed on it, and the tiles are found with a hash index
+ * (open addressing) by their coordinate. a shot on a tile is kept in its cell, and a miss out of
+ * all the tiles is kept in a hash set of the missed cells. a cell with no tile that is not in the
+ * set is an empty cell that was not shot yet. so the memory of a game depends on the number of
+ * ships and shots, not on the size of the board, and a move is one or two lookups.
+ * the ships of a sparse game are its fleet again and again (5, 4, 3, 3, 2, 5, ... for the
+ * standard fleet).
+ * a game must only be used by one thread at a time, like a Game.
+ */
+
+#ifndef EX2_SPARSE_H
+#define EX2_SPARSE_H
+
+#include <stddef.h>
+#include "battleships.h"
+
+struct BoardView; // a view of a board for the viewport renderer, see render.h
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the largest number of rows (and columns) of a sparse board, and the largest number of ships.
+ */
+#define SPARSE_MAX_SIZE (1 << 20)
+#define SPARSE_MAX_SHIPS (1 << 24)
+
+/**
+ * the size of a tile. a tile is SPARSE_TILE_SIDE * SPARSE_TILE_SIDE cells.
+ */
+#define SPARSE_TILE_BITS 4
+#define SPARSE_TILE_SIDE (1 << SPARSE_TILE_BITS)
+
+/**
+ * a cell of the sparse board. like the packed Cell, the low SPARSE_SHIP_BITS bits hold the index
+ * of the ship in the cell plus one (0 for an empty cell) and the two high bits hold its status.
+ */
+typedef uint32_t SparseCell;
+
+/**
+ * the layout of the sparse cell.
+ */
+#define SPARSE_SHIP_BITS 30
+#define SPARSE_SHIP_MASK ((1u << SPARSE_SHIP_BITS) - 1)
+#define SPARSE_STATUS_MASK (3u << SPARSE_SHIP_BITS)
+#define SPARSE_STATUS_MISS (1u << SPARSE_SHIP_BITS)
+#define SPARSE_STATUS_HIT (2u << SPARSE_SHIP_BITS)
+
+/**
+ * @brief access macros for the sparse cell, like CELL_SHIP and CELL_STATUS.
+ */
+#define SPARSE_CELL_SHIP(cell) ((int) ((cell) & SPARSE_SHIP_MASK) - 1)
+#define SPARSE_CELL_STATUS(cell) ((cell) & SPARSE_STATUS_MASK)
+
+/**
+ * @brief a tile of the sparse board.
+ * @key the coordinate of the tile (its row in the high 32 bits, its column in the low ones)
+ * @cells the cells of the tile, row by row
+ */
+typedef struct SparseTile
+{
+    uint64_t key;
+    SparseCell cells[SPARSE_TILE_SIDE * SPARSE_TILE_SIDE];
+} SparseTile;
+
+/**
+ * @brief the sparse board.
+ * @size the number of rows (and columns)
+ * @index the hash index of the tiles (NULL for an empty slot)
+ * @indexBits the log2 of the number of slots in the index
+ * @numOfTiles the number of allocated tiles
+ * @misses the hash set of the missed cells that have no tile (the key of a cell plus one, 0 for
+ * an empty slot)
+ * @missBits the log2 of the number of slots in the set
+ * @numOfMisses the number of cells in the set
+ */
+typedef struct SparseBoard
+{
+    int size;
+    SparseTile **index;
+    int indexBits;
+    size_t numOfTiles;
+    uint64_t *misses;
+    int missBits;
+    size_t numOfMisses;
+} SparseBoard;
+
+/**
+ * @brief a game on a sparse board.
+ * @board the board
+ * @ships the placed ships of the game and their hits (its arrays are a block of their own)
+ * @rng the random generator of the game (places the fleet)
+ * @numOfMoves the number of moves (a repeated move doesn't count)
+ * @numOfHits the number of hits
+ * @status TRUE while the game is on, WIN_GAME once all the ships were sunk
+ */
+typedef struct SparseGame
+{
+    SparseBoard board;
+    ShipRegistry ships;
+    Rng rng;
+    int numOfMoves;
+    int numOfHits;
+    int status;
+} SparseGame;
+
+
+// ------------------------------ function declarations -----------------------------
+
+/**
+ * this function starts a new sparse game and places its fleet. (uses malloc! free the game with
+ * freeSparseGame)
+ * @param game : the game to init
+ * @param size : the size of the board (bigger than MAX_SIZE, up to SPARSE_MAX_SIZE)
+ * @param numOfShips : the number of ships (up to SPARSE_MAX_SHIPS)
+ * @param fleet : the fleet of the game, NULL for the standard fleet. the ships of the game are
+ * the ships of the fleet again and again
+ * @param seed : the seed of the game
+ * @return TRUE on success, INVALID_SIZE if the size or the number of ships is not valid,
+ * INVALID_FLEET if the fleet is not valid, NO_PLACEMENT if the fleet can't be placed and FALSE
+ * if out of memory (nothing is left allocated unless it is TRUE)
+ */
+int initSparseGame(SparseGame *game, int size, int numOfShips, const Fleet *fleet,
+                   uint64_t seed);
+
+/**
+ * this function finds a cell of a sparse board.
+ * @param board : the board
+ * @param row : the row of the cell
+ * @param col : the column of the cell
+ * @return the cell (a cell with no tile is empty, so it is 0 or SPARSE_STATUS_MISS)
+ */
+SparseCell sparseCellAt(const SparseBoard *board, int row, int col);
+
+/**
+ * this function sets a BoardView of a sparse board, for the viewport renderer (see render.h).
+ * @param board : the board
+ * @param view : will be set to the view
+ */
+void viewSparseBoard(const SparseBoard *board, struct BoardView *view);
+
+/**
+ * this function makes a single move in a sparse game.
+ * @param game : the game
+ * @param row : the row of the move
+ * @param col : the column of the move
+ * @return the result of the move, MOVE_INVALID if the cell is out of the board, the game was
+ * already won or out of memory
+ */
+MoveResult stepSparseGame(SparseGame *game, int row, int col);
+
+/**
+ * this function gives the summary of a sparse game.
+ * @param game : the game
+ * @return the summary
+ */
+GameResult sparseGameResult(const SparseGame *game);
+
+/**
+ * this function gives the memory a sparse game uses.
+ * @param game : the game
+ * @return the number of bytes of the tiles, the index, the set of the misses and the ship registry
+ */
+size_t sparseGameMemory(const SparseGame *game);
+
+/**
+ * this function frees all the memory of a sparse game.
+ * @param game : the game
+ */
+void freeSparseGame(SparseGame *game);
+
+#endif //EX2_SPARSE_H
@@ -0,0 +1,298 @@
+// ------------------------------ includes ------------------------------
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "battleships.h"
+#include "stats.h"
+
+/**
+ * @file stats.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief this is the implementation file for the hot path instrumentation.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * this is the implementation file for the ThreadStats of the threads and their report.
+ * Input  : the counters and the latencies of the threads
+ * Process: implementation for the functions in stats.h
+ * Output : the report
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * @brief the names of the counters in the report, indexed by the StatCounter.
+ */
+const char *COUNTER_NAMES[] = {"fleets", "fleet_attempts", "dead_ends", "candidates", "retries",
+                               "placer_steps", "moves", "renders", "parses"};
+
+/**
+ * @brief the names of the histograms in the report, indexed by the StatTimer.
+ */
+const char *TIMER_NAMES[] = {"placement", "move", "render", "parse"};
+
+/**
+ * @var string massage
+ * @brief the report of a program that was built with no instrumentation
+ */
+const char *STATS_DISABLED_MSG = "the stats are not built in (build with EX2_STATS)\n";
+
+/**
+ * the ThreadStats of all the threads (new ones are pushed to the head with a compare and swap),
+ * and the ticks and the time when the first one was made.
+ */
+ThreadStats *allStats = NULL;
+uint64_t epochTicks = 0;
+uint64_t epochNanos = 0;
+
+/**
+ * the format of the report at exit.
+ */
+StatsFormat exitFormat = STATS_TEXT;
+
+#ifdef EX2_STATS
+__thread ThreadStats *threadStats = NULL;
+#endif
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function gives the time of a monotonic clock.
+ * @return the time in nano seconds
+ */
+uint64_t statsNanos(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+/**
+ * this function makes the ThreadStats of the calling thread.
+ * @return the ThreadStats (the counters stay at zero if it is out of memory)
+ */
+ThreadStats *newThreadStats(void)
+{
+#ifdef EX2_STATS
+    static ThreadStats lostStats; // the updates of a thread with no memory go here
+    ThreadStats *stats = (ThreadStats *) calloc(1, sizeof(ThreadStats));
+    if (stats == NULL)
+    {
+        return &lostStats;
+    }
+    uint64_t noTicks = 0;
+    uint64_t ticks = readTicks();
+    if (__atomic_compare_exchange_n(&epochTicks, &noTicks, ticks, 0, __ATOMIC_RELAXED,
+                                    __ATOMIC_RELAXED))
+    { // the first thread
+        __atomic_store_n(&epochNanos, statsNanos(), __ATOMIC_RELEASE);
+    }
+    stats->next = __atomic_load_n(&allStats, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&allStats, &stats->next, stats, 1, __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED))
+    { // another thread pushed its ThreadStats first, stats->next is the new head
+    }
+    threadStats = stats;
+    return stats;
+#else
+    return NULL;
+#endif
+}
+
+/**
+ * this function adds a latency to a histogram.
+ * @param histogram : the histogram
+ * @param ticks : the latency
+ */
+void addLatency(Histogram *histogram, const uint64_t ticks)
+{
+    histogram->count++;
+    histogram->sum += ticks;
+    if (ticks > histogram->max)
+    {
+        histogram->max = ticks;
+    }
+    histogram->buckets[63 - __builtin_clzll(ticks | 1)]++;
+}
+
+/**
+ * this function gives an upper bound of a percentile of a histogram.
+ * @param histogram : the histogram
+ * @param fraction : the percentile (0 - 1)
+ * @return the largest latency of the bucket of the percentile (or the largest latency)
+ */
+uint64_t histogramPercentile(const Histogram *histogram, const double fraction)
+{
+    uint64_t rank = (uint64_t) (fraction * (double) histogram->count);
+    uint64_t seen = 0;
+    int i;
+    for (i = 0 ; i < STAT_BUCKETS ; ++i)
+    {
+        seen += histogram->buckets[i];
+        if (seen > rank)
+        {
+            uint64_t bound = (i == STAT_BUCKETS - 1) ? UINT64_MAX : (2ull << i) - 1;
+            return (bound < histogram->max) ? bound : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+/**
+ * this function sums the ThreadStats of all the threads.
+ * @param total : will be set to the sum
+ * @return the number of threads
+ */
+int sumThreadStats(ThreadStats *total)
+{
+    memset(total, 0, sizeof(ThreadStats));
+    int numOfThreads = 0;
+    const ThreadStats *stats;
+    for (stats = __atomic_load_n(&allStats, __ATOMIC_ACQUIRE) ; stats != NULL ;
+         stats = stats->next)
+    {
+        int i, j;
+        for (i = 0 ; i < NUM_OF_COUNTERS ; ++i)
+        {
+            total->counters[i] += stats->counters[i];
+        }
+        for (i = 0 ; i < NUM_OF_TIMERS ; ++i)
+        {
+            Histogram *sum = &total->timers[i];
+            const Histogram *histogram = &stats->timers[i];
+            sum->count += histogram->count;
+            sum->sum += histogram->sum;
+            sum->max = (histogram->max > sum->max) ? histogram->max : sum->max;
+            for (j = 0 ; j < STAT_BUCKETS ; ++j)
+            {
+                sum->buckets[j] += histogram->buckets[j];
+            }
+        }
+        numOfThreads++;
+    }
+    return numOfThreads;
+}
+
+/**
+ * this function writes the report of the counters and the histograms of all the threads.
+ * @param out : the file to write to
+ * @param format : the format of the report
+ */
+void printStats(FILE *out, const StatsFormat format)
+{
+#ifdef EX2_STATS
+    ThreadStats total;
+    int numOfThreads = sumThreadStats(&total);
+    uint64_t nanos = statsNanos() - __atomic_load_n(&epochNanos, __ATOMIC_ACQUIRE);
+    uint64_t ticks = readTicks() - epochTicks;
+    double ticksPerNano = (numOfThreads > 0 && nanos > 0) ? (double) ticks / (double) nanos : 1;
+    int i, j;
+    if (format == STATS_JSON)
+    {
+        fprintf(out, "{\"threads\": %d, \"ticks_per_ns\": %.3f, \"counters\": {", numOfThreads,
+                ticksPerNano);
+        for (i = 0 ; i < NUM_OF_COUNTERS ; ++i)
+        {
+            fprintf(out, "%s\"%s\": %llu", (i == 0) ? "" : ", ", COUNTER_NAMES[i],
+                    (unsigned long long) total.counters[i]);
+        }
+        fprintf(out, "}, \"timers\": {");
+        for (i = 0 ; i < NUM_OF_TIMERS ; ++i)
+        {
+            const Histogram *histogram = &total.timers[i];
+            double mean = (histogram->count > 0) ? (double) histogram->sum / histogram->count : 0;
+            fprintf(out, "%s\"%s\": {\"count\": %llu, \"mean_ns\": %.1f, \"p50_ns\": %.1f, "
+                         "\"p99_ns\": %.1f, \"max_ns\": %.1f, \"buckets\": {",
+                    (i == 0) ? "" : ", ", TIMER_NAMES[i], (unsigned long long) histogram->count,
+                    mean / ticksPerNano,
+                    (double) histogramPercentile(histogram, 0.5) / ticksPerNano,
+                    (double) histogramPercentile(histogram, 0.99) / ticksPerNano,
+                    (double) histogram->max / ticksPerNano);
+            int isFirst = TRUE;
+            for (j = 0 ; j < STAT_BUCKETS ; ++j)
+            { // the key of a bucket is its smallest latency in ticks
+                if (histogram->buckets[j] > 0)
+                {
+                    fprintf(out, "%s\"%llu\": %llu", (isFirst == TRUE) ? "" : ", ",
+                            (j == 0) ? 0ull : 1ull << j,
+                            (unsigned long long) histogram->buckets[j]);
+                    isFirst = FALSE;
+                }
+            }
+            fprintf(out, "}}");
+        }
+        fprintf(out, "}}\n");
+        return;
+    }
+    fprintf(out, "stats of %d threads (%.3f ticks per ns)\n", numOfThreads, ticksPerNano);
+    for (i = 0 ; i < NUM_OF_COUNTERS ; ++i)
+    {
+        fprintf(out, "  %-16s %llu\n", COUNTER_NAMES[i], (unsigned long long) total.counters[i]);
+    }
+    for (i = 0 ; i < NUM_OF_TIMERS ; ++i)
+    {
+        const Histogram *histogram = &total.timers[i];
+        if (histogram->count == 0)
+        {
+            fprintf(out, "  %-16s no samples\n", TIMER_NAMES[i]);
+            continue;
+        }
+        fprintf(out, "  %-16s count %llu mean %.1f ns p50 %.1f ns p99 %.1f ns max %.1f ns\n",
+                TIMER_NAMES[i], (unsigned long long) histogram->count,
+                (double) histogram->sum / histogram->count / ticksPerNano,
+                (double) histogramPercentile(histogram, 0.5) / ticksPerNano,
+                (double) histogramPercentile(histogram, 0.99) / ticksPerNano,
+                (double) histogram->max / ticksPerNano);
+        for (j = 0 ; j < STAT_BUCKETS ; ++j)
+        {
+            if (histogram->buckets[j] > 0)
+            {
+                fprintf(out, "    >= %12llu ticks  %llu\n", (j == 0) ? 0ull : 1ull << j,
+                        (unsigned long long) histogram->buckets[j]);
+            }
+        }
+    }
+#else
+    (void) format;
+    fprintf(out, STATS_DISABLED_MSG);
+#endif
+}
+
+/**
+ * this function writes the report to the standard error, for atexit.
+ */
+void printExitStats(void)
+{
+    printStats(stderr, exitFormat);
+}
+
+/**
+ * this function sets the report to be written to the standard error when the program exits.
+ * @param format : the name of the format- "text" or "json"
+ * @return TRUE if the format is known, FALSE otherwise
+ */
+int reportStatsAtExit(const char *format)
+{
+    if (strcmp(format, "text") == 0)
+    {
+        exitFormat = STATS_TEXT;
+    }
+    else if (strcmp(format, "json") == 0)
+    {
+        exitFormat = STATS_JSON;
+    }
+    else
+    {
+        return FALSE;
+    }
+    atexit(printExitStats);
+    return TRUE;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file stats.h
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the hot path instrumentation- counters and latency histograms of the placement, the
+ * moves, the rendering and the parsing.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * the instrumentation is only built with EX2_STATS defined (cmake -DEX2_STATS=ON, or
+ * make STATS=-DEX2_STATS). without it STAT_ADD, STAT_TIMER_START and STAT_TIMER_STOP are empty,
+ * so the hot paths are exactly the same as before.
+ * every thread has its own ThreadStats (allocated on its first use and never freed), so updating
+ * a counter is a plain add with no atomics and no shared cache lines. a latency is measured in
+ * ticks of the time stamp counter and kept in a histogram with a bucket for every power of 2. the
+ * report sums the ThreadStats of all the threads and turns the ticks to nano seconds with the rate
+ * of the counter since the first ThreadStats was made.
+ */
+
+#ifndef EX2_STATS_H
+#define EX2_STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#ifdef EX2_STATS
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+#endif
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * @brief the counters.
+ */
+typedef enum StatCounter
+{
+    COUNTER_FLEETS, // the fleets that were placed (one per board)
+    COUNTER_FLEET_ATTEMPTS, // the passes of the placement over a whole fleet
+    COUNTER_DEAD_ENDS, // the ships that had no room left, so their fleet was placed again
+    COUNTER_CANDIDATES, // the legal placements that were found for the ships
+    COUNTER_RETRIES, // the random placements that hit another ship (on a sparse board)
+    COUNTER_PLACER_STEPS, // the placement checks of the backtracking search (see placer.h)
+    COUNTER_MOVES, // the moves that were placed on a board
+    COUNTER_RENDERS, // the boards that were rendered
+    COUNTER_PARSES, // the lines that were parsed as moves
+    NUM_OF_COUNTERS
+} StatCounter;
+
+/**
+ * @brief the latency histograms.
+ */
+typedef enum StatTimer
+{
+    TIMER_PLACEMENT, // placing a whole fleet
+    TIMER_MOVE, // placing a single move
+    TIMER_RENDER, // rendering a board
+    TIMER_PARSE, // parsing a move
+    NUM_OF_TIMERS
+} StatTimer;
+
+/**
+ * the number of buckets of a histogram- bucket i has the latencies from 2^i to 2^(i+1) - 1 ticks
+ * (bucket 0 has 0 and 1).
+ */
+#define STAT_BUCKETS 64
+
+/**
+ * @brief the formats of the report.
+ */
+typedef enum StatsFormat
+{
+    STATS_TEXT,
+    STATS_JSON
+} StatsFormat;
+
+/**
+ * @brief a latency histogram.
+ * @count the number of latencies
+ * @sum the sum of the latencies
+ * @max the largest latency
+ * @buckets the number of latencies in every bucket
+ */
+typedef struct Histogram
+{
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t buckets[STAT_BUCKETS];
+} Histogram;
+
+/**
+ * @brief the counters and the histograms of a single thread.
+ * @counters the counters
+ * @timers the histograms
+ * @next the ThreadStats of the thread that made its ThreadStats before this one
+ */
+typedef struct ThreadStats
+{
+    uint64_t counters[NUM_OF_COUNTERS];
+    Histogram timers[NUM_OF_TIMERS];
+    struct ThreadStats *next;
+} ThreadStats;
+
+
+// ------------------------------ function declarations -----------------------------
+
+/**
+ * this function gives the time of a monotonic clock.
+ * @return the time in nano seconds
+ */
+uint64_t statsNanos(void);
+
+/**
+ * this function makes the ThreadStats of the calling thread.
+ * @return the ThreadStats (the counters stay at zero if it is out of memory)
+ */
+ThreadStats *newThreadStats(void);
+
+/**
+ * this function adds a latency to a histogram.
+ * @param histogram : the histogram
+ * @param ticks : the latency
+ */
+void addLatency(Histogram *histogram, uint64_t ticks);
+
+/**
+ * this function gives an upper bound of a percentile of a histogram.
+ * @param histogram : the histogram
+ * @param fraction : the percentile (0 - 1)
+ * @return the largest latency of the bucket of the percentile (or the largest latency)
+ */
+uint64_t histogramPercentile(const Histogram *histogram, double fraction);
+
+/**
+ * this function writes the report of the counters and the histograms of all the threads.
+ * @param out : the file to write to
+ * @param format : the format of the report
+ */
+void printStats(FILE *out, StatsFormat format);
+
+/**
+ * this function sets the report to be written to the standard error when the program exits.
+ * @param format : the name of the format- "text" or "json"
+ * @return TRUE if the format is known, FALSE otherwise
+ */
+int reportStatsAtExit(const char *format);
+
+
+// ------------------------------ functions -----------------------------
+
+#ifdef EX2_STATS
+
+/**
+ * the ThreadStats of the thread, NULL before its first use.
+ */
+extern __thread ThreadStats *threadStats;
+
+/**
+ * this function gives the ThreadStats of the calling thread.
+ * @return the ThreadStats
+ */
+static inline ThreadStats *statsOfThread(void)
+{
+    return (threadStats != NULL) ? threadStats : newThreadStats();
+}
+
+/**
+ * this function reads the time stamp counter (or a nano seconds clock where there is none).
+ * @return the ticks
+ */
+static inline uint64_t readTicks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+#endif
+}
+
+/**
+ * STAT_ADD adds an amount to a counter of the thread.
+ * STAT_TIMER_START(name) starts a measurement in a new local variable name, and
+ * STAT_TIMER_STOP(timer, name) adds the time since then to the histogram timer of the thread.
+ */
+#define STAT_ADD(counter, amount) (statsOfThread()->counters[counter] += (uint64_t) (amount))
+#define STAT_TIMER_START(name) const uint64_t name = readTicks()
+#define STAT_TIMER_STOP(timer, name) \
+    addLatency(&statsOfThread()->timers[timer], readTicks() - (name))
+
+#else
+
+#define STAT_ADD(counter, amount) ((void) 0)
+#define STAT_TIMER_START(name)
+#define STAT_TIMER_STOP(timer, name) ((void) 0)
+
+#endif
+
+#endif //EX2_STATS_H
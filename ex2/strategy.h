@@ -0,0 +1,126 @@
+/**
+ * @file strategy.h
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the C ABI of a shot strategy- the plug-in interface of the tournament (ex2_tournament).
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * a strategy is a shared object that exports the function STRATEGY_ENTRY:
+ *     const StrategyPlugin *ex2Strategy(void);
+ * it gives the callbacks of the strategy and the STRATEGY_ABI_VERSION it was built with (the
+ * runner refuses any other version). this header needs nothing from the engine, so a strategy is
+ * built with it alone:
+ *     cc -shared -fPIC -o mine.so mine.c
+ * and the tournament loads it with dlopen: ex2_tournament --strategies ai,./mine.so
+ * every thread of the runner calls init once with the board and the fleet and keeps the state it
+ * returns for all the games of the thread. then for every game it calls chooseShot and
+ * observeResult in turn until the fleet is sunk, and release when the thread is done. a game
+ * starts when numOfMoves of the StrategyGame is 0. a state is only used by a single thread.
+ * the runner measures every call of chooseShot as the decision latency of the strategy.
+ * note that the values of this ABI are plain C (0 is false, STRATEGY_OK is 0).
+ */
+
+#ifndef EX2_STRATEGY_H
+#define EX2_STRATEGY_H
+
+#include <stdint.h>
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the version of the ABI. a change of StrategyGame or StrategyPlugin changes it.
+ */
+#define STRATEGY_ABI_VERSION 1
+
+/**
+ * the name of the function that a strategy exports.
+ */
+#define STRATEGY_ENTRY "ex2Strategy"
+
+/**
+ * the results of chooseShot.
+ */
+#define STRATEGY_OK 0
+#define STRATEGY_NO_SHOT 1
+
+/**
+ * @brief what a player knows about a cell of the board.
+ */
+typedef enum StrategyView
+{
+    VIEW_UNKNOWN, // not shot yet
+    VIEW_MISS, // shot and missed
+    VIEW_HIT, // a hit of a ship that is still floating
+    VIEW_SUNK // a cell of a ship that was sunk
+} StrategyView;
+
+/**
+ * @brief the results of a shot, for observeResult.
+ */
+typedef enum StrategyResult
+{
+    RESULT_MISS,
+    RESULT_HIT,
+    RESULT_SUNK, // a hit that sunk its ship (the fleet is not sunk yet)
+    RESULT_WIN // a hit that sunk the last ship
+} StrategyResult;
+
+/**
+ * @brief a game as a player sees it. the runner owns it, a strategy only reads it.
+ * @size the size of the board
+ * @numOfShips the number of ships in the fleet
+ * @shipLengths the lengths of the ships
+ * @shipSunk 1 for every ship that was sunk, 0 for a floating one
+ * @cells the StrategyView of every cell, row by row (size * size cells)
+ * @numOfMoves the number of shots so far
+ * @seed a seed for the random choices of the strategy in this game
+ * @engine the Game of the engine (battleships.h) for the strategies built into the runner, NULL
+ * for a plug-in
+ */
+typedef struct StrategyGame
+{
+    int size;
+    int numOfShips;
+    const unsigned char *shipLengths;
+    const unsigned char *shipSunk;
+    const unsigned char *cells;
+    int numOfMoves;
+    uint64_t seed;
+    const void *engine;
+} StrategyGame;
+
+/**
+ * @brief the callbacks of a strategy.
+ * @abiVersion STRATEGY_ABI_VERSION
+ * @name the name of the strategy in the report
+ * @init makes the state of a thread for the board size and the fleet of the tournament (the game
+ * has no shots yet). returns the state, NULL if it failed (a strategy with no state returns any
+ * pointer that is not NULL)
+ * @chooseShot sets the row and the column of the next shot. returns STRATEGY_OK, or
+ * STRATEGY_NO_SHOT if it has no shot (the game is stopped and counted as not won)
+ * @observeResult gets the result of the last shot, after the game was updated with it (may be
+ * NULL)
+ * @release frees the state (may be NULL)
+ */
+typedef struct StrategyPlugin
+{
+    uint32_t abiVersion;
+    const char *name;
+    void *(*init)(const StrategyGame *game);
+    int (*chooseShot)(void *state, const StrategyGame *game, int *row, int *column);
+    void (*observeResult)(void *state, const StrategyGame *game, int row, int column,
+                          StrategyResult result);
+    void (*release)(void *state);
+} StrategyPlugin;
+
+/**
+ * @brief the type of the function that a strategy exports.
+ */
+typedef const StrategyPlugin *(*StrategyEntry)(void);
+
+#endif //EX2_STRATEGY_H
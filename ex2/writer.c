@@ -0,0 +1,634 @@
+// ------------------------------ includes ------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "writer.h"
+#include "stats.h"
+
+/**
+ * @file writer.c
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief this is the implementation file for the group commit writer.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * this is the implementation file for the queues of the sessions and the writer thread.
+ * Input  : the records of the sessions
+ * Process: implementation for the functions in writer.h
+ * Output : the log and the files
+ */
+
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the suffix of the temporary path of a file until its group is committed.
+ */
+const char WRITER_TEMP_SUFFIX[] = ".tmp";
+
+/**
+ * @var string massage
+ * @brief error massage for the case that the writer can't write to the disk
+ */
+const char *WRITER_ERROR_MSG = "the writer failed";
+
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * this function copies bytes into the ring of a queue, from a position that may wrap around.
+ * @param queue : the queue
+ * @param position : the position (the number of bytes pushed before them)
+ * @param data : the bytes
+ * @param length : the number of bytes
+ */
+void copyToRing(WriterQueue *queue, const uint32_t position, const void *data, const int length)
+{
+    uint32_t offset = position & (WRITER_QUEUE_BYTES - 1);
+    uint32_t first = WRITER_QUEUE_BYTES - offset;
+    if (first >= (uint32_t) length)
+    {
+        memcpy(queue->ring + offset, data, (size_t) length);
+        return;
+    }
+    memcpy(queue->ring + offset, data, first);
+    memcpy(queue->ring, (const unsigned char *) data + first, (size_t) length - first);
+}
+
+/**
+ * this function copies bytes out of the ring of a queue, from a position that may wrap around.
+ * @param queue : the queue
+ * @param position : the position
+ * @param data : the buffer for the bytes
+ * @param length : the number of bytes
+ */
+void copyFromRing(const WriterQueue *queue, const uint32_t position, void *data, const int length)
+{
+    uint32_t offset = position & (WRITER_QUEUE_BYTES - 1);
+    uint32_t first = WRITER_QUEUE_BYTES - offset;
+    if (first >= (uint32_t) length)
+    {
+        memcpy(data, queue->ring + offset, (size_t) length);
+        return;
+    }
+    memcpy(data, queue->ring + offset, first);
+    memcpy((unsigned char *) data + first, queue->ring, (size_t) length - first);
+}
+
+/**
+ * this function pushes a record to a queue. it never blocks.
+ * @param writer : the writer of the queue
+ * @param queue : the queue
+ * @param type : the type of the record
+ * @param data : the payload
+ * @param length : the length of the payload
+ * @return TRUE on success, FALSE if the queue is full (the record is dropped and counted)
+ */
+int pushRecord(GroupWriter *writer, WriterQueue *queue, const WriterRecord type, const void *data,
+               const int length)
+{
+    uint32_t head = queue->head; // only this thread changes it
+    uint32_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    if (WRITER_QUEUE_BYTES - (head - tail) < (uint32_t) (WRITER_RECORD_HEAD + length))
+    {
+        __atomic_fetch_add(&writer->stats.dropped, 1, __ATOMIC_RELAXED);
+        return FALSE;
+    }
+    unsigned char recordHead[WRITER_RECORD_HEAD] = {(unsigned char) type,
+                                                    (unsigned char) (length & 0xFF),
+                                                    (unsigned char) (length >> 8)};
+    copyToRing(queue, head, recordHead, WRITER_RECORD_HEAD);
+    copyToRing(queue, head + WRITER_RECORD_HEAD, data, length);
+    __atomic_store_n(&queue->head, head + WRITER_RECORD_HEAD + (uint32_t) length,
+                     __ATOMIC_RELEASE);
+    return TRUE;
+}
+
+/**
+ * this function gives a new queue of the writer to a session.
+ * @param writer : the writer
+ * @return the queue, NULL if out of memory (close it with closeWriterQueue, never free it)
+ */
+WriterQueue *openWriterQueue(GroupWriter *writer)
+{
+    WriterQueue *queue = (WriterQueue *) malloc(sizeof(WriterQueue));
+    if (queue == NULL)
+    {
+        return NULL;
+    }
+    queue->head = 0;
+    queue->tail = 0;
+    queue->isClosed = FALSE;
+    queue->stream = 0;
+    queue->next = __atomic_load_n(&writer->queues, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&writer->queues, &queue->next, queue, 1,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    { // another session pushed its queue first, queue->next is the new head
+    }
+    return queue;
+}
+
+/**
+ * this function closes a queue. the records that are still in it are written.
+ * @param queue : the queue
+ */
+void closeWriterQueue(WriterQueue *queue)
+{
+    __atomic_store_n(&queue->isClosed, TRUE, __ATOMIC_RELEASE);
+}
+
+/**
+ * this function starts a new stream on a queue, the next log records go to it.
+ * @param writer : the writer
+ * @param queue : the queue
+ * @param stream : will be set to the id of the stream
+ * @return TRUE on success, FALSE if the queue is full
+ */
+int pushWriterStream(GroupWriter *writer, WriterQueue *queue, uint32_t *stream)
+{
+    *stream = __atomic_add_fetch(&writer->nextStream, 1, __ATOMIC_RELAXED);
+    return pushRecord(writer, queue, WRITER_STREAM, stream, sizeof(uint32_t));
+}
+
+/**
+ * this function pushes bytes of the current stream to a queue.
+ * @param writer : the writer
+ * @param queue : the queue
+ * @param data : the bytes
+ * @param length : the number of bytes (up to WRITER_QUEUE_BYTES / 4)
+ * @return TRUE on success, FALSE if the queue is full (the bytes are dropped)
+ */
+int pushWriterLog(GroupWriter *writer, WriterQueue *queue, const void *data, const int length)
+{
+    return pushRecord(writer, queue, WRITER_LOG, data, length);
+}
+
+/**
+ * this function allocates a file for the writer.
+ * @param path : the path of the file
+ * @param length : the length of its data
+ * @return the file (fill its data), NULL if out of memory
+ */
+WriterFile *newWriterFile(const char *path, const size_t length)
+{
+    size_t pathBytes = (strlen(path) + 1 + 7) & ~(size_t) 7;
+    WriterFile *file = (WriterFile *) malloc(sizeof(WriterFile) + pathBytes + length);
+    if (file == NULL)
+    {
+        return NULL;
+    }
+    file->path = (char *) (file + 1);
+    strcpy(file->path, path);
+    file->data = (unsigned char *) file->path + pathBytes;
+    file->length = length;
+    return file;
+}
+
+/**
+ * this function pushes a file to a queue. the writer frees it once it is written.
+ * @param writer : the writer
+ * @param queue : the queue
+ * @param file : the file
+ * @return TRUE on success, FALSE if the queue is full (the file is still the caller's)
+ */
+int pushWriterFile(GroupWriter *writer, WriterQueue *queue, WriterFile *file)
+{
+    return pushRecord(writer, queue, WRITER_FILE, &file, sizeof(WriterFile *));
+}
+
+/**
+ * this function pushes a task to a queue. the writer runs it after it committed the files that
+ * were pushed before it (to any queue).
+ * @param writer : the writer
+ * @param queue : the queue
+ * @param task : the task
+ * @return TRUE on success, FALSE if the queue is full (the task will not run)
+ */
+int pushWriterTask(GroupWriter *writer, WriterQueue *queue, WriterTask *task)
+{
+    return pushRecord(writer, queue, WRITER_TASK, &task, sizeof(WriterTask *));
+}
+
+/**
+ * this function writes all the bytes of a buffer to a file, after any short writes.
+ * @param fd : the file
+ * @param data : the buffer
+ * @param length : the number of bytes
+ * @return TRUE if all of them were written, FALSE on a failure (errno tells why)
+ */
+int writeFully(const int fd, const void *data, const size_t length)
+{
+    size_t done = 0;
+    while (done < length)
+    {
+        ssize_t written = write(fd, (const char *) data + done, length - done);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            return FALSE;
+        }
+        done += (size_t) written;
+    }
+    return TRUE;
+}
+
+/**
+ * this function writes the buffer of the writer to the log.
+ * @param writer : the writer
+ */
+void writeBatch(GroupWriter *writer)
+{
+    if (writeFully(writer->logFd, writer->batch, writer->batchLength) == FALSE)
+    {
+        perror(WRITER_ERROR_MSG);
+    }
+    writer->batchLength = 0;
+}
+
+/**
+ * this function makes room in the buffer of the writer.
+ * @param writer : the writer
+ * @param length : the number of bytes that need room
+ */
+void reserveBatch(GroupWriter *writer, const size_t length)
+{
+    if (writer->batchLength + length > WRITER_BATCH_BYTES)
+    {
+        writeBatch(writer);
+    }
+}
+
+/**
+ * this function marks that the writer took bytes for the current group.
+ * @param writer : the writer
+ * @param length : the number of bytes
+ */
+void addToGroup(GroupWriter *writer, const size_t length)
+{
+    if (writer->pendingBytes == 0 && writer->numOfFiles == 0)
+    {
+        writer->groupStart = statsNanos() / 1000;
+    }
+    writer->pendingBytes += length;
+}
+
+/**
+ * this function commits the current group- writes the rest of the log, syncs the log and the new
+ * files, and renames the files to their paths.
+ * @param writer : the writer
+ */
+void commitGroup(GroupWriter *writer)
+{
+    if (writer->pendingBytes == 0 && writer->numOfFiles == 0)
+    {
+        return;
+    }
+    if (writer->logFd >= 0)
+    {
+        writeBatch(writer);
+        if (fdatasync(writer->logFd) != 0)
+        {
+            perror(WRITER_ERROR_MSG);
+        }
+    }
+    char tempPath[PATH_MAX];
+    int i;
+    for (i = 0 ; i < writer->numOfFiles ; ++i)
+    {
+        WriterFile *file = writer->files[i];
+        snprintf(tempPath, sizeof(tempPath), "%s%s", file->path, WRITER_TEMP_SUFFIX);
+        int fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0 || writeFully(fd, file->data, file->length) == FALSE ||
+            fdatasync(fd) != 0 || close(fd) != 0 || rename(tempPath, file->path) != 0)
+        {
+            perror(WRITER_ERROR_MSG);
+            unlink(tempPath);
+            __atomic_store_n(&writer->stats.failedFiles, writer->stats.failedFiles + 1,
+                             __ATOMIC_RELAXED);
+        }
+        free(file);
+    }
+    uint64_t latency = statsNanos() / 1000 - writer->groupStart;
+    WriterStats *stats = &writer->stats;
+    __atomic_store_n(&stats->commits, stats->commits + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats->bytes, stats->bytes + writer->pendingBytes, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats->lastCommitMicros, latency, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats->totalCommitMicros, stats->totalCommitMicros + latency,
+                     __ATOMIC_RELAXED);
+    if (latency > stats->maxCommitMicros)
+    {
+        __atomic_store_n(&stats->maxCommitMicros, latency, __ATOMIC_RELAXED);
+    }
+    writer->numOfFiles = 0;
+    writer->pendingBytes = 0;
+}
+
+/**
+ * this function commits the current group and then runs the tasks that wait for it.
+ * @param writer : the writer
+ */
+void runTasks(GroupWriter *writer)
+{
+    commitGroup(writer);
+    int i;
+    for (i = 0 ; i < writer->numOfTasks ; ++i)
+    {
+        writer->tasks[i]->run(writer->tasks[i]);
+    }
+    writer->numOfTasks = 0;
+}
+
+/**
+ * this function takes the records of a queue- all of them, unless the tasks of the pass are
+ * full. the log records of a stream that follow each other go to a single frame.
+ * @param writer : the writer
+ * @param queue : the queue
+ * @return the number of bytes that were taken
+ */
+size_t drainQueue(GroupWriter *writer, WriterQueue *queue)
+{
+    uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    uint32_t tail = queue->tail; // only this thread changes it
+    uint32_t start = tail;
+    WriterFrame *frame = NULL;
+    while (tail != head)
+    {
+        unsigned char recordHead[WRITER_RECORD_HEAD];
+        copyFromRing(queue, tail, recordHead, WRITER_RECORD_HEAD);
+        int length = recordHead[1] | (recordHead[2] << 8);
+        uint32_t payload = tail + WRITER_RECORD_HEAD;
+        if (recordHead[0] == WRITER_STREAM)
+        {
+            copyFromRing(queue, payload, &queue->stream, sizeof(uint32_t));
+            frame = NULL;
+        }
+        else if (recordHead[0] == WRITER_FILE)
+        {
+            WriterFile *file;
+            copyFromRing(queue, payload, &file, sizeof(WriterFile *));
+            if (writer->numOfFiles == WRITER_MAX_GROUP_FILES)
+            {
+                commitGroup(writer);
+                frame = NULL; // the batch was written, the next log record needs a new frame
+            }
+            addToGroup(writer, file->length);
+            writer->files[writer->numOfFiles++] = file;
+        }
+        else if (recordHead[0] == WRITER_TASK)
+        {
+            if (writer->numOfTasks == WRITER_MAX_TASKS)
+            { // it is taken on a later pass, once the tasks before it ran
+                break;
+            }
+            copyFromRing(queue, payload, &writer->tasks[writer->numOfTasks++],
+                         sizeof(WriterTask *));
+        }
+        else if (writer->logFd >= 0 && queue->stream != 0)
+        {
+            if (frame == NULL || writer->batchLength + (size_t) length > WRITER_BATCH_BYTES)
+            { // a new frame, after the batch is written if there is no room
+                reserveBatch(writer, sizeof(WriterFrame) + (size_t) length);
+                frame = (WriterFrame *) (writer->batch + writer->batchLength);
+                frame->stream = queue->stream;
+                frame->length = 0;
+                writer->batchLength += sizeof(WriterFrame);
+                addToGroup(writer, sizeof(WriterFrame));
+            }
+            copyFromRing(queue, payload, writer->batch + writer->batchLength, length);
+            writer->batchLength += (size_t) length;
+            frame->length += (uint32_t) length;
+            addToGroup(writer, (size_t) length);
+        }
+        tail = payload + (uint32_t) length;
+    }
+    __atomic_store_n(&queue->tail, tail, __ATOMIC_RELEASE);
+    return tail - start;
+}
+
+/**
+ * this function takes the records of all the queues once, and frees the closed queues that are
+ * empty now.
+ * @param writer : the writer
+ * @return the number of bytes that were taken
+ */
+size_t drainQueues(GroupWriter *writer)
+{
+    size_t taken = 0;
+    WriterQueue **link = &writer->queues;
+    WriterQueue *queue = __atomic_load_n(link, __ATOMIC_ACQUIRE);
+    while (queue != NULL)
+    {
+        int isClosed = __atomic_load_n(&queue->isClosed, __ATOMIC_ACQUIRE);
+        taken += drainQueue(writer, queue);
+        WriterQueue *next = queue->next;
+        if (isClosed == TRUE && queue->tail == __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE))
+        { // nothing is pushed to a closed queue, so it stays empty
+            if (link == &writer->queues)
+            { // the head, new queues may be pushed before it
+                WriterQueue *expected = queue;
+                if (!__atomic_compare_exchange_n(link, &expected, next, 0, __ATOMIC_ACQ_REL,
+                                                 __ATOMIC_ACQUIRE))
+                { // new queues were pushed, it is deeper in the list now
+                    link = &expected->next;
+                    while (*link != queue)
+                    {
+                        link = &(*link)->next;
+                    }
+                    *link = next;
+                }
+            }
+            else
+            {
+                *link = next;
+            }
+            free(queue);
+        }
+        else
+        {
+            link = &queue->next;
+        }
+        queue = next;
+    }
+    return taken;
+}
+
+/**
+ * the loop of the writer thread.
+ * @param arg : the writer
+ * @return NULL
+ */
+void *runWriter(void *arg)
+{
+    GroupWriter *writer = (GroupWriter *) arg;
+    int isRunning = TRUE;
+    while (isRunning == TRUE || writer->queues != NULL)
+    {
+        isRunning = __atomic_load_n(&writer->isRunning, __ATOMIC_ACQUIRE);
+        size_t taken = drainQueues(writer);
+        while (writer->numOfTasks > 0)
+        { // a record that was pushed before a task (on any queue) is taken by the pass after it
+            int numOfTasks = writer->numOfTasks;
+            taken += drainQueues(writer);
+            if (writer->numOfTasks == numOfTasks)
+            {
+                runTasks(writer);
+            }
+        }
+        __atomic_store_n(&writer->stats.queueDepth, (uint64_t) taken, __ATOMIC_RELAXED);
+        if (taken > writer->stats.maxQueueDepth)
+        {
+            __atomic_store_n(&writer->stats.maxQueueDepth, (uint64_t) taken, __ATOMIC_RELAXED);
+        }
+        int hasGroup = (writer->pendingBytes > 0 || writer->numOfFiles > 0) ? TRUE : FALSE;
+        if (hasGroup == TRUE &&
+            (isRunning == FALSE || writer->pendingBytes >= writer->commitBytes ||
+             statsNanos() / 1000 - writer->groupStart >= writer->commitMicros))
+        {
+            commitGroup(writer);
+        }
+        else if (taken == 0)
+        {
+            usleep(WRITER_IDLE_MICROS);
+        }
+        if (isRunning == FALSE && writer->queues != NULL)
+        { // the sessions that are left will never close their queues
+            break;
+        }
+    }
+    runTasks(writer);
+    return NULL;
+}
+
+/**
+ * this function prepares the log of the writer. an empty log gets a WriterLogHeader. a log of an
+ * earlier run is checked, cut after its last whole frame (the rest is a frame of a crash), and
+ * the ids of the new streams start after the largest id in it- so the streams of different runs
+ * never share an id.
+ * @param writer : the writer, with its log
+ * @return TRUE on success, FALSE if the log can't be read or written or is not a valid log
+ */
+int openWriterLog(GroupWriter *writer)
+{
+    off_t size = lseek(writer->logFd, 0, SEEK_END);
+    if (size < 0)
+    {
+        return FALSE;
+    }
+    if (size == 0)
+    {
+        WriterLogHeader header = {WRITER_LOG_MAGIC, WRITER_LOG_VERSION};
+        return writeFully(writer->logFd, &header, sizeof(header));
+    }
+    size_t length = (size_t) size, position = sizeof(WriterLogHeader);
+    const unsigned char *data = mmap(NULL, length, PROT_READ, MAP_SHARED, writer->logFd, 0);
+    if (data == MAP_FAILED)
+    {
+        return FALSE;
+    }
+    WriterLogHeader header;
+    int logFlag = FALSE;
+    if (length >= sizeof(WriterLogHeader))
+    {
+        memcpy(&header, data, sizeof(WriterLogHeader));
+        logFlag = (header.magic == WRITER_LOG_MAGIC && header.version == WRITER_LOG_VERSION) ?
+                  TRUE : FALSE;
+    }
+    while (logFlag == TRUE && position + sizeof(WriterFrame) <= length)
+    {
+        WriterFrame frame;
+        memcpy(&frame, data + position, sizeof(WriterFrame));
+        if (frame.length > length - position - sizeof(WriterFrame))
+        {
+            break;
+        }
+        if (frame.stream > writer->nextStream)
+        {
+            writer->nextStream = frame.stream;
+        }
+        position += sizeof(WriterFrame) + frame.length;
+    }
+    munmap((void *) data, length);
+    if (logFlag == TRUE && position < length && ftruncate(writer->logFd, (off_t) position) != 0)
+    {
+        return FALSE;
+    }
+    if (logFlag == FALSE)
+    {
+        errno = EINVAL;
+    }
+    return logFlag;
+}
+
+/**
+ * this function starts the writer thread.
+ * @param writer : the writer
+ * @param logFd : the log, open for reading and appending (see openWriterLog), -1 for no log
+ * @param commitMicros : the commit time
+ * @param commitBytes : the commit size
+ * @return TRUE on success, FALSE if the thread can't start or the log can't be used
+ */
+int startWriter(GroupWriter *writer, const int logFd, const uint64_t commitMicros,
+                const uint64_t commitBytes)
+{
+    memset(&writer->stats, 0, sizeof(WriterStats));
+    writer->logFd = logFd;
+    writer->commitMicros = commitMicros;
+    writer->commitBytes = commitBytes;
+    writer->isRunning = TRUE;
+    writer->queues = NULL;
+    writer->nextStream = 0;
+    writer->batchLength = 0;
+    writer->numOfFiles = 0;
+    writer->numOfTasks = 0;
+    writer->pendingBytes = 0;
+    writer->groupStart = 0;
+    if (logFd >= 0 && openWriterLog(writer) == FALSE)
+    {
+        return FALSE;
+    }
+    return (pthread_create(&writer->thread, NULL, runWriter, writer) == 0) ? TRUE : FALSE;
+}
+
+/**
+ * this function stops the writer thread, after it wrote and committed everything in the queues
+ * and ran their tasks.
+ * @param writer : the writer
+ */
+void stopWriter(GroupWriter *writer)
+{
+    __atomic_store_n(&writer->isRunning, FALSE, __ATOMIC_RELEASE);
+    pthread_join(writer->thread, NULL);
+}
+
+/**
+ * this function reads the counters of the writer.
+ * @param writer : the writer
+ * @param stats : will be set to the counters
+ */
+void readWriterStats(GroupWriter *writer, WriterStats *stats)
+{
+    const WriterStats *source = &writer->stats;
+    stats->commits = __atomic_load_n(&source->commits, __ATOMIC_RELAXED);
+    stats->bytes = __atomic_load_n(&source->bytes, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&source->dropped, __ATOMIC_RELAXED);
+    stats->queueDepth = __atomic_load_n(&source->queueDepth, __ATOMIC_RELAXED);
+    stats->maxQueueDepth = __atomic_load_n(&source->maxQueueDepth, __ATOMIC_RELAXED);
+    stats->lastCommitMicros = __atomic_load_n(&source->lastCommitMicros, __ATOMIC_RELAXED);
+    stats->maxCommitMicros = __atomic_load_n(&source->maxCommitMicros, __ATOMIC_RELAXED);
+    stats->totalCommitMicros = __atomic_load_n(&source->totalCommitMicros, __ATOMIC_RELAXED);
+    stats->failedFiles = __atomic_load_n(&source->failedFiles, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,302 @@
+/**
+ * @file writer.h
+ * @author  Zohar Bouchnik <zohar.bouchnik@mail.huji.ac.il>
+ * @version 1.0
+ * @date 17 october 2026
+ *
+ * @brief the group commit writer- a background thread that writes the journals and the snapshots
+ * of many sessions, and reads the snapshots for them, so the threads that run the games never
+ * wait for the disk.
+ *
+ * @section LICENSE
+ * none
+ *
+ * @section DESCRIPTION
+ * every session has its own WriterQueue, a ring of records with a single producer (the thread of
+ * the session) and a single consumer (the writer). a push never blocks- a full queue drops the
+ * record and counts it. a record is a byte (its type), two bytes (its length) and its payload:
+ *   WRITER_STREAM - the id of a new stream of the session (a new journal)
+ *   WRITER_LOG    - bytes of the current stream of the session
+ *   WRITER_FILE   - a pointer to a WriterFile, a whole file to write (a snapshot)
+ *   WRITER_TASK   - a pointer to a WriterTask, work on the disk that must see the files that were
+ *                   pushed before it (reading a snapshot)
+ * the writer takes the records of all the queues into one big buffer and appends it to the log
+ * with large sequential writes. a log is a WriterLogHeader and then frames- a WriterFrame (the id
+ * of the stream and the length) and the bytes of that stream. so the bytes of one stream are the
+ * journal of its game, in the frames with its id. a file is written to a temporary path next to
+ * its path. once the bytes that were taken pass the commit size, or the oldest of them passes the
+ * commit time, the writer commits the group- one fdatasync of the log and of the new files, and
+ * then the files are renamed to their paths. a task waits for the end of the pass that took it-
+ * then the writer takes the queues once more (a record that was pushed before the task, on any
+ * queue, is taken by then), commits the group and runs the task. the writer keeps the depth of
+ * the queues, the latency of the commits and the files it failed to write in its WriterStats.
+ */
+
+#ifndef EX2_WRITER_H
+#define EX2_WRITER_H
+
+#include <stddef.h>
+#include <pthread.h>
+#include "battleships.h"
+
+// -------------------------- const definitions -------------------------
+
+/**
+ * the first bytes of a log ("BSGL" in the file) and the version of the layout.
+ */
+#define WRITER_LOG_MAGIC 0x4C475342u
+#define WRITER_LOG_VERSION 1
+
+/**
+ * the size of the ring of a queue (a power of 2), and the head of a record in it.
+ */
+#define WRITER_QUEUE_BYTES 1024
+#define WRITER_RECORD_HEAD 3
+
+/**
+ * the size of the buffer of the writer, the limit of the files of one group and of the tasks of
+ * one pass, and the time the writer sleeps when there is nothing to write.
+ */
+#define WRITER_BATCH_BYTES (1 << 20)
+#define WRITER_MAX_GROUP_FILES 256
+#define WRITER_MAX_TASKS 256
+#define WRITER_IDLE_MICROS 200
+
+/**
+ * the default commit thresholds.
+ */
+#define WRITER_DEFAULT_COMMIT_MICROS 5000
+#define WRITER_DEFAULT_COMMIT_BYTES (256 * 1024)
+
+/**
+ * @brief the types of the records.
+ */
+typedef enum WriterRecord
+{
+    WRITER_STREAM,
+    WRITER_LOG,
+    WRITER_FILE,
+    WRITER_TASK
+} WriterRecord;
+
+/**
+ * @brief the head of a log.
+ * @magic WRITER_LOG_MAGIC
+ * @version WRITER_LOG_VERSION
+ */
+typedef struct WriterLogHeader
+{
+    uint32_t magic;
+    uint32_t version;
+} WriterLogHeader;
+
+/**
+ * @brief the head of a frame of a log, its bytes come right after it.
+ * @stream the id of the stream (from 1)
+ * @length the number of bytes
+ */
+typedef struct WriterFrame
+{
+    uint32_t stream;
+    uint32_t length;
+} WriterFrame;
+
+/**
+ * @brief a whole file for the writer. it is a single block with the path and the data, and the
+ * writer frees it once it is written.
+ * @path the path of the file
+ * @data the data of the file (8 bytes aligned)
+ * @length the length of the data
+ */
+typedef struct WriterFile
+{
+    char *path;
+    unsigned char *data;
+    size_t length;
+} WriterFile;
+
+/**
+ * @brief work for the writer thread. it is embedded in the struct of its owner, and run stays the
+ * owner's (the writer never frees it).
+ * @run called on the writer thread, once the files before the task are committed. it must not
+ * wait for the threads that push records
+ */
+typedef struct WriterTask
+{
+    void (*run)(struct WriterTask *task);
+} WriterTask;
+
+/**
+ * @brief the queue of a session.
+ * @head the number of bytes that were pushed (only the producer changes it)
+ * @tail the number of bytes that were taken (only the writer changes it)
+ * @isClosed TRUE once the session is done with the queue. the writer frees it when it is empty
+ * @stream the current stream of the queue (only the writer uses it)
+ * @next the next queue of the writer
+ * @ring the records
+ */
+typedef struct WriterQueue
+{
+    uint32_t head;
+    uint32_t tail;
+    int isClosed;
+    uint32_t stream;
+    struct WriterQueue *next;
+    unsigned char ring[WRITER_QUEUE_BYTES];
+} WriterQueue;
+
+/**
+ * @brief the counters of the writer. the writer changes them and anyone can read them with
+ * readWriterStats.
+ * @commits the number of group commits
+ * @bytes the number of bytes that were committed
+ * @dropped the number of records that were dropped since their queue was full
+ * @queueDepth the number of bytes that were waiting in all the queues on the last pass
+ * @maxQueueDepth the largest queueDepth
+ * @lastCommitMicros the latency of the last commit- from taking its first record to the end of
+ * its sync
+ * @maxCommitMicros the largest latency of a commit
+ * @totalCommitMicros the sum of the latencies of the commits
+ * @failedFiles the number of files that could not be written (their paths keep what they had)
+ */
+typedef struct WriterStats
+{
+    uint64_t commits;
+    uint64_t bytes;
+    uint64_t dropped;
+    uint64_t queueDepth;
+    uint64_t maxQueueDepth;
+    uint64_t lastCommitMicros;
+    uint64_t maxCommitMicros;
+    uint64_t totalCommitMicros;
+    uint64_t failedFiles;
+} WriterStats;
+
+/**
+ * @brief the writer.
+ * @thread the writer thread
+ * @logFd the log, -1 for no log
+ * @commitMicros the commit time
+ * @commitBytes the commit size
+ * @isRunning TRUE until stopWriter
+ * @queues the queues (new queues are pushed to the head with a compare and swap)
+ * @nextStream the id of the next stream
+ * @stats the counters
+ * @batch the bytes of the log that were not written yet
+ * @batchLength the number of bytes in batch
+ * @files the files of the current group
+ * @numOfFiles the number of files in the current group
+ * @tasks the tasks that were taken in the current pass
+ * @numOfTasks the number of tasks
+ * @pendingBytes the number of bytes of the current group
+ * @groupStart the time the first record of the current group was taken (in micro seconds)
+ */
+typedef struct GroupWriter
+{
+    pthread_t thread;
+    int logFd;
+    uint64_t commitMicros;
+    uint64_t commitBytes;
+    int isRunning;
+    WriterQueue *queues;
+    uint32_t nextStream;
+    WriterStats stats;
+    unsigned char batch[WRITER_BATCH_BYTES];
+    size_t batchLength;
+    WriterFile *files[WRITER_MAX_GROUP_FILES];
+    int numOfFiles;
+    WriterTask *tasks[WRITER_MAX_TASKS];
+    int numOfTasks;
+    uint64_t pendingBytes;
+    uint64_t groupStart;
+} GroupWriter;
+
+
+// ------------------------------ function declarations -----------------------------
+
+/**
+ * this function starts the writer thread.
+ * @param writer : the writer
+ * @param logFd : the log, open for reading and appending, -1 for no log. an empty log gets a
+ * WriterLogHeader, the log of an earlier run is cut after its last whole frame and its new
+ * streams get ids after the ones already in it
+ * @param commitMicros : the commit time
+ * @param commitBytes : the commit size
+ * @return TRUE on success, FALSE if the thread can't start or the log can't be used
+ */
+int startWriter(GroupWriter *writer, int logFd, uint64_t commitMicros, uint64_t commitBytes);
+
+/**
+ * this function stops the writer thread, after it wrote and committed everything in the queues
+ * and ran their tasks.
+ * @param writer : the writer
+ */
+void stopWriter(GroupWriter *writer);
+
+/**
+ * this function gives a new queue of the writer to a session.
+ * @param writer : the writer
+ * @return the queue, NULL if out of memory (close it with closeWriterQueue, never free it)
+ */
+WriterQueue *openWriterQueue(GroupWriter *writer);
+
+/**
+ * this function closes a queue. the records that are still in it are written.
+ * @param queue : the queue
+ */
+void closeWriterQueue(WriterQueue *queue);
+
+/**
+ * this function starts a new stream on a queue, the next log records go to it.
+ * @param writer : the writer
+ * @param queue : the queue
+ * @param stream : will be set to the id of the stream
+ * @return TRUE on success, FALSE if the queue is full
+ */
+int pushWriterStream(GroupWriter *writer, WriterQueue *queue, uint32_t *stream);
+
+/**
+ * this function pushes bytes of the current stream to a queue.
+ * @param writer : the writer
+ * @param queue : the queue
+ * @param data : the bytes
+ * @param length : the number of bytes (up to WRITER_QUEUE_BYTES / 4)
+ * @return TRUE on success, FALSE if the queue is full (the bytes are dropped)
+ */
+int pushWriterLog(GroupWriter *writer, WriterQueue *queue, const void *data, int length);
+
+/**
+ * this function allocates a file for the writer.
+ * @param path : the path of the file
+ * @param length : the length of its data
+ * @return the file (fill its data), NULL if out of memory
+ */
+WriterFile *newWriterFile(const char *path, size_t length);
+
+/**
+ * this function pushes a file to a queue. the writer frees it once it is written.
+ * @param writer : the writer
+ * @param queue : the queue
+ * @param file : the file
+ * @return TRUE on success, FALSE if the queue is full (the file is still the caller's)
+ */
+int pushWriterFile(GroupWriter *writer, WriterQueue *queue, WriterFile *file);
+
+/**
+ * this function pushes a task to a queue. the writer runs it after it committed the files that
+ * were pushed before it (to any queue).
+ * @param writer : the writer
+ * @param queue : the queue
+ * @param task : the task
+ * @return TRUE on success, FALSE if the queue is full (the task will not run)
+ */
+int pushWriterTask(GroupWriter *writer, WriterQueue *queue, WriterTask *task);
+
+/**
+ * this function reads the counters of the writer.
+ * @param writer : the writer
+ * @param stats : will be set to the counters
+ */
+void readWriterStats(GroupWriter *writer, WriterStats *stats);
+
+#endif //EX2_WRITER_H